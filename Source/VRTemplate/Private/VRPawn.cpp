@@ -9,17 +9,76 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "Components/SplineMeshComponent.h"
+#include "Components/LineBatchComponent.h"
 #include "Components/Image.h"
 #include "InputActionValue.h"
 #include "Components/AudioComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "HeadMountedDisplayFunctionLibrary.h"
+#include "WireTickProfiler.h"
+#include "WireAnchorSubsystem.h"
+#include "WireAsyncPhysics.h"
+#include "WireBatchComponent.h"
+#include "WireRenderSubsystem.h"
+#include "WireStats.h"
+#include "Net/UnrealNetwork.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PBDRigidsSolver.h"
+
+namespace
+{
+    // 自分の VRPawn を取得
+    AVRPawn* GetLocalVRPawn(UWorld* World)
+    {
+        APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+        return PlayerController ? Cast<AVRPawn>(PlayerController->GetPawn()) : nullptr;
+    }
+
+    // 実機でのプレイを記録して UWireBenchmarkCommandlet の -Replay で再生する
+    FAutoConsoleCommandWithWorldAndArgs GWireRecordInputCommand(
+        TEXT("Wire.RecordInput"),
+        TEXT("Wire.RecordInput <Name> : 自分の VRPawn の入力を Saved/InputRecordings/<Name>.winput に記録する"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (AVRPawn* Pawn = GetLocalVRPawn(World))
+                Pawn->StartInputRecording(Args.Num() > 0 ? Args[0] : TEXT("Session"));
+        }));
+
+    // 更新頻度 (Hz) から Tick の間隔へ（0 なら毎フレーム）
+    float RateToTickInterval(float Rate)
+    {
+        return Rate > 0.0f ? 1.0f / Rate : 0.0f;
+    }
+
+    FAutoConsoleCommandWithWorldAndArgs GWireStopRecordInputCommand(
+        TEXT("Wire.StopRecordInput"),
+        TEXT("入力の記録を終えて保存する"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+        {
+            if (AVRPawn* Pawn = GetLocalVRPawn(World))
+                Pawn->StopInputRecording();
+        }));
+}
 
 // Sets default values
 AVRPawn::AVRPawn()
 {
     PrimaryActorTick.bCanEverTick = true;
 
+    // 見た目の更新は移動の後に別の Tick で行う
+    CosmeticTickFunction.bCanEverTick = true;
+    CosmeticTickFunction.bStartWithTickEnabled = true;
+    CosmeticTickFunction.TickGroup = TG_PostPhysics;
+    RopeTickFunction.bCanEverTick = true;
+    RopeTickFunction.bStartWithTickEnabled = true;
+    RopeTickFunction.TickGroup = TG_PostPhysics;
+
+    // 移動は ServerMove と NetState で独自に同期する
+    bReplicates = true;
+    SetReplicatingMovement(false);
+
     CapsuleComponent = CreateDefaultSubobject<UCapsuleComponent>(TEXT("Capsule"));
     RootComponent = CapsuleComponent;
     CapsuleComponent->InitCapsuleSize(50.f, 85.0f);
@@ -69,6 +128,18 @@ AVRPawn::AVRPawn()
     SplineMeshComponent[1]->SetEndScale(FVector2D::UnitVector * 0.005);
     SplineMeshComponent[1]->CastShadow = false;
 
+    // ワイヤーの状態と演算（移動は Pawn が衝突付きで行うので自動では動かさない）
+    WireTether = CreateDefaultSubobject<UWireTetherComponent>(TEXT("WireTether"));
+    WireTether->NumTethers = 2;
+    WireTether->bAutoMove = false;
+
+    // 軌道予測の描画
+    TrajectoryLine = CreateDefaultSubobject<ULineBatchComponent>(TEXT("TrajectoryLine"));
+    TrajectoryLine->SetupAttachment(RootComponent);
+    TrajectoryLine->SetCollisionProfileName(TEXT("NoCollision"));
+    TrajectoryLine->SetOnlyOwnerSee(true);
+    TrajectoryLine->CastShadow = false;
+
     // オーディオ関係
     WireAttachAudio = CreateDefaultSubobject<UAudioComponent>(TEXT("WireAttachAudio"));
     WireAttachAudio->SetupAttachment(RootComponent);
@@ -95,140 +166,1270 @@ AVRPawn::AVRPawn()
     CharacterShoulder_R->SetupAttachment(RootComponent);
     CharacterShoulder_L->AddLocalOffset(FVector::RightVector * -40);
     CharacterShoulder_R->AddLocalOffset(FVector::RightVector * 40);
+}
+
+
+void AVRPawn::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // 傾斜判定用sin値を事前計算
+    SlopeSin = sinf(SlopeLimit / 180 * PI);
+
+    // ワイヤー演算の設定
+    WireTether->bUseXPBD = bUseXPBDTether;
+    WireTether->Compliance = WireCompliance;
+    WireTether->PullStrength = WirePullStrength;
+    WireTether->Gravity = Gravity;
+    WireTether->AirResistance = AirResistance;
+    WireTether->SimulationRate = SimulationRate;
+    WireTether->MaxWrapPoints = MaxWrapPoints;
+    WireTether->ApplySolverSettings();
+
+    // ロープの設定
+    for (FWireRope& Rope : WireRope)
+        Rope.SetSettings(RopeSettings);
+
+    // 軌道予測の設定
+    TrajectoryPreview.SetSettings(TrajectoryPreviewSettings);
+
+    // 移動の1ステップがワイヤー演算の固定タイムステップの整数倍になるよう頻度を合わせる
+    if (MovementStepRate > 0.0f)
+    {
+        const int32 SolverStepsPerMove = FMath::Max(FMath::RoundToInt32(SimulationRate / MovementStepRate), 1);
+        const float ValidStepRate = SimulationRate / SolverStepsPerMove;
+        if (!FMath::IsNearlyEqual(MovementStepRate, ValidStepRate, 1.0e-3f))
+        {
+            UE_LOG(LogWire, Warning, TEXT("MovementStepRate %.2f does not divide SimulationRate %.2f. Using %.2f Hz."),
+                MovementStepRate, SimulationRate, ValidStepRate);
+            MovementStepRate = ValidStepRate;
+        }
+    }
+
+    // 固定ステップで進める移動の開始位置と時刻
+    PrevSimulatedLocation = SimulatedLocation = GetActorLocation();
+    MovementTime = GetWorld()->GetTimeSeconds();
+
+    // 補間・補正のずれを見せる手・体のメッシュと元の相対位置
+    VisualOffsetComponents = { WireGun_L, WireGun_R, CharacterHand_L, CharacterHand_R, CharacterBody, CharacterShoulder_L, CharacterShoulder_R };
+    VisualOffsetBaseLocations.Reset(VisualOffsetComponents.Num());
+    for (USceneComponent* Component : VisualOffsetComponents)
+        VisualOffsetBaseLocations.Add(Component->GetRelativeLocation());
+
+    // ワイヤーの引き寄せを物理スレッドで演算する（サーバーでの再演算と一致しないのでスタンドアロンのみ）
+    if (bUseAsyncPhysicsWire)
+    {
+        if (GetNetMode() == NM_Standalone)
+            StartAsyncPhysicsWire();
+        else
+            UE_LOG(LogWire, Warning, TEXT("bUseAsyncPhysicsWire is only supported in standalone. Using the game thread solver."));
+    }
+
+    // 見た目の更新を重要度で間引く（専用サーバーでは見た目を更新しない）
+    if (GetNetMode() != NM_DedicatedServer)
+    {
+        SignificanceSubsystem = GetWorld()->GetSubsystem<UWireSignificanceSubsystem>();
+        if (SignificanceSubsystem)
+            SignificanceSubsystem->RegisterPawn(this);
+    }
+
+    // 全プレイヤーのワイヤーを1つのメッシュにまとめて描画する
+    if (bUseBatchedWireRenderer && GetNetMode() != NM_DedicatedServer)
+    {
+        if (UWireRenderSubsystem* WireRender = GetWorld()->GetSubsystem<UWireRenderSubsystem>())
+        {
+            WireBatch = WireRender->GetRenderer(SplineMeshComponent[0]->GetMaterial(0));
+            for (int index = 0; index < 2; ++index)
+            {
+                WireBatchHandle[index] = WireBatch->AddWire();
+                SplineMeshComponent[index]->SetVisibility(false);
+            }
+        }
+    }
+
+    // ワイヤー表示更新
+    for (int index = 0; index < 2; ++index)
+        CheckConnectable(index, true);
+
+    UE_LOG(LogWire, Log, TEXT("ver.1.1"));
+
+    if (MotionController[0]) {
+        UE_LOG(LogWire, Log, TEXT("MotionController[0] is found."));
+    }
+    else {
+        UE_LOG(LogWire, Log, TEXT("MotionController[0] is not found!"));
+    }
+
+    if (MotionController[1]) {
+        UE_LOG(LogWire, Log, TEXT("MotionController[1] is found."));
+    }
+    else {
+        UE_LOG(LogWire, Log, TEXT("MotionController[1] is not found!"));
+    }
+
+}
+
+
+void AVRPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    StopGhostRecording();
+    StopInputRecording();
+    StopAsyncPhysicsWire();
+
+    if (SignificanceSubsystem)
+    {
+        SignificanceSubsystem->UnregisterPawn(this);
+        SignificanceSubsystem = nullptr;
+    }
+
+    // 一括描画からワイヤーを外す
+    if (IsValid(WireBatch))
+    {
+        for (int index = 0; index < 2; ++index)
+            WireBatch->RemoveWire(WireBatchHandle[index]);
+        for (int32 Handle : WrapSegmentWires)
+            WireBatch->RemoveWire(Handle);
+    }
+    WireBatch = nullptr;
+    WireBatchHandle[0] = WireBatchHandle[1] = INDEX_NONE;
+    WrapSegmentWires.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+
+void AVRPawn::Tick(float deltaTime)
+{
+    WIRE_TICK_PROFILER_SCOPE(Tick);
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnTick, VRPawnTick);
+
+    FWireSolver& WireSolver = WireTether->GetSolver();
+
+    Super::Tick(deltaTime);
+
+    if (IsLocallySimulated())
+    {
+        // 必要に応じた接続可否判定（切断後のロープの巻き戻し中は行わない）
+        for (int index = 0; index < 2; ++index)
+        {
+            if (!WireSolver.GetTether(index).bAttached && !WireRope[index].IsRecoiling())
+                CheckConnectable(index, false);
+        }
+
+        // 固定ステップの位置から動かされていたら（補正・テレポート）そこから進める
+        if (!GetActorLocation().Equals(SimulatedLocation, 0.01))
+            PrevSimulatedLocation = SimulatedLocation = GetActorLocation();
+
+        // 入力はフレーム単位で記録し、再生時も同じフレーム時間から同じステップ数を進める
+        FVRPawnMove FrameMove;
+        FrameMove.DeltaTime = deltaTime;
+        FrameMove.Flags = PendingMoveFlags;
+        FrameMove.MoveInput = PendingMoveInput;
+
+        // 押し続ける入力は同じフレームで進める全ステップに反映する
+        constexpr uint8 HeldFlags = (uint8)(EVRPawnMoveFlags::WantsWire_L | EVRPawnMoveFlags::WantsWire_R
+            | EVRPawnMoveFlags::RetractWire_L | EVRPawnMoveFlags::RetractWire_R | EVRPawnMoveFlags::Move);
+
+        // このフレームの入力で固定ステップずつ移動（スイープの回数の上限はフレーム全体で分け合う）
+        float StepTime = 0.0f;
+        const int32 NumSteps = ConsumeMovementSteps(deltaTime, StepTime);
+        int32 SweepBudget = MaxCollisionSweeps;
+        const bool bSendMoves = GetLocalRole() == ROLE_AutonomousProxy;
+        if (bCaptureFrameMoves)
+            FrameMoves.Reset();
+        for (int32 Step = 0; Step < NumSteps; ++Step)
+        {
+            FVRPawnMove Move = ConsumePendingMove(StepTime);
+            if (Step + 1 < NumSteps)
+            {
+                PendingMoveFlags = Move.Flags & HeldFlags;
+                PendingMoveInput = Move.MoveInput;
+            }
+
+            // ワイヤーの固定タイムステップの回数はこの端末の端数時間から決めて入力と一緒に送る
+            Move.NumSubsteps = (uint8)FMath::Min(WireSolver.ConsumeSubsteps(Move.DeltaTime), (int32)MAX_uint8);
+
+            // 残りのステップに1回ずつ残して、このステップで使えるスイープの回数を決める
+            Move.MaxSweeps = (uint8)FMath::Clamp(SweepBudget - (NumSteps - Step - 1), 1, (int32)MAX_uint8);
+
+            PrevSimulatedLocation = GetActorLocation();
+            const FWireSolverStepResult StepResult = PerformMove(Move, false);
+            WireStats::RecordPullMagnitude(StepResult.PullAcceleration.Size());
+            SweepBudget -= LastMoveSweeps;
+            SyncWantsWireFlags();
+
+            if (bSendMoves || bCaptureFrameMoves)
+            {
+                // 結果を保存し、フレームの最後にまとめてサーバーへ送る
+                Move.ResultLocation = GetActorLocation();
+                for (int i = 0; i < 2; ++i)
+                {
+                    if (WireSolver.GetTether(i).bAttached)
+                        Move.AddFlag(VRPawnAttachedFlag(i));
+                }
+                FrameMoves.Add(Move);
+            }
+
+            if (bSendMoves)
+            {
+                SavedMoves.Add(Move);
+                if (SavedMoves.Num() > MaxSavedMoves)
+                    SavedMoves.RemoveAt(0, SavedMoves.Num() - MaxSavedMoves, EAllowShrinking::No);
+            }
+            else if (GetNetMode() != NM_Standalone)
+            {
+                // ホストの Pawn の状態を他プレイヤーへ複製
+                NetState = MakeNetState(Move.TimeStamp);
+            }
+        }
+        SimulatedLocation = GetActorLocation();
+        SET_DWORD_STAT(STAT_WireVRPawnSavedMoves, SavedMoves.Num());
+
+        // このフレームの入力を1回の RPC で送る（欠落に備えて前フレームの入力も一緒に送る）
+        if (bSendMoves && FrameMoves.Num() > 0)
+        {
+            ServerMove(FrameMoves, PreviousFrameMoves);
+            Swap(FrameMoves, PreviousFrameMoves);
+            FrameMoves.Reset();
+        }
+
+        // 入力の記録（再生時に結果を比べられるよう移動後の位置も残す）
+        if (InputRecording)
+        {
+            FWireInputFrame& Frame = InputRecording->Frames.AddDefaulted_GetRef();
+            Frame.Move = FrameMove;
+            Frame.Move.TimeStamp = (float)MovementTime;
+            Frame.Move.ResultLocation = SimulatedLocation;
+            for (int i = 0; i < 2; ++i)
+            {
+                if (MotionController[i])
+                {
+                    Frame.Move.HandLocation[i] = MotionController[i]->GetRelativeLocation();
+                    Frame.Move.HandRotation[i] = MotionController[i]->GetRelativeRotation();
+                }
+            }
+            Frame.HeadLocation = VRCamera->GetRelativeLocation();
+            Frame.HeadRotation = VRCamera->GetRelativeRotation();
+        }
+        WireStats::UpdateAttachRate(GetWorld());
+
+        if (GetLocalRole() == ROLE_AutonomousProxy)
+            UpdateCorrectionSmoothing(deltaTime);
+
+        // 描画は直前の2ステップの間を端数時間で補間した位置に見せる（ルートは固定ステップの位置のまま）
+        InterpolationOffset = FVector::ZeroVector;
+        if (MovementStepRate > 0.0f && !WireAsyncCallback)
+        {
+            const float Alpha = FMath::Clamp(MovementAccumulator / StepTime, 0.0f, 1.0f);
+            InterpolationOffset = (PrevSimulatedLocation - SimulatedLocation) * (1.0f - Alpha);
+        }
+        ApplyVisualOffset();
+    }
+    else if (GetLocalRole() == ROLE_SimulatedProxy)
+    {
+        SmoothSimulatedProxy(deltaTime);
+    }
+
+    RecordGhostSample(deltaTime);
+
+    // ロープの Tick はワーカースレッドで動くことがあるので、読む値をここで写しておく
+    if (bUseRopeSimulation)
+        CaptureRopeInput();
+}
+
+
+void AVRPawn::CaptureRopeInput()
+{
+    const FWireSolver& WireSolver = WireTether->GetSolver();
+    for (int index = 0; index < 2; ++index)
+    {
+        const FWireTether& Tether = WireSolver.GetTether(index);
+        FRopeInput& Input = RopeInput[index];
+        Input.bAttached = Tether.bAttached;
+        Input.HandLocation = GetControllerVisualLocation(index);
+        Input.Pivot = Tether.GetPivot();
+        Input.FreeLength = Tether.GetFreeLength();
+    }
+}
+
+
+void AVRPawn::RegisterActorTickFunctions(bool bRegister)
+{
+    Super::RegisterActorTickFunctions(bRegister);
+
+    if (bRegister)
+    {
+        // 専用サーバーでは見た目を更新しない
+        if (GetNetMode() == NM_DedicatedServer)
+            return;
+
+        const float Interval = FMath::Max(RateToTickInterval(CosmeticTickRate), RateToTickInterval(SignificanceTickRate));
+
+        // ロープは移動の Tick の最後に写した値（RopeInput）だけを読むので、その後ならワーカースレッドで進められる
+        if (bUseRopeSimulation)
+        {
+            RopeTickFunction.Target = this;
+            RopeTickFunction.bRunOnAnyThread = bSimulateRopeOnWorkerThread;
+            RopeTickFunction.TickInterval = Interval;
+            RopeTickFunction.RegisterTickFunction(GetLevel());
+            RopeTickFunction.AddPrerequisite(this, PrimaryActorTick);
+        }
+
+        CosmeticTickFunction.Target = this;
+        CosmeticTickFunction.TickInterval = Interval;
+        CosmeticTickFunction.RegisterTickFunction(GetLevel());
+        CosmeticTickFunction.AddPrerequisite(this, PrimaryActorTick);
+        if (RopeTickFunction.IsTickFunctionRegistered())
+            CosmeticTickFunction.AddPrerequisite(this, RopeTickFunction);
+    }
+    else
+    {
+        if (CosmeticTickFunction.IsTickFunctionRegistered())
+            CosmeticTickFunction.UnRegisterTickFunction();
+        if (RopeTickFunction.IsTickFunctionRegistered())
+            RopeTickFunction.UnRegisterTickFunction();
+    }
+}
+
+
+void AVRPawn::SetCosmeticTickRate(float Rate)
+{
+    CosmeticTickRate = FMath::Max(Rate, 0.0f);
+    UpdateCosmeticTickInterval();
+}
+
+
+void AVRPawn::SetCosmeticSignificance(EWireCosmeticSignificance InSignificance, float TickRate)
+{
+    const bool bWasCulled = CosmeticSignificance == EWireCosmeticSignificance::Culled;
+    const bool bCulled = InSignificance == EWireCosmeticSignificance::Culled;
+    CosmeticSignificance = InSignificance;
+    if (bWasCulled != bCulled)
+        SetCosmeticsCulled(bCulled);
+
+    if (SignificanceTickRate == TickRate)
+        return;
+
+    SignificanceTickRate = TickRate;
+    UpdateCosmeticTickInterval();
+}
+
+
+void AVRPawn::SetCosmeticsCulled(bool bCulled)
+{
+    if (bCulled)
+    {
+        // 更新を止める間に古い形のまま残らないようワイヤーを隠し、ループしている風切り音を止める
+        for (int index = 0; index < 2; ++index)
+            SetWireVisibility(index, false);
+        if (WireBatch)
+        {
+            for (int32 Handle : WrapSegmentWires)
+                WireBatch->SetWireVisible(Handle, false);
+        }
+        for (USplineMeshComponent* Segment : WrapSegmentMesh)
+            Segment->SetVisibility(false);
+
+        bWindAudioCulled = WindAudio->IsPlaying();
+        if (bWindAudioCulled)
+            WindAudio->Stop();
+        return;
+    }
+
+    // 止めていたロープは今の位置から張り直し、接続状態に合わせて表示し直す
+    for (int index = 0; index < 2; ++index)
+    {
+        const FWireTether& Tether = WireTether->GetSolver().GetTether(index);
+        if (Tether.bAttached && WireRope[index].IsAttached())
+            WireRope[index].Attach(GetControllerVisualLocation(index), Tether.GetPivot(), Tether.GetFreeLength());
+        SyncWireVisual(index);
+    }
+    UpdateWrapSegments();
+
+    if (bWindAudioCulled)
+    {
+        WindAudio->Play();
+        bWindAudioCulled = false;
+    }
+}
+
+
+void AVRPawn::UpdateCosmeticTickInterval()
+{
+    // 設定と重要度のうち低い方の頻度にする
+    const float Interval = FMath::Max(RateToTickInterval(CosmeticTickRate), RateToTickInterval(SignificanceTickRate));
+    if (CosmeticTickFunction.TickInterval == Interval)
+        return;
+
+    CosmeticTickFunction.UpdateTickIntervalAndCoolDown(Interval);
+    RopeTickFunction.UpdateTickIntervalAndCoolDown(Interval);
+}
+
+
+void AVRPawn::TickRopeSimulation(float deltaTime)
+{
+    // 見えていない Pawn のロープは止めておく
+    if (CosmeticSignificance == EWireCosmeticSignificance::Culled)
+        return;
+
+    for (int index = 0; index < 2; ++index)
+        SimulateWireRope(index, deltaTime);
+}
+
+
+void AVRPawn::TickCosmetic(float deltaTime)
+{
+    WIRE_TICK_PROFILER_SCOPE(Cosmetic);
+
+    // 重要でない Pawn は何も更新しない
+    if (CosmeticSignificance == EWireCosmeticSignificance::Culled)
+        return;
+
+    // ワイヤー描画（ロープは FVRPawnRopeTickFunction で進めた結果を反映）
+    {
+        WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnWireRender, VRPawnWireRender);
+
+        for (int index = 0; index < 2; ++index)
+            UpdateWireVisual(index);
+    }
+
+    // 照準先に接続した場合の軌道予測（自分で動かしている Pawn のみ）
+    if (bShowTrajectoryPreview && IsLocallySimulated())
+        UpdateTrajectoryPreview();
+
+    // 腕の向き・風切り音は近くで見えている Pawn のみ
+    if (CosmeticSignificance == EWireCosmeticSignificance::Minimal)
+    {
+        if (SignificanceSubsystem)
+            SignificanceSubsystem->AddCosmeticUpdates(1);
+        return;
+    }
+
+    if (SignificanceSubsystem)
+        SignificanceSubsystem->AddCosmeticUpdates(UWireSignificanceSubsystem::CosmeticUpdatesPerPawn);
+
+    {
+        WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnCosmetic, VRPawnCosmetic);
+
+        // 風切り音の再生
+        WindAudio->SetVolumeMultiplier(CurrentVelocity.Size() / 5000);
 
-    //その他配列の確保
-    bWireAttached.SetNum(2);
-    bPrevConnectable.SetNum(2);
-    CurrentWireLength.SetNum(2);
-    AttachWireLength.SetNum(2);
-    StaticAnchorLocation.SetNum(2);
+
+        // 腕の向きを調整
+        FVector StartLocation = CharacterHand_L->GetComponentLocation();
+        FVector TargetLocation = CharacterShoulder_L->GetComponentLocation();
+        FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(StartLocation, TargetLocation);
+        CharacterHand_L->SetWorldRotation(LookAtRotation);
+        StartLocation = CharacterHand_R->GetComponentLocation();
+        TargetLocation = CharacterShoulder_R->GetComponentLocation();
+        LookAtRotation = UKismetMathLibrary::FindLookAtRotation(StartLocation, TargetLocation);
+        CharacterHand_R->SetWorldRotation(LookAtRotation);
+    }
+}
+
+
+bool AVRPawn::IsLocallySimulated() const
+{
+    // サーバー上のリモートプレイヤーの Pawn は ServerMove で届いた入力でのみ動かす
+    return GetLocalRole() == ROLE_AutonomousProxy
+        || (GetLocalRole() == ROLE_Authority && GetRemoteRole() != ROLE_AutonomousProxy);
+}
+
+
+FVRPawnMove AVRPawn::ConsumePendingMove(float deltaTime)
+{
+    // 1フレームで複数ステップ進めてもタイムスタンプが重ならないよう、移動の時刻を進めて使う
+    MovementTime += deltaTime;
+
+    FVRPawnMove Move;
+    Move.TimeStamp = (float)MovementTime;
+    Move.DeltaTime = deltaTime;
+    Move.Flags = PendingMoveFlags;
+    Move.MoveInput = PendingMoveInput;
+
+    // コントローラーの姿勢は Pawn からの相対で記録
+    for (int i = 0; i < 2; ++i)
+    {
+        if (MotionController[i])
+        {
+            Move.HandLocation[i] = MotionController[i]->GetRelativeLocation();
+            Move.HandRotation[i] = MotionController[i]->GetRelativeRotation();
+        }
+    }
+
+    PendingMoveFlags = 0;
+    PendingMoveInput = FVector2D::ZeroVector;
+
+    return Move;
+}
+
+
+int32 AVRPawn::ConsumeMovementSteps(float deltaTime, float& OutStepTime)
+{
+    // 固定ステップを使わなければフレームの時間で1回
+    if (MovementStepRate <= 0.0f)
+    {
+        OutStepTime = deltaTime;
+        return 1;
+    }
+
+    // ヘッドセットの更新頻度に関わらず同じ時間で進め、端数は次のフレームへ持ち越す
+    OutStepTime = 1.0f / MovementStepRate;
+    MovementAccumulator += FMath::Max(deltaTime, 0.0f);
+    int32 NumSteps = FMath::FloorToInt32((MovementAccumulator + OutStepTime * 1.0e-3f) / OutStepTime);
+
+    // 上限を超えたらその分の時間は捨てる（ヒッチ時に処理が膨らまないように）
+    if (NumSteps > MaxMovementStepsPerFrame)
+    {
+        NumSteps = MaxMovementStepsPerFrame;
+        MovementAccumulator = 0.0f;
+    }
+    else
+    {
+        MovementAccumulator = FMath::Max(MovementAccumulator - NumSteps * OutStepTime, 0.0f);
+    }
+
+    return NumSteps;
+}
+
+
+void AVRPawn::ResetMovementInterpolation()
+{
+    // 今の位置を固定ステップの位置とし、描画のずれも消す
+    PrevSimulatedLocation = SimulatedLocation = GetActorLocation();
+    InterpolationOffset = FVector::ZeroVector;
+    ApplyVisualOffset();
+
+    MovementAccumulator = 0.0f;
+    WireTether->GetSolver().ResetAccumulator();
+}
+
+
+FWireSolverStepResult AVRPawn::PerformMove(const FVRPawnMove& Move, bool bApplyPoses)
+{
+    // 記録された姿勢を再現
+    if (bApplyPoses)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            if (MotionController[i])
+                MotionController[i]->SetRelativeLocationAndRotation(Move.HandLocation[i], Move.HandRotation[i]);
+        }
+    }
+
+    LastMoveSweeps = 0;
+
+    // 物理スレッドで演算している間は、物理の速度に入力による変化だけを加える
+    if (WireAsyncCallback)
+        CurrentVelocity = CapsuleComponent->GetPhysicsLinearVelocity();
+    const FVector VelocityBeforeInput = CurrentVelocity;
+
+    // 入力の反映
+    if (Move.HasFlag(EVRPawnMoveFlags::Jump))
+        ApplyJump();
+    if (Move.HasFlag(EVRPawnMoveFlags::Move))
+        ApplyMoveInput(Move.MoveInput);
+    for (int i = 0; i < 2; ++i)
+    {
+        if (Move.HasFlag(VRPawnWantsWireFlag(i)) != WireTether->GetSolver().GetTether(i).bAttached)
+            ToggleWire(i);
+        if (Move.HasFlag(VRPawnRetractWireFlag(i)))
+            RetractWire(i, Move.DeltaTime);
+    }
+
+    // ワイヤーの角への巻き付き
+    for (int index = 0; index < 2; ++index)
+    {
+        if (WireTether->GetSolver().GetTether(index).bAttached)
+            UpdateWireWrap(index);
+    }
+
+    // 重力・空気抵抗・ワイヤーの引き寄せの演算と衝突付き移動
+    if (WireAsyncCallback)
+        return SendAsyncPhysicsInput(CurrentVelocity - VelocityBeforeInput);
+    return MoveSubstepped(Move.DeltaTime, Move.NumSubsteps, Move.MaxSweeps);
+}
+
+
+void AVRPawn::ServerMove_Implementation(const TArray<FVRPawnMove>& Moves, const TArray<FVRPawnMove>& PreviousMoves)
+{
+    // 1回で実行する入力の数を制限（前回の送信が届いていなければ前フレームの入力から実行）
+    const int32 MaxMoves = FMath::Max(MaxMovementStepsPerFrame, 1);
+    for (int32 i = FMath::Max(PreviousMoves.Num() - MaxMoves, 0); i < PreviousMoves.Num(); ++i)
+        ProcessServerMove(PreviousMoves[i]);
+
+    bool bProcessed = false;
+    for (int32 i = FMath::Max(Moves.Num() - MaxMoves, 0); i < Moves.Num(); ++i)
+    {
+        if (ProcessServerMove(Moves[i]))
+        {
+            bProcessed = true;
+            ++NumServerMoves;
+        }
+    }
+    if (!bProcessed)
+        return;
+
+    // 結果はフレームの最後の入力で比べる
+    const FVRPawnMove& Move = Moves.Last();
+
+    // クライアントの結果と比べ、ずれていれば補正を送る（固定タイムステップの回数がずれていた時も）
+    bool bNeedsCorrection = bServerSubstepsRejected
+        || FVector::DistSquared(GetActorLocation(), Move.ResultLocation) > FMath::Square(MaxLocationError);
+    for (int i = 0; i < 2; ++i)
+    {
+        if (WireTether->GetSolver().GetTether(i).bAttached != Move.HasFlag(VRPawnAttachedFlag(i)))
+            bNeedsCorrection = true;
+    }
+
+    // 承認は次の複製の時にまとめて最新の分だけ送る（補正を送ったら承認は不要）
+    if (bNeedsCorrection)
+    {
+        ++NumServerCorrections;
+        ClientAdjustPosition(NetState, (float)ServerSolverTime);
+        PendingAckTimeStamp = 0.0f;
+        bServerSubstepsRejected = false;
+    }
+    else
+        PendingAckTimeStamp = Move.TimeStamp;
+}
+
+
+void AVRPawn::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+    Super::PreReplication(ChangedPropertyTracker);
+
+    if (PendingAckTimeStamp > 0.0f)
+    {
+        ClientAckGoodMove(PendingAckTimeStamp);
+        PendingAckTimeStamp = 0.0f;
+    }
+}
+
+
+bool AVRPawn::ProcessServerMove(const FVRPawnMove& Move)
+{
+    // 実行済み・順序が入れ替わった入力は無視
+    if (Move.TimeStamp <= LastServerMoveTimeStamp)
+        return false;
+    LastServerMoveTimeStamp = Move.TimeStamp;
+
+    // 1入力で進める時間を制限
+    FVRPawnMove ClampedMove = Move;
+    ClampedMove.DeltaTime = FMath::Clamp(Move.DeltaTime, 0.0f, MaxMoveDeltaTime);
+
+    // クライアントの端数時間をサーバーでも積算し、固定タイムステップの回数をその切り捨て～切り上げに制限
+    // （0 回を送り続けて浮く・1 回ずつ多く送って時間を進める入力を防ぐ。範囲外なら補正して端数時間を合わせる）
+    const FWireSolverSettings& SolverSettings = WireTether->GetSolver().GetSettings();
+    const double FixedTimeStep = SolverSettings.FixedTimeStep;
+    ServerSolverTime += ClampedMove.DeltaTime;
+    const int32 MinSubsteps = FMath::Clamp(FMath::FloorToInt32(ServerSolverTime / FixedTimeStep), 0, SolverSettings.MaxSubsteps);
+    const int32 MaxSubsteps = FMath::Clamp(FMath::CeilToInt32(ServerSolverTime / FixedTimeStep), 0, SolverSettings.MaxSubsteps);
+    const int32 NumSubsteps = FMath::Clamp((int32)Move.NumSubsteps, MinSubsteps, MaxSubsteps);
+    if (NumSubsteps != Move.NumSubsteps)
+        bServerSubstepsRejected = true;
+    ClampedMove.NumSubsteps = (uint8)NumSubsteps;
+
+    // 上限で打ち切った分の時間はクライアントと同じく捨てる
+    ServerSolverTime -= NumSubsteps * FixedTimeStep;
+    if (ServerSolverTime >= FixedTimeStep)
+        ServerSolverTime = 0.0;
+
+    ClampedMove.MaxSweeps = (uint8)FMath::Clamp((int32)Move.MaxSweeps, 1, MaxCollisionSweeps);
+    PerformMove(ClampedMove, true);
+
+    NetState = MakeNetState(Move.TimeStamp);
+    return true;
+}
+
+
+void AVRPawn::ClientAckGoodMove_Implementation(float TimeStamp)
+{
+    if (TimeStamp <= ClientAckedTimeStamp)
+        return;
+    ClientAckedTimeStamp = TimeStamp;
+
+    // 承認された入力までを破棄
+    const int32 NumAcked = SavedMoves.IndexByPredicate([TimeStamp](const FVRPawnMove& Move) { return Move.TimeStamp > TimeStamp; });
+    SavedMoves.RemoveAt(0, NumAcked == INDEX_NONE ? SavedMoves.Num() : NumAcked, EAllowShrinking::No);
+}
+
+
+void AVRPawn::ClientAdjustPosition_Implementation(const FVRPawnNetState& State, float SolverTime)
+{
+    FWireSolver& WireSolver = WireTether->GetSolver();
+
+    // 既により新しい承認・補正を受けていれば無視
+    if (State.TimeStamp <= ClientAckedTimeStamp)
+        return;
+    ClientAckedTimeStamp = State.TimeStamp;
+
+    // 補正された入力までを破棄
+    const int32 NumAcked = SavedMoves.IndexByPredicate([&State](const FVRPawnMove& Move) { return Move.TimeStamp > State.TimeStamp; });
+    SavedMoves.RemoveAt(0, NumAcked == INDEX_NONE ? SavedMoves.Num() : NumAcked, EAllowShrinking::No);
+
+    // サーバーの状態と端数時間に戻す
+    const FVector OldLocation = GetActorLocation();
+    ApplyNetState(State, true);
+    WireSolver.SetAccumulator(SolverTime);
+
+    // 未承認の入力を入力時のコントローラーの姿勢で再生し直す
+    FTransform CurrentHand[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        if (MotionController[i])
+            CurrentHand[i] = MotionController[i]->GetRelativeTransform();
+    }
+
+    // まだ進めていない接続の入力は補正後の状態に対して残す
+    bool bWantsChanged[2];
+    for (int i = 0; i < 2; ++i)
+        bWantsChanged[i] = ((PendingMoveFlags & (uint8)VRPawnWantsWireFlag(i)) != 0) != WireSolver.GetTether(i).bAttached;
+
+    bReplayingMoves = true;
+    for (FVRPawnMove& SavedMove : SavedMoves)
+    {
+        // 固定タイムステップの回数は補正後の端数時間から決め直す
+        SavedMove.NumSubsteps = (uint8)FMath::Min(WireSolver.ConsumeSubsteps(SavedMove.DeltaTime), (int32)MAX_uint8);
+        PerformMove(SavedMove, true);
+        SavedMove.ResultLocation = GetActorLocation();
+    }
+    bReplayingMoves = false;
+
+    SyncWantsWireFlags();
+    for (int i = 0; i < 2; ++i)
+    {
+        if (bWantsChanged[i])
+            PendingMoveFlags ^= (uint8)VRPawnWantsWireFlag(i);
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (MotionController[i])
+            MotionController[i]->SetRelativeTransform(CurrentHand[i]);
+    }
+
+    // 見た目を補正後の状態に合わせる
+    for (int index = 0; index < 2; ++index)
+        SyncWireVisual(index);
+    UpdateWrapSegments();
+
+    // 視点は元の位置から徐々に追従させる（大きくずれた時は即座に合わせる）
+    CorrectionOffset += OldLocation - GetActorLocation();
+    if (CorrectionOffset.Size() > MaxSmoothDistance)
+        CorrectionOffset = FVector::ZeroVector;
+
+    INC_DWORD_STAT(STAT_WireVRPawnCorrections);
+    UE_LOG(LogWire, Verbose, TEXT("VRPawn correction at %.3f: %.1f cm, %d moves replayed"),
+        State.TimeStamp, FVector::Dist(OldLocation, GetActorLocation()), SavedMoves.Num());
+}
+
+
+FVRPawnNetState AVRPawn::MakeNetState(float TimeStamp) const
+{
+    FVRPawnNetState State;
+    State.TimeStamp = TimeStamp;
+    State.Location = GetActorLocation();
+    State.Velocity = CurrentVelocity;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const FWireTether& Tether = WireTether->GetSolver().GetTether(i);
+        FVRPawnTetherState& TetherState = State.Tethers[i];
+        TetherState.bAttached = Tether.bAttached;
+        TetherState.Anchor = Tether.Anchor;
+        TetherState.CurrentLength = Tether.CurrentLength;
+        TetherState.AttachLength = Tether.AttachLength;
+        for (const FWireWrapPoint& WrapPoint : Tether.WrapPoints)
+        {
+            TetherState.WrapLocations.Add(WrapPoint.Location);
+            TetherState.WrapBendAxes.Add(WrapPoint.BendAxis.GetSafeNormal());
+        }
+
+        if (MotionController[i])
+        {
+            State.HandLocation[i] = MotionController[i]->GetRelativeLocation();
+            State.HandRotation[i] = MotionController[i]->GetRelativeRotation();
+        }
+    }
+
+    return State;
+}
+
+
+void AVRPawn::ApplyNetState(const FVRPawnNetState& State, bool bTeleport)
+{
+    if (bTeleport)
+        SetActorLocation(State.Location, false, nullptr, ETeleportType::TeleportPhysics);
+
+    CurrentVelocity = State.Velocity;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        const FVRPawnTetherState& TetherState = State.Tethers[i];
+
+        FWireTether Tether;
+        Tether.bAttached = TetherState.bAttached;
+        Tether.Anchor = TetherState.Anchor;
+        Tether.CurrentLength = TetherState.CurrentLength;
+        Tether.AttachLength = TetherState.AttachLength;
+        Tether.LastOrigin = GetControllerLocation(i);
+        const int32 NumWrapPoints = FMath::Min(TetherState.WrapLocations.Num(), TetherState.WrapBendAxes.Num());
+        for (int32 k = 0; k < NumWrapPoints; ++k)
+        {
+            Tether.WrapPoints.Add({ TetherState.WrapLocations[k], TetherState.WrapBendAxes[k] });
+        }
+        WireTether->GetSolver().SetTether(i, Tether);
+
+        // 自分の Pawn 以外はコントローラーの姿勢も反映
+        if (!IsLocallyControlled() && MotionController[i])
+            MotionController[i]->SetRelativeLocationAndRotation(State.HandLocation[i], State.HandRotation[i]);
+    }
+}
+
+
+void AVRPawn::OnRep_NetState()
+{
+    ApplyNetState(NetState, false);
+    NetStateReceiveTime = GetWorld()->GetTimeSeconds();
+
+    for (int index = 0; index < 2; ++index)
+        SyncWireVisual(index);
+    UpdateWrapSegments();
+}
+
+
+void AVRPawn::SmoothSimulatedProxy(float deltaTime)
+{
+    // 受信した位置を速度で少しだけ先読みし、そこへ指数的に近づける
+    const float Age = (float)FMath::Min(GetWorld()->GetTimeSeconds() - NetStateReceiveTime, (double)ProxyMaxExtrapolation);
+    const FVector Target = NetState.Location + NetState.Velocity * Age;
+    const float Alpha = ProxySmoothTime > 0.0f ? 1.0f - FMath::Exp(-deltaTime / ProxySmoothTime) : 1.0f;
+
+    SetActorLocation(FMath::Lerp(GetActorLocation(), Target, Alpha));
+}
+
+
+void AVRPawn::UpdateCorrectionSmoothing(float deltaTime)
+{
+    if (CorrectionOffset.IsZero())
+        return;
+
+    // ずれを指数的に減らし、十分小さくなったら消す（見た目への反映は ApplyVisualOffset で補間と一緒に行う）
+    CorrectionOffset *= CorrectionSmoothTime > 0.0f ? FMath::Exp(-deltaTime / CorrectionSmoothTime) : 0.0f;
+    if (CorrectionOffset.IsNearlyZero(0.1))
+        CorrectionOffset = FVector::ZeroVector;
+}
+
+
+void AVRPawn::ApplyVisualOffset()
+{
+    const FVector Offset = InterpolationOffset + CorrectionOffset;
+    if (Offset.IsZero() && VisualOffset.IsZero())
+        return;
+    VisualOffset = Offset;
+
+    // カメラは追加オフセットをカメラのローカル空間で与える
+    VRCamera->ClearAdditiveOffset();
+    if (!Offset.IsZero())
+    {
+        const FVector LocalOffset = VRCamera->GetComponentTransform().InverseTransformVectorNoScale(Offset);
+        VRCamera->AddAdditiveOffset(FTransform(LocalOffset), 0.0f);
+    }
+
+    // 手・体のメッシュは元の相対位置から親のローカル空間でずらす（コントローラー自体は演算に使うので動かさない）
+    for (int32 i = 0; i < VisualOffsetComponents.Num(); ++i)
+    {
+        USceneComponent* Component = VisualOffsetComponents[i];
+        const USceneComponent* Parent = Component->GetAttachParent();
+        const FVector LocalOffset = Parent ? Parent->GetComponentTransform().InverseTransformVector(Offset) : Offset;
+        Component->SetRelativeLocation(VisualOffsetBaseLocations[i] + LocalOffset);
+    }
+}
+
+
+void AVRPawn::SyncWireVisual(int index)
+{
+    // 見えていない間は表示し直さない（戻った時に SetCosmeticsCulled で合わせる）
+    if (CosmeticSignificance == EWireCosmeticSignificance::Culled)
+        return;
+
+    const FWireTether& Tether = WireTether->GetSolver().GetTether(index);
+
+    if (Tether.bAttached)
+    {
+        if (bUseRopeSimulation && !WireRope[index].IsAttached())
+            WireRope[index].Attach(GetControllerLocation(index), Tether.GetPivot(), Tether.GetFreeLength());
+
+        SetWireMaterialState(index, 0);
+        SetWireVisibility(index, true);
+    }
+    else
+    {
+        if (WireRope[index].IsAttached())
+            WireRope[index].Release();
+
+        // 巻き戻しが終わってから照準表示へ（他プレイヤーの照準は表示しない）
+        if (!WireRope[index].IsRecoiling())
+        {
+            if (IsLocallySimulated())
+                CheckConnectable(index, true);
+            else
+                SetWireVisibility(index, false);
+        }
+    }
+}
+
+
+bool AVRPawn::StartGhostRecording(const FString& Name)
+{
+    StopGhostRecording();
+
+    if (!IsLocallyControlled())
+        return false;
+
+    GhostRecorder = MakeUnique<FWireGhostRecorder>(FWireGhostRecorder::GetGhostFilePath(Name), GhostSampleRate);
+    if (!GhostRecorder->Start())
+    {
+        GhostRecorder.Reset();
+        return false;
+    }
+    return true;
+}
+
+
+void AVRPawn::StopGhostRecording()
+{
+    // 残りのサンプルを書き切ってから閉じる
+    if (GhostRecorder)
+    {
+        GhostRecorder->Finish();
+        GhostRecorder.Reset();
+    }
 }
 
 
-void AVRPawn::BeginPlay()
+bool AVRPawn::StartInputRecording(const FString& Name)
 {
-    Super::BeginPlay();
+    StopInputRecording();
 
-    // 傾斜判定用sin値を事前計算
-    SlopeSin = sinf(SlopeLimit / 180 * PI);
+    if (!IsLocallySimulated() || !IsLocallyControlled())
+        return false;
 
-    // ワイヤー表示更新
-    CheckConnectable(0, true);
-    CheckConnectable(0, true);
+    // 端数時間は記録に残せないので捨て、記録開始時の状態から再生できるようにする
+    ResetMovementInterpolation();
 
-    UE_LOG(LogTemp, Log, TEXT("ver.1.1"));
+    InputRecording = MakeUnique<FWireInputRecording>();
+    // PIE で記録してもコマンドレットで開けるよう UEDPIE_ の接頭辞を外す
+    InputRecording->MapName = UWorld::RemovePIEPrefix(GetWorld()->GetOutermost()->GetName());
+    InputRecording->StartRotation = GetActorRotation();
+    InputRecording->StartState = MakeNetState(GetWorld()->GetTimeSeconds());
 
-    if (MotionController[0]) {
-        UE_LOG(LogTemp, Log, TEXT("MotionController[0] is found."));
+    // 記録はフレームごとなので、今のフレームレートで1分間分を確保
+    const float FrameRate = FMath::Clamp(1.0f / FMath::Max(GetWorld()->GetDeltaSeconds(), UE_KINDA_SMALL_NUMBER), 30.0f, 240.0f);
+    InputRecording->Frames.Reserve(FMath::CeilToInt32(FrameRate) * 60);
+    InputRecordingPath = FWireInputRecording::GetFilePath(Name);
+    return true;
+}
+
+
+void AVRPawn::StopInputRecording()
+{
+    if (InputRecording)
+    {
+        InputRecording->SaveToFile(InputRecordingPath);
+        InputRecording.Reset();
     }
-    else {
-        UE_LOG(LogTemp, Log, TEXT("MotionController[0] is not found!"));
+}
+
+
+void AVRPawn::ApplyRecordedFrame(const FWireInputFrame& Frame)
+{
+    // 接続状態のフラグは結果の比較用なので入力には含めない
+    PendingMoveFlags = Frame.Move.Flags & ~(uint8)(EVRPawnMoveFlags::Attached_L | EVRPawnMoveFlags::Attached_R);
+    PendingMoveInput = Frame.Move.MoveInput;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (MotionController[i])
+            MotionController[i]->SetRelativeLocationAndRotation(Frame.Move.HandLocation[i], Frame.Move.HandRotation[i]);
     }
+    VRCamera->SetRelativeLocationAndRotation(Frame.HeadLocation, Frame.HeadRotation);
+}
 
-    if (MotionController[1]) {
-        UE_LOG(LogTemp, Log, TEXT("MotionController[1] is found."));
+
+void AVRPawn::ApplyRecordingStart(const FWireInputRecording& Recording)
+{
+    SetActorRotation(Recording.StartRotation);
+    ApplyNetState(Recording.StartState, true);
+    ResetMovementInterpolation();
+
+    // ApplyNetState は自分の Pawn のコントローラーを動かさないので姿勢も合わせる
+    for (int i = 0; i < 2; ++i)
+    {
+        if (MotionController[i])
+            MotionController[i]->SetRelativeLocationAndRotation(Recording.StartState.HandLocation[i], Recording.StartState.HandRotation[i]);
+        SyncWireVisual(i);
     }
-    else {
-        UE_LOG(LogTemp, Log, TEXT("MotionController[1] is not found!"));
+}
+
+
+void AVRPawn::RecordGhostSample(float deltaTime)
+{
+    if (!GhostRecorder || !GhostRecorder->ShouldRecord(deltaTime))
+        return;
+
+    // 値を集めて積むだけ（圧縮と書き込みは記録用スレッドで行う）
+    FWireGhostSample Sample;
+    Sample.Time = GhostRecorder->GetElapsedTime();
+    Sample.PawnLocation = GetActorLocation();
+    Sample.HeadLocation = VRCamera->GetComponentLocation();
+    Sample.HeadRotation = VRCamera->GetComponentRotation();
+    for (int i = 0; i < 2; ++i)
+    {
+        const FWireTether& Tether = WireTether->GetSolver().GetTether(i);
+        if (MotionController[i])
+        {
+            Sample.HandLocation[i] = MotionController[i]->GetComponentLocation();
+            Sample.HandRotation[i] = MotionController[i]->GetComponentRotation();
+        }
+        if (Tether.bAttached)
+        {
+            Sample.AttachedMask |= 1 << i;
+            Sample.Anchor[i] = Tether.GetPivot();
+        }
     }
+    GhostRecorder->Record(Sample);
+}
+
 
+void AVRPawn::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // 自分の Pawn は ClientAdjustPosition で補正するので他プレイヤーにだけ送る
+    DOREPLIFETIME_CONDITION(AVRPawn, NetState, COND_SimulatedOnly);
 }
 
 
-void AVRPawn::Tick(float deltaTime)
+FWireSolverStepResult AVRPawn::MoveSubstepped(float deltaTime, int32 NumSolverSteps, int32 MaxSweeps)
 {
-    Super::Tick(deltaTime);
+    MaxSweeps = FMath::Max(MaxSweeps, 1);
+    const int32 NumCollisionSteps = CalculateCollisionSubsteps(deltaTime, NumSolverSteps, MaxSweeps);
+    const float SolverTimeStep = WireTether->GetSolver().GetSettings().FixedTimeStep;
 
-    // 必要に応じた接続可否判定
-    if (!bWireAttached[0])
-        CheckConnectable(0, false);
-    if (!bWireAttached[1])
-        CheckConnectable(1, false);
+    FWireSolverStepResult Result;
+    int32 NumSweeps = 0;
+    for (int32 i = 0; i < NumCollisionSteps; ++i)
+    {
+        // 固定タイムステップを均等に割り振り、動いた後のコントローラー位置で次を演算する
+        const int32 NumSteps = (i + 1) * NumSolverSteps / NumCollisionSteps - i * NumSolverSteps / NumCollisionSteps;
+        const FWireSolverStepResult StepResult = UpdateWireMovement(NumSteps);
 
-    // 重力演算
-    CurrentVelocity += FVector::DownVector * Gravity * deltaTime;
+        // 残りの区切りに1回ずつスイープを残す
+        const int32 SweepBudget = FMath::Max(MaxSweeps - NumSweeps - (NumCollisionSteps - i - 1), 1);
+        NumSweeps += MoveWithCollision(StepResult, NumSteps * SolverTimeStep, SweepBudget);
 
+        Result.Displacement += StepResult.Displacement;
+        Result.PullAcceleration = StepResult.PullAcceleration;
+        Result.NumSubsteps += StepResult.NumSubsteps;
+    }
 
-    // 空気抵抗による減速処理
-    CurrentVelocity *= (1 - AirResistance * deltaTime);
+    INC_DWORD_STAT_BY(STAT_WireCollisionSubsteps, NumCollisionSteps);
+    INC_DWORD_STAT_BY(STAT_WireCollisionSweeps, NumSweeps);
+    LastMoveSweeps = NumSweeps;
+    return Result;
+}
 
 
-    // ワイヤー接続中は専用の演算
-    FVector pullVelocity = FVector::ZeroVector;
-    if (bWireAttached[0] || bWireAttached[1])
-    {
-        pullVelocity = UpdateWireMovement(deltaTime);
-        CurrentVelocity += pullVelocity * deltaTime;
+void AVRPawn::StartAsyncPhysicsWire()
+{
+    FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+    Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr;
+    if (!Solver || WireAsyncCallback)
+        return;
+
+    if (!UPhysicsSettings::Get()->bTickPhysicsAsync)
+        UE_LOG(LogWire, Warning, TEXT("bUseAsyncPhysicsWire: Tick Physics Async is disabled. The wire runs at the game frame rate."));
+
+    // カプセルを物理で動かす（重力はソルバーで加え、回転はさせない）
+    FBodyInstance* BodyInstance = CapsuleComponent->GetBodyInstance();
+    BodyInstance->bLockXRotation = true;
+    BodyInstance->bLockYRotation = true;
+    BodyInstance->bLockZRotation = true;
+    BodyInstance->SetDOFLock(EDOFMode::SixDOF);
+    CapsuleComponent->SetUseCCD(true);
+    CapsuleComponent->SetSimulatePhysics(true);
+    CapsuleComponent->SetPhysicsLinearVelocity(CurrentVelocity);
+
+    WireAsyncCallback = Solver->CreateAndRegisterSimCallbackObject_External<FWireAsyncCallback>();
+    UE_LOG(LogWire, Log, TEXT("Wire constraint runs on the physics thread."));
+}
 
-        // ワイヤー描画
-        if (bWireAttached[0])
-            SplineMeshComponent[0]->SetStartAndEnd(
-                GetControllerLocation(0), FVector::ZeroVector,
-                StaticAnchorLocation[0], FVector::ZeroVector
-            );
-        if (bWireAttached[1])
-            SplineMeshComponent[1]->SetStartAndEnd(
-                GetControllerLocation(1), FVector::ZeroVector,
-                StaticAnchorLocation[1], FVector::ZeroVector
-            );
+
+void AVRPawn::StopAsyncPhysicsWire()
+{
+    if (!WireAsyncCallback)
+        return;
+
+    FPhysScene* PhysScene = GetWorld()->GetPhysicsScene();
+    if (Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr)
+        Solver->UnregisterAndFreeSimCallbackObject_External(WireAsyncCallback);
+    WireAsyncCallback = nullptr;
+
+    // 通し番号はコールバックごとなので、送りかけの速度の変化も捨てる
+    AsyncVelocityChangeSequence = 0;
+    AsyncPendingVelocityChanges.Reset();
+    AsyncAttachedMask = 0;
+}
+
+
+FWireSolverStepResult AVRPawn::SendAsyncPhysicsInput(const FVector& VelocityChange)
+{
+    WIRE_TICK_PROFILER_SCOPE(UpdateWireMovement);
+
+    FWireSolver& WireSolver = WireTether->GetSolver();
+
+    // 物理スレッドで前回までに演算した結果（移動は物理が済ませている）
+    FWireSolverStepResult Result;
+    uint32 AppliedSequence = 0;
+    while (Chaos::TSimCallbackOutputHandle<FWireAsyncOutput> Output = WireAsyncCallback->PopOutputData_External())
+    {
+        AsyncPullAcceleration = Output->PullAcceleration;
+        Result.NumSubsteps += Output->NumSubsteps;
+        AppliedSequence = FMath::Max(AppliedSequence, Output->AppliedVelocityChangeSequence);
+    }
+    Result.PullAcceleration = AsyncPullAcceleration;
+
+    // 物理スレッドが加えた速度の変化は送るのをやめ、新しい変化を積む
+    AsyncPendingVelocityChanges.RemoveAll([AppliedSequence](const FWireAsyncVelocityChange& Change) { return Change.Sequence <= AppliedSequence; });
+    if (!VelocityChange.IsNearlyZero())
+        AsyncPendingVelocityChanges.Add({ ++AsyncVelocityChangeSequence, VelocityChange });
+
+    // ワイヤーの状態（巻き取り・接続・切断・巻き付きは反映済み）と根元の位置を送る
+    FWireAsyncInput* Input = WireAsyncCallback->GetProducerInputData_External();
+    Input->Proxy = CapsuleComponent->GetBodyInstance()->GetPhysicsActorHandle();
+    Input->Settings = WireSolver.GetSettings();
+    uint32 AttachedMask = 0;
+    for (int i = 0; i < WireSolver.GetNumTethers(); ++i)
+    {
+        Input->Tethers[i] = WireSolver.GetTether(i);
+        Input->OriginOffsets[i] = GetControllerLocation(i) - GetActorLocation();
+        if (Input->Tethers[i].bAttached)
+            AttachedMask |= 1u << i;
     }
+    Input->VelocityChanges.Append(AsyncPendingVelocityChanges);
 
+    // 眠ったボディには物理スレッドのコールバックで速度を与えても動かないので、ワイヤーで吊られている間・接続状態が変わった時・速度の変化を送る間は起こす
+    if (AttachedMask != 0 || AttachedMask != AsyncAttachedMask || AsyncPendingVelocityChanges.Num() > 0)
+        CapsuleComponent->WakeAllRigidBodies();
+    AsyncAttachedMask = AttachedMask;
 
-    // 衝突付き移動
-    bGrounded = false;
+    // 接地判定は足元への短いスイープ1回
     FHitResult Hit;
-    MovementComponent->SafeMoveUpdatedComponent(
-        CurrentVelocity * deltaTime,
-        CapsuleComponent->GetComponentQuat(),
-        true,
-        Hit);
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(WireGroundCheck), false, this);
+    const FVector Start = GetActorLocation();
+    bGrounded = GetWorld()->SweepSingleByChannel(Hit, Start, Start - FVector(0.0f, 0.0f, 5.0f), CapsuleComponent->GetComponentQuat(),
+        CapsuleComponent->GetCollisionObjectType(), CapsuleComponent->GetCollisionShape(), Params)
+        && Hit.Normal.Z > SlopeSin;
+
+    return Result;
+}
+
+
+int32 AVRPawn::CalculateCollisionSubsteps(float deltaTime, int32 NumSolverSteps, int32 MaxSweeps) const
+{
+    if (NumSolverSteps <= 1)
+        return 1;
+
+    // ワイヤーの伸びによる引き寄せの加速度（XPBD では伸び / 柔らかさ。伸びない設定では1ステップで縮め切る加速度）
+    const float Error = GetWireConstraintError();
+    const float SolverTimeStep = WireTether->GetSolver().GetSettings().FixedTimeStep;
+    const float PullAcceleration = bUseXPBDTether
+        ? Error / FMath::Max(WireCompliance, FMath::Square(SolverTimeStep))
+        : Error * WirePullStrength;
+
+    // このフレームで進む距離の見積もり（今の速度に、引き寄せと重力の加速を加える）
+    const float Acceleration = PullAcceleration + Gravity;
+    const float Distance = CurrentVelocity.Size() * deltaTime + 0.5f * Acceleration * FMath::Square(deltaTime);
+    const int32 NumSteps = FMath::CeilToInt32(Distance / FMath::Max(MaxCollisionStepDistance, 1.0f));
+
+    return FMath::Clamp(NumSteps, 1, FMath::Min3(NumSolverSteps, MaxCollisionSubsteps, MaxSweeps));
+}
+
+
+float AVRPawn::GetWireConstraintError() const
+{
+    float MaxError = 0.0f;
+    for (int index = 0; index < 2; ++index)
+    {
+        const FWireTether& Tether = WireTether->GetSolver().GetTether(index);
+        if (Tether.bAttached)
+            MaxError = FMath::Max(MaxError, (float)FVector::Dist(GetControllerLocation(index), Tether.GetPivot()) - Tether.GetFreeLength());
+    }
+    return MaxError;
+}
 
-    // 衝突があれば
-    if (Hit.IsValidBlockingHit())
+
+int32 AVRPawn::MoveWithCollision(const FWireSolverStepResult& StepResult, float deltaTime, int32 MaxSweeps)
+{
+    WIRE_TICK_PROFILER_SCOPE(CollisionMove);
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnCollisionMove, VRPawnCollisionMove);
+
+    // 固定タイムステップが進まなかった区切りでは動かない
+    FVector Displacement = StepResult.Displacement;
+    if (Displacement.IsNearlyZero())
+        return 0;
+
+    const bool bPulling = StepResult.PullAcceleration.Size() >= StoppableSpeed;
+    const FQuat Rotation = CapsuleComponent->GetComponentQuat();
+
+    bGrounded = false;
+    bool bStopped = false;
+    FVector PrevNormal = FVector::ZeroVector;
+    int32 NumSweeps = 0;
+    for (int32 Iteration = 0; Iteration < MaxSlideIterations && NumSweeps < MaxSweeps; ++Iteration)
     {
+        FHitResult Hit;
+        MovementComponent->SafeMoveUpdatedComponent(Displacement, Rotation, true, Hit);
+        ++NumSweeps;
+
+        // 衝突がなければ移動完了
+        if (!Hit.IsValidBlockingHit())
+            break;
+
         // 接地判定
-        bGrounded = Hit.Normal.Z > SlopeSin;
+        const bool bHitGround = Hit.Normal.Z > SlopeSin;
+        bGrounded |= bHitGround;
 
         // 衝突後の速度
-        FVector newVelcity = CurrentVelocity - Hit.Normal * FVector::DotProduct(CurrentVelocity, Hit.Normal);
+        CurrentVelocity -= Hit.Normal * FVector::DotProduct(CurrentVelocity, Hit.Normal);
 
-        // 衝突対象が地面でワイヤーの巻取りがないなら停止
-        if (bGrounded && pullVelocity.Size() < StoppableSpeed)
+        // 衝突対象が地面でワイヤーの巻取りがなく、速さが規定値未満なら停止
+        if (bHitGround && !bPulling && CurrentVelocity.Size() < StoppableSpeed)
         {
-            // 速さが規定値未満なら停止
-            if (newVelcity.Size() < StoppableSpeed)
-                CurrentVelocity = FVector::ZeroVector;
-            // 規定値以上なら摩擦処理
-            else
-            {
-                // 衝突面を滑るように移動
-                MovementComponent->SlideAlongSurface(CurrentVelocity * deltaTime, 1.f - Hit.Time, Hit.Normal, Hit);
-                CurrentVelocity = newVelcity * (1 - GroundFriction * deltaTime);
-            }
-        }
-
-        // 壁面や天井は滑るように移動
-        else
-        {
-            MovementComponent->SlideAlongSurface(CurrentVelocity * deltaTime, 1.f - Hit.Time, Hit.Normal, Hit);
-            CurrentVelocity = newVelcity;
+            CurrentVelocity = FVector::ZeroVector;
+            bStopped = true;
+            break;
         }
-    }
 
+        // 残りの移動量を衝突面に沿わせる（2つの面に挟まれたら両方に沿う向きへ）
+        FVector SlideDelta = MovementComponent->ComputeSlideVector(Displacement, 1.f - Hit.Time, Hit.Normal, Hit);
+        if (Iteration > 0 && FVector::DotProduct(PrevNormal, Hit.Normal) <= 0.0f)
+            MovementComponent->TwoWallAdjust(SlideDelta, Hit, PrevNormal);
+        PrevNormal = Hit.Normal;
 
-    // 風切り音の再生
-    WindAudio->SetVolumeMultiplier(CurrentVelocity.Size() / 5000);
+        // 押し戻される向きには滑らせない
+        if (SlideDelta.IsNearlyZero() || FVector::DotProduct(SlideDelta, StepResult.Displacement) <= 0.0f)
+            break;
+        Displacement = SlideDelta;
+    }
 
+    // 地面を滑っている間は摩擦で減速
+    if (bGrounded && !bPulling && !bStopped)
+        CurrentVelocity *= FMath::Max(1.0f - GroundFriction * deltaTime, 0.0f);
 
-    // 腕の向きを調整
-    FVector StartLocation = CharacterHand_L->GetComponentLocation();
-    FVector TargetLocation = CharacterShoulder_L->GetComponentLocation();
-    FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(StartLocation, TargetLocation);
-    CharacterHand_L->SetWorldRotation(LookAtRotation);
-    StartLocation = CharacterHand_R->GetComponentLocation();
-    TargetLocation = CharacterShoulder_R->GetComponentLocation();
-    LookAtRotation = UKismetMathLibrary::FindLookAtRotation(StartLocation, TargetLocation);
-    CharacterHand_R->SetWorldRotation(LookAtRotation);
+    return NumSweeps;
 }
 
 
@@ -255,26 +1456,63 @@ void AVRPawn::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 
 void AVRPawn::CheckConnectable(int index, bool bForceUpdate)
 {
-    // マテリアルに銃の位置を受け渡し
-    FVector controllerPos = GetControllerLocation(index);
-    SplineMeshComponent[index]->SetCustomPrimitiveDataVector4(1, controllerPos);
+    WIRE_TICK_PROFILER_SCOPE(CheckConnectable);
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnCheckConnectable, VRPawnCheckConnectable);
+
+    // マテリアルに銃の見た目の位置を受け渡し
+    FVector controllerPos = GetControllerVisualLocation(index);
+    SetWireGunLocation(index, controllerPos);
+
+    // 照準用Rayを表示
+    SetWireVisibility(index, true);
 
     // コントローラーの向きでレイを飛ばしてワイヤーを接続
     FVector Start = GetControllerLocation(index);
     FVector Forward = GetControllerForward(index);
     FVector End = Start + (Forward * WireRange);
 
-    FHitResult Hit;
     FCollisionQueryParams Params;
     Params.AddIgnoredActor(this);
 
-    if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params))
+    const double Now = GetWorld()->GetTimeSeconds();
+    bool bHit = bPrevConnectable[index];
+    if (!bForceUpdate && AimCache[index].TryGet(AimCacheSettings, Start, Forward, Now, bHit))
+    {
+        // 姿勢がほぼ変わっていないので前回の結果をそのまま使う
+    }
+    else if (bUseAsyncAimTrace && !bForceUpdate && !GetAnchorIndex())
+    {
+        // 前フレームに発行したトレースの結果を反映（結果がなければ前回の状態を維持）
+        FTraceDatum Datum;
+        if (AimTraceHandle[index].IsValid() && GetWorld()->QueryTraceData(AimTraceHandle[index], Datum))
+        {
+            const FHitResult* Hit = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit ? &Datum.OutHits[0] : nullptr;
+            AimCache[index].Store(Datum.Start, (Datum.End - Datum.Start).GetSafeNormal(), Now, Hit);
+            bHit = Hit != nullptr;
+        }
+
+        // 次フレーム用のトレースを発行
+        WIRE_COUNT_TRACE();
+        AimTraceHandle[index] = GetWorld()->AsyncLineTraceByChannel(
+            EAsyncTraceType::Single, Start, End, ECC_Visibility, Params);
+    }
+    else
+    {
+        FHitResult Hit;
+        bHit = TraceAim(Start, Forward, Hit);
+        AimCache[index].Store(Start, Forward, Now, bHit ? &Hit : nullptr);
+
+        // 発行済みの非同期トレースの結果は古いので破棄
+        AimTraceHandle[index] = FTraceHandle();
+    }
+
+    if (bHit)
     {
         // 照準用Ray描画
-        SplineMeshComponent[index]->SetStartAndEnd(
+        SetWireCurve(index,
             controllerPos,
             FVector::ZeroVector,
-            Hit.ImpactPoint,
+            AimCache[index].GetHit().ImpactPoint,
             FVector::ZeroVector);
 
 
@@ -282,7 +1520,7 @@ void AVRPawn::CheckConnectable(int index, bool bForceUpdate)
         if (!bPrevConnectable[index] || bForceUpdate)
         {
             // マテリアルの切り替え
-            SplineMeshComponent[index]->SetCustomPrimitiveDataFloat(0, 1);
+            SetWireMaterialState(index, 1);
 
             // フラグ更新
             bPrevConnectable[index] = true;
@@ -291,7 +1529,7 @@ void AVRPawn::CheckConnectable(int index, bool bForceUpdate)
     else
     {
         // 照準用Ray描画
-        SplineMeshComponent[index]->SetStartAndEnd(
+        SetWireCurve(index,
             controllerPos,
             FVector::ZeroVector,
             controllerPos + GetControllerForward(index) * WireRange,
@@ -302,7 +1540,7 @@ void AVRPawn::CheckConnectable(int index, bool bForceUpdate)
         if (bPrevConnectable[index] || bForceUpdate)
         {
             // マテリアルの切り替え
-            SplineMeshComponent[index]->SetCustomPrimitiveDataFloat(0, 2);
+            SetWireMaterialState(index, 2);
 
             // フラグ更新
             bPrevConnectable[index] = false;
@@ -311,43 +1549,287 @@ void AVRPawn::CheckConnectable(int index, bool bForceUpdate)
 }
 
 
-FVector AVRPawn::UpdateWireMovement(float deltaTime)
+FWireSolverStepResult AVRPawn::UpdateWireMovement(int32 NumSteps)
+{
+    WIRE_TICK_PROFILER_SCOPE(UpdateWireMovement);
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnUpdateWireMovement, VRPawnUpdateWireMovement);
+
+    FWireSolver& WireSolver = WireTether->GetSolver();
+
+    // 各ワイヤーの根元はコントローラー位置
+    const FVector controllerPos[FWireSolver::MaxTethers]{ GetControllerLocation(0), GetControllerLocation(1) };
+
+    // ソルバーで速度を更新
+    WireSolver.SetVelocity(CurrentVelocity);
+    const FWireSolverStepResult Result = WireSolver.StepFixed(NumSteps, controllerPos);
+    CurrentVelocity = WireSolver.GetVelocity();
+
+    return Result;
+}
+
+
+void AVRPawn::UpdateWireWrap(int index)
+{
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnWireWrap, VRPawnWireWrap);
+
+    FCollisionQueryParams Params;
+    Params.AddIgnoredActor(this);
+
+    // 最後の区間（支点からコントローラーまで）だけをトレース
+    const bool bChanged = WireTether->GetSolver().UpdateWrap(index, GetControllerLocation(index),
+        [this, &Params](const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal)
+        {
+            WIRE_COUNT_TRACE();
+            FHitResult Hit;
+            if (!GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params) || Hit.bStartPenetrating)
+                return false;
+
+            OutLocation = Hit.ImpactPoint;
+            OutNormal = Hit.ImpactNormal;
+            return true;
+        });
+
+    const FWireTether& Tether = WireTether->GetSolver().GetTether(index);
+    INC_DWORD_STAT_BY(STAT_WireWrapPoints, Tether.WrapPoints.Num());
+
+    if (bChanged && !bReplayingMoves)
+    {
+        // 支点が変わったのでロープを張り直す
+        if (bUseRopeSimulation)
+            WireRope[index].Attach(GetControllerLocation(index), Tether.GetPivot(), Tether.GetFreeLength());
+
+        UpdateWrapSegments();
+    }
+}
+
+
+void AVRPawn::UpdateWrapSegments()
+{
+    if (CosmeticSignificance == EWireCosmeticSignificance::Culled)
+        return;
+
+    int32 NumUsed = 0;
+    for (int index = 0; index < 2; ++index)
+    {
+        const FWireTether& Tether = WireTether->GetSolver().GetTether(index);
+        if (!Tether.bAttached)
+            continue;
+
+        // アンカーから巻き付き点を順につなぐ
+        FVector SegmentStart = Tether.Anchor;
+        for (const FWireWrapPoint& WrapPoint : Tether.WrapPoints)
+        {
+            if (WireBatch)
+            {
+                // 一括描画ではハンドルを必要な分だけ追加して使い回す
+                if (!WrapSegmentWires.IsValidIndex(NumUsed))
+                    WrapSegmentWires.Add(WireBatch->AddWire());
+
+                const int32 Handle = WrapSegmentWires[NumUsed++];
+                WireBatch->SetWireState(Handle, 0);
+                WireBatch->SetWireOrigin(Handle, GetControllerVisualLocation(index));
+                WireBatch->SetWireCurve(Handle, SegmentStart, FVector::ZeroVector, WrapPoint.Location, FVector::ZeroVector);
+                WireBatch->SetWireVisible(Handle, true);
+
+                SegmentStart = WrapPoint.Location;
+                continue;
+            }
+
+            if (!WrapSegmentMesh.IsValidIndex(NumUsed))
+            {
+                // ワイヤーと同じ見た目の Spline Mesh を作成
+                USplineMeshComponent* NewSegment = NewObject<USplineMeshComponent>(this);
+                NewSegment->SetMobility(EComponentMobility::Movable);
+                NewSegment->SetStaticMesh(SplineMeshComponent[0]->GetStaticMesh());
+                NewSegment->SetMaterial(0, SplineMeshComponent[0]->GetMaterial(0));
+                NewSegment->SetStartScale(FVector2D::UnitVector * 0.005);
+                NewSegment->SetEndScale(FVector2D::UnitVector * 0.005);
+                NewSegment->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+                NewSegment->CastShadow = false;
+                NewSegment->RegisterComponent();
+                WrapSegmentMesh.Add(NewSegment);
+            }
+
+            USplineMeshComponent* Segment = WrapSegmentMesh[NumUsed++];
+            Segment->SetCustomPrimitiveDataFloat(0, 0);
+            Segment->SetCustomPrimitiveDataVector4(1, GetControllerVisualLocation(index));
+            Segment->SetStartAndEnd(SegmentStart, FVector::ZeroVector, WrapPoint.Location, FVector::ZeroVector);
+            Segment->SetVisibility(true);
+
+            SegmentStart = WrapPoint.Location;
+        }
+    }
+
+    // 使っていない区間は非表示
+    if (WireBatch)
+    {
+        for (int32 i = NumUsed; i < WrapSegmentWires.Num(); ++i)
+            WireBatch->SetWireVisible(WrapSegmentWires[i], false);
+        return;
+    }
+    for (int32 i = NumUsed; i < WrapSegmentMesh.Num(); ++i)
+    {
+        WrapSegmentMesh[i]->SetVisibility(false);
+    }
+}
+
+
+void AVRPawn::SetWireCurve(int index, const FVector& Start, const FVector& StartTangent, const FVector& End, const FVector& EndTangent)
+{
+    if (WireBatch)
+        WireBatch->SetWireCurve(WireBatchHandle[index], Start, StartTangent, End, EndTangent);
+    else
+        SplineMeshComponent[index]->SetStartAndEnd(Start, StartTangent, End, EndTangent);
+}
+
+
+void AVRPawn::SetWireMaterialState(int index, float State)
+{
+    if (WireBatch)
+        WireBatch->SetWireState(WireBatchHandle[index], State);
+    else
+        SplineMeshComponent[index]->SetCustomPrimitiveDataFloat(0, State);
+}
+
+
+void AVRPawn::SetWireGunLocation(int index, const FVector& Location)
+{
+    if (WireBatch)
+        WireBatch->SetWireOrigin(WireBatchHandle[index], Location);
+    else
+        SplineMeshComponent[index]->SetCustomPrimitiveDataVector4(1, Location);
+}
+
+
+void AVRPawn::SetWireVisibility(int index, bool bVisible)
+{
+    if (WireBatch)
+        WireBatch->SetWireVisible(WireBatchHandle[index], bVisible);
+    else
+        SplineMeshComponent[index]->SetVisibility(bVisible);
+}
+
+
+void AVRPawn::SimulateWireRope(int index, float deltaTime)
 {
-    // 変数格納
-    TArray < FVector > controllerPos{ GetControllerLocation(0), GetControllerLocation(1) };
-    TArray < FVector > toAnchor{ StaticAnchorLocation[0] - controllerPos[0], StaticAnchorLocation[1] - controllerPos[1] };
-    TArray<float> distance{ (float)toAnchor[0].Size(), (float)toAnchor[1].Size() };
-    TArray < FVector > direction{ toAnchor[0].GetSafeNormal(), toAnchor[1].GetSafeNormal() };
+    // 接続中か、切断後の巻き戻し中のみロープを進める（ゲームスレッドの Tick の最後に写した値だけを読む）
+    const FRopeInput& Input = RopeInput[index];
+    FWireRope& Rope = WireRope[index];
+    if (!Input.bAttached && !Rope.IsRecoiling())
+        return;
+
+    {
+        WIRE_SCOPE_CYCLE_COUNTER(STAT_WireRopeSimulate, RopeSimulate);
+        Rope.Simulate(deltaTime, Input.HandLocation, Input.Pivot, Input.FreeLength);
+    }
+
+    if (Rope.IsActive())
+        INC_DWORD_STAT_BY(STAT_WireRopeParticles, Rope.GetNumParticles());
+    else
+        bRopeRecoilFinished[index] = true;
+}
+
 
-    // 引き寄せ速度を定義
-    FVector pullVelocity = FVector::ZeroVector;
+void AVRPawn::UpdateWireVisual(int index)
+{
+    const FWireTether& Tether = WireTether->GetSolver().GetTether(index);
 
-    // ワイヤー処理
-    if (bWireAttached[0] && distance[0] > CurrentWireLength[0])
+    if (!bUseRopeSimulation)
     {
-        // ワイヤー方向の速度を取得
-        float dotProduct = FVector::DotProduct(CurrentVelocity, direction[0]);
+        // 直線で描画（巻き付いていれば最後の巻き付き点まで）
+        if (Tether.bAttached)
+            SetWireCurve(index,
+                GetControllerVisualLocation(index), FVector::ZeroVector,
+                Tether.GetPivot(), FVector::ZeroVector
+            );
+        return;
+    }
 
-        // 外方向の速度を打ち消し
-        if (dotProduct < 0)
-            CurrentVelocity -= (direction[0] * dotProduct);
+    FWireRope& Rope = WireRope[index];
+    if (bRopeRecoilFinished[index])
+    {
+        bRopeRecoilFinished[index] = false;
 
-        // 引き寄せ速度の加算
-        pullVelocity += direction[0] * (distance[0] - CurrentWireLength[0]) * 300;
+        // 巻き戻しが終わったので照準用Rayの描画へ戻す（他プレイヤーは非表示）
+        if (!Rope.IsActive())
+        {
+            if (IsLocallySimulated())
+                CheckConnectable(index, true);
+            else
+                SetWireVisibility(index, false);
+            return;
+        }
     }
-    // 右も同様に
-    if (bWireAttached[1] && distance[1] > CurrentWireLength[1])
+
+    if (!Rope.IsActive())
+        return;
+
+    // ロープの形を1区間のスプラインで近似
+    FVector StartPos, StartTangent, EndPos, EndTangent;
+    Rope.GetHermite(StartPos, StartTangent, EndPos, EndTangent);
+    SetWireCurve(index, StartPos, StartTangent, EndPos, EndTangent);
+}
+
+
+void AVRPawn::UpdateTrajectoryPreview()
+{
+    WIRE_TICK_PROFILER_SCOPE(TrajectoryPreview);
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireVRPawnTrajectoryPreview, VRPawnTrajectoryPreview);
+
+    // 接続していない手の照準先を予測する（予測中の手を優先し、両手なら右手）
+    auto IsAiming = [this](int32 i)
     {
-        float dotProduct = FVector::DotProduct(CurrentVelocity, direction[1]);
+        return i != INDEX_NONE && bPrevConnectable[i] && !WireTether->GetSolver().GetTether(i).bAttached && !WireRope[i].IsRecoiling();
+    };
+    const int32 CurrentIndex = TrajectoryPreview.GetTargetIndex();
+    const int32 Index = IsAiming(CurrentIndex) ? CurrentIndex : IsAiming(1) ? 1 : IsAiming(0) ? 0 : INDEX_NONE;
 
-        if (dotProduct < 0)
-            CurrentVelocity -= (direction[1] * dotProduct);
+    if (Index == INDEX_NONE)
+    {
+        // 照準先がなくなったら消す
+        if (CurrentIndex != INDEX_NONE)
+        {
+            TrajectoryPreview.Reset();
+            TrajectoryLine->Flush();
+        }
+        return;
+    }
 
-        pullVelocity += direction[1] * (distance[1] - CurrentWireLength[1]) * 300;
+    // 完了したら現在の状態から予測し直す（照準先が大きく動いた時は途中でもやり直す）
+    const FVector& Anchor = AimCache[Index].GetHit().ImpactPoint;
+    if (!TrajectoryPreview.IsRunning() || Index != CurrentIndex
+        || FVector::DistSquared(Anchor, TrajectoryPreview.GetTargetAnchor()) > FMath::Square(TrajectoryRestartDistance))
+    {
+        const FVector controllerPos[FWireSolver::MaxTethers]{ GetControllerLocation(0), GetControllerLocation(1) };
+        TrajectoryPreview.Begin(WireTether->GetSolver(), Index, Anchor, GetActorLocation(), CurrentVelocity, controllerPos);
     }
 
-    // 引き寄せ速度を返す
-    return pullVelocity;
+    FCollisionQueryParams Params;
+    Params.AddIgnoredActor(this);
+
+    // 衝突判定は区間ごとのレイ1本だけ
+    const bool bCompleted = TrajectoryPreview.Advance(
+        [this, &Params](const FVector& Start, const FVector& End, FVector& OutLocation)
+        {
+            WIRE_COUNT_TRACE();
+            FHitResult Hit;
+            if (!GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params))
+                return false;
+
+            OutLocation = Hit.Location;
+            return true;
+        });
+    if (!bCompleted)
+        return;
+
+    // 描き直すのは予測が完了した時だけ
+    const FWireTrajectoryPreviewSettings& Settings = TrajectoryPreview.GetSettings();
+    const TArrayView<const FVector> Points = TrajectoryPreview.GetResult();
+    TrajectoryLine->Flush();
+    for (int32 i = 1; i < Points.Num(); ++i)
+    {
+        TrajectoryLine->DrawLine(Points[i - 1], Points[i], Settings.LineColor, SDPG_World, Settings.LineThickness);
+    }
 }
 
 
@@ -358,6 +1840,13 @@ FVector AVRPawn::GetControllerLocation(int index) const
 }
 
 
+//描画用のコントローラー位置を取得（補間・補正のずれを含む）
+FVector AVRPawn::GetControllerVisualLocation(int index) const
+{
+    return GetControllerLocation(index) + VisualOffset;
+}
+
+
 //コントローラー正面方向を取得
 FVector AVRPawn::GetControllerForward(int index) const
 {
@@ -365,10 +1854,50 @@ FVector AVRPawn::GetControllerForward(int index) const
 }
 
 
+//照準用レイでワイヤーの接続先を探す
+bool AVRPawn::TraceAim(const FVector& Start, const FVector& Forward, FHitResult& OutHit)
+{
+    // 接続先の索引があればそちらで検索（照準アシスト付き）
+    if (UWireAnchorSubsystem* AnchorIndex = GetAnchorIndex())
+    {
+        return AnchorIndex->FindAnchor(Start, Forward, WireRange, AimAssistAngle, OutHit, this);
+    }
+
+    FCollisionQueryParams Params;
+    Params.AddIgnoredActor(this);
+
+    WIRE_COUNT_TRACE();
+    return GetWorld()->LineTraceSingleByChannel(OutHit, Start, Start + Forward * WireRange, ECC_Visibility, Params);
+}
+
+
+//接続先の索引を取得
+UWireAnchorSubsystem* AVRPawn::GetAnchorIndex() const
+{
+    return bUseAnchorIndex ? GetWorld()->GetSubsystem<UWireAnchorSubsystem>() : nullptr;
+}
+
+
+//照準キャッシュの利用回数を取得
+void AVRPawn::GetAimCacheCounters(uint32& OutHits, uint32& OutMisses) const
+{
+    OutHits = AimCache[0].GetHitCount() + AimCache[1].GetHitCount();
+    OutMisses = AimCache[0].GetMissCount() + AimCache[1].GetMissCount();
+}
+
+
+// サーバーで実行した入力と補正の数を取得
+void AVRPawn::GetServerMoveCounters(uint32& OutMoves, uint32& OutCorrections) const
+{
+    OutMoves = NumServerMoves;
+    OutCorrections = NumServerCorrections;
+}
+
+
 // ワイヤー接続の切り替え
 void AVRPawn::ToggleWire(int index)
 {
-    if (bWireAttached[index])
+    if (WireTether->GetSolver().GetTether(index).bAttached)
     {
         DetachWire(index);
     }
@@ -379,42 +1908,61 @@ void AVRPawn::ToggleWire(int index)
 }
 void AVRPawn::ToggleWire_L()
 {
-    ToggleWire(0);
+    PendingMoveFlags ^= (uint8)EVRPawnMoveFlags::WantsWire_L;
 }
 void AVRPawn::ToggleWire_R()
 {
-    ToggleWire(1);
+    PendingMoveFlags ^= (uint8)EVRPawnMoveFlags::WantsWire_R;
+}
+
+
+// 接続しておきたい状態を今の接続状態に合わせる（接続できなかった・切れた時に繰り返さないよう移動の後に呼ぶ）
+void AVRPawn::SyncWantsWireFlags()
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        if (WireTether->GetSolver().GetTether(i).bAttached)
+            PendingMoveFlags |= (uint8)VRPawnWantsWireFlag(i);
+        else
+            PendingMoveFlags &= ~(uint8)VRPawnWantsWireFlag(i);
+    }
 }
 
 
 // ワイヤー接続
 void AVRPawn::AttachWire(int index)
 {
+    FWireSolver& WireSolver = WireTether->GetSolver();
+
     // コントローラーの向きでレイを飛ばしてワイヤーを接続
     FVector Start = GetControllerLocation(index);
     FVector Forward = GetControllerForward(index);
-    FVector End = Start + (Forward * WireRange);
-
-    FHitResult Hit;
-    FCollisionQueryParams Params;
-    Params.AddIgnoredActor(this);
 
-    if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params))
+    // 照準のキャッシュが新しければトレースせずにその位置へ接続
+    const double Now = GetWorld()->GetTimeSeconds();
+    bool bHit = false;
+    if (!AimCache[index].TryGet(AimCacheSettings, Start, Forward, Now, bHit) || !bHit)
     {
-        // 接続フラグを立てる
-        bWireAttached[index] = true;
+        FHitResult Hit;
+        bHit = TraceAim(Start, Forward, Hit);
+        AimCache[index].Store(Start, Forward, Now, bHit ? &Hit : nullptr);
+    }
 
-        // 接続位置を記憶
-        StaticAnchorLocation[index] = Hit.ImpactPoint;
+    if (bHit)
+    {
+        // 接続位置と接続時のワイヤー長を記憶
+        WireSolver.Attach(index, AimCache[index].GetHit().ImpactPoint, GetControllerLocation(index));
+        // 入力の再生中は見た目を変えない（再生後に SyncWireVisual で合わせる）
+        if (bReplayingMoves)
+            return;
 
-        // 接続時にワイヤー長を現在の距離に設定
-        CurrentWireLength[index] = FVector::Dist(GetControllerLocation(index), StaticAnchorLocation[index]);
+        if (bUseRopeSimulation)
+            WireRope[index].Attach(GetControllerLocation(index), WireSolver.GetTether(index).Anchor, WireSolver.GetTether(index).CurrentLength);
 
         // マテリアルの切り替え
-        SplineMeshComponent[index]->SetCustomPrimitiveDataFloat(0, 0);
+        SetWireMaterialState(index, 0);
 
-        // 接続時の長さを記憶
-        AttachWireLength[index] = CurrentWireLength[index];
+        WireStats::RecordAttach(GetWorld());
 
         // 効果音の再生
         WireAttachAudio->Stop();
@@ -427,7 +1975,21 @@ void AVRPawn::AttachWire(int index)
 void AVRPawn::DetachWire(int index)
 {
     // 接続フラグを下ろす
-    bWireAttached[index] = false;
+    const bool bWasWrapped = WireTether->GetSolver().GetTether(index).WrapPoints.Num() > 0;
+    WireTether->GetSolver().Detach(index);
+
+    // 入力の再生中は見た目を変えない（再生後に SyncWireVisual で合わせる）
+    if (bReplayingMoves)
+        return;
+
+    // 巻き付いていた区間を消す
+    if (bWasWrapped)
+        UpdateWrapSegments();
+
+    // ロープをしならせながら巻き戻す（照準表示への切り替えは巻き戻し後）
+    WireRope[index].Release();
+    if (WireRope[index].IsRecoiling())
+        return;
 
     // マテリアルの切り替え
     CheckConnectable(index, true);
@@ -435,32 +1997,29 @@ void AVRPawn::DetachWire(int index)
 
 
 // ワイヤーを巻き取る
-void AVRPawn::RetractWire(int index)
+void AVRPawn::RetractWire(int index, float deltaTime)
 {
-    if (bWireAttached[index])
+    if (WireTether->GetSolver().GetTether(index).bAttached)
     {
-        // アンカーまでの距離を算出
-        float distance = (StaticAnchorLocation[index] - GetControllerLocation(index)).Size();
-
-        // ワイヤーの長さを更新
-        CurrentWireLength[index] =
-            FMath::Clamp(distance - RetractSpeed * GetWorld()->GetDeltaSeconds(), 100, WireRange);
+        // アンカーまでの距離を基準にワイヤーの長さを更新
+        const float lengthRate = WireTether->GetSolver().ReelWire(
+            index, GetControllerLocation(index), -RetractSpeed * deltaTime, 100, WireRange);
 
         // ワイヤー切断条件までワイヤーを巻き取っていたら切断
-        if (CurrentWireLength[index] / AttachWireLength[index] < DetachRate)
+        if (lengthRate < DetachRate)
         {
-            UE_LOG(LogTemp, Log, TEXT("Detach"));
+            UE_LOG(LogWire, Verbose, TEXT("Detach"));
             DetachWire(index);
         }
     }
 }
 void AVRPawn::RetractWire_L()
 {
-    RetractWire(0);
+    PendingMoveFlags |= (uint8)EVRPawnMoveFlags::RetractWire_L;
 }
 void AVRPawn::RetractWire_R()
 {
-    RetractWire(1);
+    PendingMoveFlags |= (uint8)EVRPawnMoveFlags::RetractWire_R;
 }
 
 
@@ -481,13 +2040,18 @@ void AVRPawn::NotifyControllerChanged()
 
 /* 開発用 */
 void AVRPawn::Move(const FInputActionValue& Value)
+{
+    // 次の PerformMove で反映
+    PendingMoveFlags |= (uint8)EVRPawnMoveFlags::Move;
+    PendingMoveInput = Value.Get<FVector2D>();
+}
+
+
+void AVRPawn::ApplyMoveInput(const FVector2D& MovementVector)
 {
     // 接地状態でなければ移動不可
     if (!bGrounded || CurrentVelocity.Z > JumpZSpeed - 10) return;
 
-    // input is a Vector2D
-    FVector2D MovementVector = Value.Get<FVector2D>();
-
     if (MotionController[0] != nullptr)
     {
         // get forward vector
@@ -519,6 +2083,13 @@ void AVRPawn::Move(const FInputActionValue& Value)
 
 
 void AVRPawn::Jump(const FInputActionValue& Value)
+{
+    // 次の PerformMove で反映
+    PendingMoveFlags |= (uint8)EVRPawnMoveFlags::Jump;
+}
+
+
+void AVRPawn::ApplyJump()
 {
     // 接地状態のみジャンプ可能
     if (bGrounded)
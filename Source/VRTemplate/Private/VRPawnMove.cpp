@@ -0,0 +1,94 @@
+﻿#include "VRPawnMove.h"
+#include "WireNetSerialization.h"
+
+namespace
+{
+    // 1本のワイヤーが送る巻き付き点の上限（4bit）
+    constexpr uint32 MaxNetWrapPoints = 15;
+
+    // コントローラーの角度の許容差（16bit 圧縮の1段階）
+    constexpr float HandRotationTolerance = 360.0f / 65536.0f;
+}
+
+
+bool FVRPawnNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+
+    Ar << TimeStamp;
+    bOutSuccess &= SerializePackedVector<100, 30>(Location, Ar);
+    bOutSuccess &= SerializePackedVector<10, 24>(Velocity, Ar);
+
+    for (int32 i = 0; i < 2; ++i)
+    {
+        FVRPawnTetherState& Tether = Tethers[i];
+
+        // 未接続なら 1bit のみ
+        WireNetSerialization::SerializeBit(Ar, Tether.bAttached);
+        if (Tether.bAttached)
+        {
+            bOutSuccess &= WireNetSerialization::SerializeRelativeLocation(Ar, Tether.Anchor, Location);
+            WireNetSerialization::SerializeLength(Ar, Tether.CurrentLength);
+            WireNetSerialization::SerializeLength(Ar, Tether.AttachLength);
+
+            // 巻き付き点も Pawn の位置からの相対座標
+            uint32 NumWrapPoints = (uint32)FMath::Min(FMath::Min(Tether.WrapLocations.Num(), Tether.WrapBendAxes.Num()), (int32)MaxNetWrapPoints);
+            Ar.SerializeInt(NumWrapPoints, MaxNetWrapPoints + 1);
+            if (Ar.IsLoading())
+            {
+                Tether.WrapLocations.SetNum(NumWrapPoints);
+                Tether.WrapBendAxes.SetNum(NumWrapPoints);
+            }
+            for (uint32 k = 0; k < NumWrapPoints; ++k)
+            {
+                bOutSuccess &= WireNetSerialization::SerializeRelativeLocation(Ar, Tether.WrapLocations[k], Location);
+                bOutSuccess &= SerializeFixedVector<1, 16>(Tether.WrapBendAxes[k], Ar);
+            }
+        }
+        else if (Ar.IsLoading())
+        {
+            Tether = FVRPawnTetherState();
+        }
+
+        // コントローラーは Pawn からの相対なので値が小さく短いビット数で済む
+        bOutSuccess &= SerializePackedVector<100, 30>(HandLocation[i], Ar);
+        HandRotation[i].SerializeCompressedShort(Ar);
+    }
+
+    return true;
+}
+
+
+bool FVRPawnNetState::operator==(const FVRPawnNetState& Other) const
+{
+    if (!Location.Equals(Other.Location, 0.01f) || !Velocity.Equals(Other.Velocity, WireNetSerialization::LocationTolerance))
+        return false;
+
+    for (int32 i = 0; i < 2; ++i)
+    {
+        const FVRPawnTetherState& A = Tethers[i];
+        const FVRPawnTetherState& B = Other.Tethers[i];
+        if (A.bAttached != B.bAttached)
+            return false;
+
+        if (A.bAttached)
+        {
+            if (!A.Anchor.Equals(B.Anchor, WireNetSerialization::LocationTolerance)
+                || !WireNetSerialization::IsSameLength(A.CurrentLength, B.CurrentLength)
+                || !WireNetSerialization::IsSameLength(A.AttachLength, B.AttachLength)
+                || A.WrapLocations.Num() != B.WrapLocations.Num())
+                return false;
+
+            for (int32 k = 0; k < A.WrapLocations.Num(); ++k)
+            {
+                if (!A.WrapLocations[k].Equals(B.WrapLocations[k], WireNetSerialization::LocationTolerance))
+                    return false;
+            }
+        }
+
+        if (!HandLocation[i].Equals(Other.HandLocation[i], 0.01f)
+            || !HandRotation[i].Equals(Other.HandRotation[i], HandRotationTolerance))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+﻿#include "VRPawnTickFunction.h"
+#include "VRPawn.h"
+
+
+void FVRPawnCosmeticTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (IsValid(Target) && TickType != LEVELTICK_ViewportsOnly)
+        Target->TickCosmetic(DeltaTime);
+}
+
+
+FString FVRPawnCosmeticTickFunction::DiagnosticMessage()
+{
+    return Target ? Target->GetFullName() + TEXT("[TickCosmetic]") : TEXT("<NULL>[TickCosmetic]");
+}
+
+
+FName FVRPawnCosmeticTickFunction::DiagnosticContext(bool bDetailed)
+{
+    return Target ? Target->GetClass()->GetFName() : NAME_None;
+}
+
+
+void FVRPawnRopeTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (IsValid(Target) && TickType != LEVELTICK_ViewportsOnly)
+        Target->TickRopeSimulation(DeltaTime);
+}
+
+
+FString FVRPawnRopeTickFunction::DiagnosticMessage()
+{
+    return Target ? Target->GetFullName() + TEXT("[TickRopeSimulation]") : TEXT("<NULL>[TickRopeSimulation]");
+}
+
+
+FName FVRPawnRopeTickFunction::DiagnosticContext(bool bDetailed)
+{
+    return Target ? Target->GetClass()->GetFName() : NAME_None;
+}
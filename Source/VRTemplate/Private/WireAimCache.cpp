@@ -0,0 +1,59 @@
+﻿#include "WireAimCache.h"
+#include "Components/PrimitiveComponent.h"
+#include "WireStats.h"
+
+
+bool FWireAimCache::TryGet(const FWireAimCacheSettings& Settings, const FVector& InOrigin, const FVector& InDirection, double InTime, bool& bOutHit)
+{
+    // 姿勢の変化と経過時間が閾値内なら再利用
+    const bool bReusable = Settings.bEnabled
+        && bValid
+        && InTime - Time <= Settings.MaxAge
+        && FVector::DistSquared(InOrigin, Origin) <= FMath::Square(Settings.PositionTolerance)
+        && FVector::DotProduct(InDirection, Direction) >= FMath::Cos(FMath::DegreesToRadians(Settings.AngleTolerance))
+        && (!bHit || IsHitStillValid());
+
+    if (!bReusable)
+    {
+        ++MissCount;
+        return false;
+    }
+
+    ++HitCount;
+    INC_DWORD_STAT(STAT_WireAimCacheHits);
+    bOutHit = bHit;
+    return true;
+}
+
+
+void FWireAimCache::Store(const FVector& InOrigin, const FVector& InDirection, double InTime, const FHitResult* InHit)
+{
+    bValid = true;
+    bHit = InHit != nullptr;
+    Origin = InOrigin;
+    Direction = InDirection;
+    Time = InTime;
+
+    if (InHit)
+    {
+        Hit = *InHit;
+        HitComponent = InHit->GetComponent();
+        HitComponentLocation = HitComponent.IsValid() ? HitComponent->GetComponentLocation() : FVector::ZeroVector;
+    }
+    else
+    {
+        HitComponent.Reset();
+    }
+}
+
+
+bool FWireAimCache::IsHitStillValid() const
+{
+    const UPrimitiveComponent* Component = HitComponent.Get();
+    if (!Component)
+        return false;
+
+    // Static なら動かないのでそのまま有効、Movable なら位置が変わっていないか確認
+    return Component->Mobility == EComponentMobility::Static
+        || Component->GetComponentLocation().Equals(HitComponentLocation, 0.1);
+}
@@ -0,0 +1,406 @@
+﻿#include "WireAnchorSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "WireStats.h"
+
+namespace WireAnchorIndex
+{
+    // レイと AABB の交差判定（スラブ法）。OutT はレイが箱に入る距離
+    bool IntersectRayBox(const FVector& Start, const FVector& InvDirection, const FBox& Box, float MaxT, float& OutT)
+    {
+        float TMin = 0.0f;
+        float TMax = MaxT;
+        for (int32 Axis = 0; Axis < 3; ++Axis)
+        {
+            float T0 = (Box.Min[Axis] - Start[Axis]) * InvDirection[Axis];
+            float T1 = (Box.Max[Axis] - Start[Axis]) * InvDirection[Axis];
+            if (T0 > T1)
+                Swap(T0, T1);
+
+            TMin = FMath::Max(TMin, T0);
+            TMax = FMath::Min(TMax, T1);
+            if (TMin > TMax)
+                return false;
+        }
+        OutT = TMin;
+        return true;
+    }
+
+    FVector SafeInverse(const FVector& Direction)
+    {
+        return FVector(
+            FMath::IsNearlyZero(Direction.X) ? UE_BIG_NUMBER : 1.0 / Direction.X,
+            FMath::IsNearlyZero(Direction.Y) ? UE_BIG_NUMBER : 1.0 / Direction.Y,
+            FMath::IsNearlyZero(Direction.Z) ? UE_BIG_NUMBER : 1.0 / Direction.Z);
+    }
+}
+
+
+bool UWireAnchorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UWireAnchorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    // ストリーミングでレベルが増減したらそのレベルの分だけ登録・削除する
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UWireAnchorSubsystem::OnLevelAdded);
+    LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UWireAnchorSubsystem::OnLevelRemoved);
+}
+
+
+void UWireAnchorSubsystem::Deinitialize()
+{
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+    Super::Deinitialize();
+}
+
+
+void UWireAnchorSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    Rebuild();
+}
+
+
+void UWireAnchorSubsystem::OnLevelAdded(ULevel* Level, UWorld* InWorld)
+{
+    // 未作成なら最初の検索でまとめて作る
+    if (InWorld != GetWorld() || !bBuilt || !Level)
+        return;
+
+    // 再追加に備えて以前の分を消してから登録する
+    const TObjectKey<ULevel> LevelKey(Level);
+    Entries.RemoveAll([LevelKey](const FAnchorEntry& Entry) { return Entry.Level == LevelKey; });
+    for (AActor* Actor : Level->Actors)
+    {
+        if (Actor)
+            AddActorEntries(Actor);
+    }
+    bCellsDirty = true;
+}
+
+
+void UWireAnchorSubsystem::OnLevelRemoved(ULevel* Level, UWorld* InWorld)
+{
+    if (InWorld != GetWorld() || !bBuilt)
+        return;
+
+    // レベルの指定がなければ全て外れたので作り直す
+    if (!Level)
+    {
+        bBuilt = false;
+        return;
+    }
+
+    const TObjectKey<ULevel> LevelKey(Level);
+    if (Entries.RemoveAll([LevelKey](const FAnchorEntry& Entry) { return Entry.Level == LevelKey; }) > 0)
+        bCellsDirty = true;
+}
+
+
+void UWireAnchorSubsystem::Rebuild()
+{
+    Entries.Reset();
+
+    // 登録するコンポーネントを収集
+    for (TActorIterator<AActor> It(GetWorld()); It; ++It)
+    {
+        AddActorEntries(*It);
+    }
+
+    BuildCells();
+    bBuilt = true;
+}
+
+
+void UWireAnchorSubsystem::AddActorEntries(AActor* Actor)
+{
+    const TObjectKey<ULevel> LevelKey(Actor->GetLevel());
+    for (UActorComponent* ActorComponent : Actor->GetComponents())
+    {
+        UPrimitiveComponent* Component = Cast<UPrimitiveComponent>(ActorComponent);
+        if (Component && IsGrappable(Component))
+        {
+            Entries.Add({ Component->Bounds.GetBox(), Component, LevelKey });
+        }
+    }
+}
+
+
+void UWireAnchorSubsystem::BuildCells()
+{
+    Cells.Reset();
+    CellEntries.Reset();
+    LargeEntries.Reset();
+
+    // 各登録物が重なるセルとの組を作り、セル順に並べて詰める
+    TArray<TPair<FIntVector, int32>> CellPairs;
+    for (int32 i = 0; i < Entries.Num(); ++i)
+    {
+        const FIntVector Min = ToCell(Entries[i].Bounds.Min);
+        const FIntVector Max = ToCell(Entries[i].Bounds.Max);
+        const int64 NumCells = int64(Max.X - Min.X + 1) * (Max.Y - Min.Y + 1) * (Max.Z - Min.Z + 1);
+        if (NumCells > MaxCellsPerEntry)
+        {
+            LargeEntries.Add(i);
+            continue;
+        }
+
+        for (int32 X = Min.X; X <= Max.X; ++X)
+            for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+                for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+                    CellPairs.Emplace(FIntVector(X, Y, Z), i);
+    }
+
+    CellPairs.Sort([](const TPair<FIntVector, int32>& A, const TPair<FIntVector, int32>& B)
+    {
+        if (A.Key.X != B.Key.X) return A.Key.X < B.Key.X;
+        if (A.Key.Y != B.Key.Y) return A.Key.Y < B.Key.Y;
+        return A.Key.Z < B.Key.Z;
+    });
+
+    CellEntries.Reserve(CellPairs.Num());
+    for (const TPair<FIntVector, int32>& Pair : CellPairs)
+    {
+        FCellRange& Range = Cells.FindOrAdd(Pair.Key, FCellRange{ CellEntries.Num(), 0 });
+        ++Range.Num;
+        CellEntries.Add(Pair.Value);
+    }
+    CellEntries.Shrink();
+
+    VisitStamps.Init(0, Entries.Num());
+    CurrentStamp = 0;
+    bCellsDirty = false;
+
+    UE_LOG(LogWire, Log, TEXT("WireAnchorSubsystem: %d anchors in %d cells (%d large)"), Entries.Num(), Cells.Num(), LargeEntries.Num());
+}
+
+
+bool UWireAnchorSubsystem::IsGrappable(const UPrimitiveComponent* Component) const
+{
+    if (!Component->IsRegistered() || !Component->IsCollisionEnabled() || Component->Mobility != EComponentMobility::Static)
+        return false;
+
+    if (Component->GetCollisionResponseToChannel(ECC_Visibility) != ECR_Block)
+        return false;
+
+    const AActor* Owner = Component->GetOwner();
+    if (Component->ComponentHasTag(NoGrappleTag) || (Owner && Owner->ActorHasTag(NoGrappleTag)))
+        return false;
+
+    // インスタンスメッシュ（フォリッジなど）はタグがある場合のみ
+    const bool bTagged = Component->ComponentHasTag(GrappableTag) || (Owner && Owner->ActorHasTag(GrappableTag));
+    if ((bRequireGrappableTag || Component->IsA<UInstancedStaticMeshComponent>()) && !bTagged)
+        return false;
+
+    // 小物は除外
+    return bTagged || Component->Bounds.BoxExtent.GetMax() >= MinSurfaceExtent;
+}
+
+
+FIntVector UWireAnchorSubsystem::ToCell(const FVector& Location) const
+{
+    return FIntVector(
+        FMath::FloorToInt32(Location.X / CellSize),
+        FMath::FloorToInt32(Location.Y / CellSize),
+        FMath::FloorToInt32(Location.Z / CellSize));
+}
+
+
+bool UWireAnchorSubsystem::MarkVisited(int32 EntryIndex)
+{
+    if (VisitStamps[EntryIndex] == CurrentStamp)
+        return false;
+
+    VisitStamps[EntryIndex] = CurrentStamp;
+    return true;
+}
+
+
+bool UWireAnchorSubsystem::TraceEntry(int32 EntryIndex, const FVector& Start, const FVector& End, FHitResult& OutHit) const
+{
+    UPrimitiveComponent* Component = Entries[EntryIndex].Component.Get();
+    return Component && Component->LineTraceComponent(OutHit, Start, End, FCollisionQueryParams(SCENE_QUERY_STAT(WireAnchorTrace)));
+}
+
+
+bool UWireAnchorSubsystem::FindAnchorAlongRay(const FVector& Start, const FVector& Direction, float MaxDistance, FHitResult& OutHit)
+{
+    if (!bBuilt)
+        Rebuild();
+    else if (bCellsDirty)
+        BuildCells();
+
+    ++CurrentStamp;
+
+    const FVector InvDirection = WireAnchorIndex::SafeInverse(Direction);
+    const FVector End = Start + Direction * MaxDistance;
+    float BestDistance = MaxDistance;
+    bool bFound = false;
+
+    // 登録物の箱にレイが入るなら正確なトレースで確かめ、最も近いものを残す
+    auto TestEntry = [&](int32 EntryIndex)
+    {
+        float EnterT;
+        if (!MarkVisited(EntryIndex) || !WireAnchorIndex::IntersectRayBox(Start, InvDirection, Entries[EntryIndex].Bounds, BestDistance, EnterT))
+            return;
+
+        FHitResult Hit;
+        if (!TraceEntry(EntryIndex, Start, End, Hit))
+            return;
+
+        const float Distance = FVector::Dist(Start, Hit.ImpactPoint);
+        if (Distance < BestDistance)
+        {
+            BestDistance = Distance;
+            OutHit = Hit;
+            bFound = true;
+        }
+    };
+
+    for (int32 EntryIndex : LargeEntries)
+    {
+        TestEntry(EntryIndex);
+    }
+
+    // 3D-DDA でレイが通るセルを手前から順に辿る
+    FIntVector Cell = ToCell(Start);
+    FIntVector Step;
+    FVector TMax;
+    FVector TDelta;
+    for (int32 Axis = 0; Axis < 3; ++Axis)
+    {
+        Step[Axis] = Direction[Axis] >= 0.0 ? 1 : -1;
+        const double Boundary = (Cell[Axis] + (Step[Axis] > 0 ? 1 : 0)) * CellSize;
+        TMax[Axis] = FMath::IsNearlyZero(Direction[Axis]) ? UE_BIG_NUMBER : (Boundary - Start[Axis]) * InvDirection[Axis];
+        TDelta[Axis] = FMath::IsNearlyZero(Direction[Axis]) ? UE_BIG_NUMBER : CellSize * FMath::Abs(InvDirection[Axis]);
+    }
+
+    double T = 0.0;
+    while (T <= BestDistance)
+    {
+        if (const FCellRange* Range = Cells.Find(Cell))
+        {
+            for (int32 i = Range->Start; i < Range->Start + Range->Num; ++i)
+            {
+                TestEntry(CellEntries[i]);
+            }
+        }
+
+        // 次のセルへ
+        const int32 Axis = TMax.X < TMax.Y ? (TMax.X < TMax.Z ? 0 : 2) : (TMax.Y < TMax.Z ? 1 : 2);
+        T = TMax[Axis];
+        TMax[Axis] += TDelta[Axis];
+        Cell[Axis] += Step[Axis];
+    }
+
+    return bFound;
+}
+
+
+bool UWireAnchorSubsystem::FindAnchorInCone(const FVector& Start, const FVector& Direction, float MaxDistance, float HalfAngle, FHitResult& OutHit, const AActor* IgnoreActor)
+{
+    if (!bBuilt)
+        Rebuild();
+    else if (bCellsDirty)
+        BuildCells();
+
+    ++CurrentStamp;
+
+    // コーンを囲む AABB のセルを候補とする
+    const float EndRadius = MaxDistance * FMath::Tan(FMath::DegreesToRadians(HalfAngle));
+    const FVector End = Start + Direction * MaxDistance;
+    FBox ConeBounds(Start, Start);
+    ConeBounds += FBox(End - FVector(EndRadius), End + FVector(EndRadius));
+
+    const float MinCos = FMath::Cos(FMath::DegreesToRadians(HalfAngle));
+    ConeCandidates.Reset();
+
+    // 箱の中でレイに最も近い点の向きで評価する
+    auto ScoreEntry = [&](int32 EntryIndex)
+    {
+        if (!MarkVisited(EntryIndex))
+            return;
+
+        const FBox& Bounds = Entries[EntryIndex].Bounds;
+        const float Along = FMath::Clamp<double>(FVector::DotProduct(Bounds.GetCenter() - Start, Direction), 0.0, MaxDistance);
+        const FVector Target = Bounds.GetClosestPointTo(Start + Direction * Along);
+        const FVector ToTarget = Target - Start;
+        const float Distance = ToTarget.Size();
+        if (Distance <= UE_KINDA_SMALL_NUMBER || Distance > MaxDistance)
+            return;
+
+        const float Cos = FVector::DotProduct(ToTarget / Distance, Direction);
+        if (Cos > MinCos)
+            ConeCandidates.Add({ EntryIndex, Cos, Target });
+    };
+
+    for (int32 EntryIndex : LargeEntries)
+    {
+        ScoreEntry(EntryIndex);
+    }
+
+    const FIntVector Min = ToCell(ConeBounds.Min);
+    const FIntVector Max = ToCell(ConeBounds.Max);
+    for (int32 X = Min.X; X <= Max.X; ++X)
+        for (int32 Y = Min.Y; Y <= Max.Y; ++Y)
+            for (int32 Z = Min.Z; Z <= Max.Z; ++Z)
+            {
+                if (const FCellRange* Range = Cells.Find(FIntVector(X, Y, Z)))
+                {
+                    for (int32 i = Range->Start; i < Range->Start + Range->Num; ++i)
+                    {
+                        ScoreEntry(CellEntries[i]);
+                    }
+                }
+            }
+
+    // レイに近い向きの順に、正確なトレースで接続位置を求め、手から遮られずに届くものを選ぶ
+    ConeCandidates.Sort([](const FConeCandidate& A, const FConeCandidate& B) { return A.Cos > B.Cos; });
+
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(WireAnchorLineOfSight));
+    Params.AddIgnoredActor(IgnoreActor);
+
+    const int32 NumCandidates = FMath::Min(ConeCandidates.Num(), FMath::Max(MaxConeCandidates, 1));
+    for (int32 i = 0; i < NumCandidates; ++i)
+    {
+        const FConeCandidate& Candidate = ConeCandidates[i];
+        const FVector TargetDirection = (Candidate.Target - Start).GetSafeNormal();
+        FHitResult Hit;
+        if (!TraceEntry(Candidate.EntryIndex, Start, Start + TargetDirection * MaxDistance, Hit))
+            continue;
+
+        // 接続位置までの間に別のものがあれば次の候補へ
+        FHitResult Blocker;
+        WIRE_COUNT_TRACE();
+        if (GetWorld()->LineTraceSingleByChannel(Blocker, Start, Hit.ImpactPoint, ECC_Visibility, Params)
+            && Blocker.GetComponent() != Hit.GetComponent())
+            continue;
+
+        OutHit = Hit;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool UWireAnchorSubsystem::FindAnchor(const FVector& Start, const FVector& Direction, float MaxDistance, float AimAssistAngle, FHitResult& OutHit, const AActor* IgnoreActor)
+{
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireAnchorIndexQuery, AnchorIndexQuery);
+
+    if (FindAnchorAlongRay(Start, Direction, MaxDistance, OutHit))
+        return true;
+
+    return AimAssistAngle > 0.0f && FindAnchorInCone(Start, Direction, MaxDistance, AimAssistAngle, OutHit, IgnoreActor);
+}
@@ -0,0 +1,46 @@
+﻿#include "WireAsyncPhysics.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+
+
+void FWireAsyncCallback::OnPreSimulate_Internal()
+{
+    const FWireAsyncInput* Input = GetConsumerInput_Internal();
+    if (!Input || !Input->Proxy)
+        return;
+
+    Chaos::FRigidBodyHandle_Internal* Body = Input->Proxy->GetPhysicsThreadAPI();
+    if (!Body)
+        return;
+
+    Solver.SetSettings(Input->Settings);
+
+    // 入力による速度の変化はまだ加えていない番号の分だけ加える（同じ入力で複数ステップ進む・入力が読み飛ばされることがある）
+    FVector Velocity = Body->GetV();
+    for (const FWireAsyncVelocityChange& VelocityChange : Input->VelocityChanges)
+    {
+        if (VelocityChange.Sequence > LastVelocityChangeSequence)
+        {
+            Velocity += VelocityChange.Change;
+            LastVelocityChangeSequence = VelocityChange.Sequence;
+        }
+    }
+    Solver.SetVelocity(Velocity);
+
+    // 根元はボディの現在位置からずらした位置
+    const FVector Location = Body->GetX();
+    FVector Origins[FWireSolver::MaxTethers];
+    for (int32 i = 0; i < Solver.GetNumTethers(); ++i)
+    {
+        Solver.SetTether(i, Input->Tethers[i]);
+        Origins[i] = Location + Input->OriginOffsets[i];
+    }
+
+    // 重力・空気抵抗・引き寄せで速度だけを更新し、移動と衝突は物理に任せる
+    const FWireSolverStepResult StepResult = Solver.StepSubdivided(GetDeltaTime_Internal(), MakeArrayView(Origins, Solver.GetNumTethers()));
+    Body->SetV(Solver.GetVelocity());
+
+    FWireAsyncOutput& Output = GetProducerOutputData_Internal();
+    Output.PullAcceleration = StepResult.PullAcceleration;
+    Output.NumSubsteps = StepResult.NumSubsteps;
+    Output.AppliedVelocityChangeSequence = LastVelocityChangeSequence;
+}
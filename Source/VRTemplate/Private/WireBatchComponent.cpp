@@ -0,0 +1,465 @@
+﻿#include "WireBatchComponent.h"
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+#include "MaterialShared.h"
+#include "Materials/Material.h"
+#include "RenderingThread.h"
+#include "DynamicMeshBuilder.h"
+#include "LocalVertexFactory.h"
+#include "StaticMeshResources.h"
+#include "WireStats.h"
+
+namespace
+{
+    // 変化したワイヤー1本分の頂点（空なら非表示）
+    struct FWireBatchUpdate
+    {
+        int32 Handle = INDEX_NONE;
+        TArray<FDynamicMeshVertex> Vertices;
+        TArray<uint32> Indices;
+    };
+
+    /**
+     * 全ワイヤーの頂点・インデックスを1組の GPU バッファに持ち続け、1つの FMeshBatch で描画する
+     * ハンドルごとに最大の頂点数・インデックス数の区画を割り当て、変化したワイヤーの区画だけを書き換える
+     * 使っていない分のインデックスは縮退三角形で埋める
+     */
+    class FWireBatchSceneProxy final : public FPrimitiveSceneProxy
+    {
+    public:
+        explicit FWireBatchSceneProxy(UWireBatchComponent* Component)
+            : FPrimitiveSceneProxy(Component)
+            , VertexFactory(GetScene().GetFeatureLevel(), "FWireBatchSceneProxy")
+            , VerticesPerWire((Component->NumCurveSegments + 1) * Component->NumSides)
+            , IndicesPerWire(Component->NumCurveSegments * Component->NumSides * 6)
+        {
+            UMaterialInterface* Material = Component->GetMaterial(0);
+            if (!Material)
+                Material = UMaterial::GetDefaultMaterial(MD_Surface);
+
+            MaterialProxy = Material->GetRenderProxy();
+            MaterialRelevance = Material->GetRelevance_Concurrent(GetScene().GetFeatureLevel());
+
+            // UV2, UV3 に銃のワールド座標を入れるので UV は半精度にしない
+            VertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(true);
+            NumSlots = InitialSlots;
+            Vertices.SetNumZeroed(NumSlots * VerticesPerWire);
+            IndexBuffer.Indices.SetNumZeroed(NumSlots * IndicesPerWire);
+            VertexBuffers.InitWithDummyData(&VertexFactory, Vertices.Num(), NumTexCoords);
+            BeginInitResource(&IndexBuffer);
+        }
+
+        virtual ~FWireBatchSceneProxy() override
+        {
+            ReleaseBuffers();
+        }
+
+        virtual SIZE_T GetTypeHash() const override
+        {
+            static size_t UniquePointer;
+            return reinterpret_cast<size_t>(&UniquePointer);
+        }
+
+        // 変化したワイヤーの区画だけを書き換える
+        void UpdateWires_RenderThread(FRHICommandListImmediate& RHICmdList, TArray<FWireBatchUpdate>&& Updates)
+        {
+            check(IsInRenderingThread());
+
+            // 区画が足りなければ倍に広げる（バッファは書き換えた後で作り直して全体を送る）
+            int32 MaxHandle = INDEX_NONE;
+            for (const FWireBatchUpdate& Update : Updates)
+                MaxHandle = FMath::Max(MaxHandle, Update.Handle);
+            const bool bGrow = MaxHandle >= NumSlots;
+            if (bGrow)
+            {
+                NumSlots = FMath::Max(NumSlots * 2, MaxHandle + 1);
+                Vertices.SetNumZeroed(NumSlots * VerticesPerWire);
+                IndexBuffer.Indices.SetNumZeroed(NumSlots * IndicesPerWire);
+            }
+            if (SlotVisible.Num() < NumSlots)
+                SlotVisible.SetNum(NumSlots, false);
+
+            for (const FWireBatchUpdate& Update : Updates)
+            {
+                // 区画の大きさはプロキシを作った時の設定で決まる（設定を変えるとプロキシごと作り直される）
+                if (!ensure(Update.Vertices.Num() <= VerticesPerWire && Update.Indices.Num() <= IndicesPerWire))
+                    continue;
+
+                const uint32 BaseVertex = Update.Handle * VerticesPerWire;
+                FMemory::Memcpy(&Vertices[BaseVertex], Update.Vertices.GetData(), Update.Vertices.Num() * sizeof(FDynamicMeshVertex));
+
+                uint32* Indices = &IndexBuffer.Indices[Update.Handle * IndicesPerWire];
+                for (int32 i = 0; i < Update.Indices.Num(); ++i)
+                    Indices[i] = BaseVertex + Update.Indices[i];
+                for (int32 i = Update.Indices.Num(); i < IndicesPerWire; ++i)
+                    Indices[i] = BaseVertex;
+
+                SlotVisible[Update.Handle] = Update.Indices.Num() > 0;
+            }
+
+            if (bGrow)
+            {
+                ReleaseBuffers();
+                VertexBuffers.InitWithDummyData(&VertexFactory, Vertices.Num(), NumTexCoords);
+                IndexBuffer.InitResource(RHICmdList);
+                UploadSlots(RHICmdList, 0, NumSlots, true);
+            }
+            else
+            {
+                // ハンドル順に並べ、隣り合う区画はまとめて1回で送る
+                Updates.Sort([](const FWireBatchUpdate& A, const FWireBatchUpdate& B) { return A.Handle < B.Handle; });
+                for (int32 First = 0; First < Updates.Num();)
+                {
+                    int32 Last = First;
+                    while (Last + 1 < Updates.Num() && Updates[Last + 1].Handle <= Updates[Last].Handle + 1)
+                        ++Last;
+                    UploadSlots(RHICmdList, Updates[First].Handle, Updates[Last].Handle - Updates[First].Handle + 1, false);
+                    First = Last + 1;
+                }
+            }
+
+            // 最後の表示中の区画までを描画する
+            NumDrawnSlots = SlotVisible.FindLast(true) + 1;
+        }
+
+        virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+        {
+            if (NumDrawnSlots == 0)
+                return;
+
+            for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ++ViewIndex)
+            {
+                if (!(VisibilityMap & (1 << ViewIndex)))
+                    continue;
+
+                FMeshBatch& Mesh = Collector.AllocateMesh();
+                Mesh.VertexFactory = &VertexFactory;
+                Mesh.MaterialRenderProxy = MaterialProxy;
+                Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+                Mesh.Type = PT_TriangleList;
+                Mesh.DepthPriorityGroup = SDPG_World;
+                Mesh.bCanApplyViewModeOverrides = false;
+                // 細いので裏面も描いて向きによる欠けを防ぐ
+                Mesh.bDisableBackfaceCulling = true;
+
+                FDynamicPrimitiveUniformBuffer& DynamicPrimitiveUniformBuffer = Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+                DynamicPrimitiveUniformBuffer.Set(Collector.GetRHICommandList(), GetLocalToWorld(), GetLocalToWorld(), GetBounds(), GetLocalBounds(), true, false, AlwaysHasVelocity());
+
+                FMeshBatchElement& BatchElement = Mesh.Elements[0];
+                BatchElement.IndexBuffer = &IndexBuffer;
+                BatchElement.PrimitiveUniformBufferResource = &DynamicPrimitiveUniformBuffer.UniformBuffer;
+                BatchElement.FirstIndex = 0;
+                BatchElement.NumPrimitives = NumDrawnSlots * IndicesPerWire / 3;
+                BatchElement.MinVertexIndex = 0;
+                BatchElement.MaxVertexIndex = NumDrawnSlots * VerticesPerWire - 1;
+                Collector.AddMesh(ViewIndex, Mesh);
+            }
+        }
+
+        virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+        {
+            FPrimitiveViewRelevance Result;
+            Result.bDrawRelevance = IsShown(View);
+            Result.bDynamicRelevance = true;
+            Result.bShadowRelevance = false;
+            Result.bRenderInMainPass = ShouldRenderInMainPass();
+            MaterialRelevance.SetPrimitiveViewRelevance(Result);
+            return Result;
+        }
+
+        virtual uint32 GetMemoryFootprint() const override
+        {
+            return sizeof(*this) + GetAllocatedSize() + Vertices.GetAllocatedSize() + IndexBuffer.Indices.GetAllocatedSize() + SlotVisible.GetAllocatedSize();
+        }
+
+    private:
+        static constexpr uint32 NumTexCoords = 4;
+        static constexpr int32 InitialSlots = 16;
+
+        void ReleaseBuffers()
+        {
+            VertexBuffers.PositionVertexBuffer.ReleaseResource();
+            VertexBuffers.StaticMeshVertexBuffer.ReleaseResource();
+            VertexBuffers.ColorVertexBuffer.ReleaseResource();
+            IndexBuffer.ReleaseResource();
+            VertexFactory.ReleaseResource();
+        }
+
+        // 区画 [FirstSlot, FirstSlot + Count) の頂点とインデックスを GPU へ書き込む
+        void UploadSlots(FRHICommandListImmediate& RHICmdList, int32 FirstSlot, int32 Count, bool bIndicesUploaded)
+        {
+            const int32 FirstVertex = FirstSlot * VerticesPerWire;
+            const int32 NumVertices = Count * VerticesPerWire;
+            for (int32 i = FirstVertex; i < FirstVertex + NumVertices; ++i)
+            {
+                const FDynamicMeshVertex& Vertex = Vertices[i];
+                VertexBuffers.PositionVertexBuffer.VertexPosition(i) = Vertex.Position;
+                VertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(i, Vertex.TangentX.ToFVector3f(), Vertex.GetTangentY(), Vertex.TangentZ.ToFVector3f());
+                for (uint32 UV = 0; UV < NumTexCoords; ++UV)
+                    VertexBuffers.StaticMeshVertexBuffer.SetVertexUV(i, UV, Vertex.TextureCoordinate[UV]);
+                VertexBuffers.ColorVertexBuffer.VertexColor(i) = Vertex.Color;
+            }
+
+            FStaticMeshVertexBuffer& StaticMeshVertexBuffer = VertexBuffers.StaticMeshVertexBuffer;
+            const uint32 TotalVertices = StaticMeshVertexBuffer.GetNumVertices();
+            UploadRange(RHICmdList, VertexBuffers.PositionVertexBuffer.VertexBufferRHI, VertexBuffers.PositionVertexBuffer.GetVertexData(), VertexBuffers.PositionVertexBuffer.GetStride(), FirstVertex, NumVertices);
+            UploadRange(RHICmdList, VertexBuffers.ColorVertexBuffer.VertexBufferRHI, VertexBuffers.ColorVertexBuffer.GetVertexData(), VertexBuffers.ColorVertexBuffer.GetStride(), FirstVertex, NumVertices);
+            UploadRange(RHICmdList, StaticMeshVertexBuffer.TangentsVertexBuffer.VertexBufferRHI, StaticMeshVertexBuffer.GetTangentData(), StaticMeshVertexBuffer.GetTangentSize() / TotalVertices, FirstVertex, NumVertices);
+            UploadRange(RHICmdList, StaticMeshVertexBuffer.TexCoordVertexBuffer.VertexBufferRHI, StaticMeshVertexBuffer.GetTexCoordData(), StaticMeshVertexBuffer.GetTexCoordSize() / TotalVertices, FirstVertex, NumVertices);
+
+            // 作り直した直後のインデックスは InitResource で送り済み
+            if (!bIndicesUploaded)
+                UploadRange(RHICmdList, IndexBuffer.IndexBufferRHI, IndexBuffer.Indices.GetData(), sizeof(uint32), FirstSlot * IndicesPerWire, Count * IndicesPerWire);
+        }
+
+        static void UploadRange(FRHICommandListImmediate& RHICmdList, FRHIBuffer* Buffer, const void* Data, uint32 Stride, int32 First, int32 Num)
+        {
+            if (!Buffer || Num <= 0)
+                return;
+
+            void* Dest = RHICmdList.LockBuffer(Buffer, First * Stride, Num * Stride, RLM_WriteOnly);
+            FMemory::Memcpy(Dest, static_cast<const uint8*>(Data) + First * Stride, Num * Stride);
+            RHICmdList.UnlockBuffer(Buffer);
+        }
+
+        const FMaterialRenderProxy* MaterialProxy = nullptr;
+        FMaterialRelevance MaterialRelevance;
+
+        FStaticMeshVertexBuffers VertexBuffers;
+        FDynamicMeshIndexBuffer32 IndexBuffer;
+        FLocalVertexFactory VertexFactory;
+
+        // 1本分の区画の大きさ
+        const int32 VerticesPerWire;
+        const int32 IndicesPerWire;
+
+        // 区画の数と、区画ごとの頂点（バッファを広げる時に全体を送り直すため）
+        int32 NumSlots = 0;
+        TArray<FDynamicMeshVertex> Vertices;
+
+        // 区画ごとに表示中か、描画する区画の数
+        TBitArray<> SlotVisible;
+        int32 NumDrawnSlots = 0;
+    };
+}
+
+
+UWireBatchComponent::UWireBatchComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    CastShadow = false;
+    bUseAsOccluder = false;
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetGenerateOverlapEvents(false);
+}
+
+
+int32 UWireBatchComponent::AddWire()
+{
+    const int32 Handle = FreeWires.Num() > 0 ? FreeWires.Pop(EAllowShrinking::No) : Wires.AddDefaulted();
+    // 解放後にまだ送っていない変化は残す（描画スレッド側の古い頂点を消すため）
+    const bool bWasDirty = Wires[Handle].bDirty;
+    Wires[Handle] = FWireInstance();
+    Wires[Handle].bInUse = true;
+    Wires[Handle].bDirty = bWasDirty;
+    return Handle;
+}
+
+
+void UWireBatchComponent::RemoveWire(int32 Handle)
+{
+    if (!Wires.IsValidIndex(Handle) || !Wires[Handle].bInUse)
+        return;
+
+    if (Wires[Handle].bVisible)
+        MarkDirty(Wires[Handle]);
+    Wires[Handle].bInUse = false;
+    Wires[Handle].bVisible = false;
+    FreeWires.Add(Handle);
+}
+
+
+void UWireBatchComponent::MarkDirty(FWireInstance& Wire)
+{
+    Wire.bDirty = true;
+    bRenderDataDirty = true;
+}
+
+
+void UWireBatchComponent::SetWireCurve(int32 Handle, const FVector& Start, const FVector& StartTangent, const FVector& End, const FVector& EndTangent)
+{
+    FWireInstance& Wire = Wires[Handle];
+
+    // ほとんど動いていなければ送り直さない
+    if (Wire.Start.Equals(Start, UpdateTolerance) && Wire.End.Equals(End, UpdateTolerance)
+        && Wire.StartTangent.Equals(StartTangent, UpdateTolerance) && Wire.EndTangent.Equals(EndTangent, UpdateTolerance))
+        return;
+
+    Wire.Start = Start;
+    Wire.StartTangent = StartTangent;
+    Wire.End = End;
+    Wire.EndTangent = EndTangent;
+    if (Wire.bVisible)
+        MarkDirty(Wire);
+}
+
+
+void UWireBatchComponent::SetWireState(int32 Handle, float State)
+{
+    FWireInstance& Wire = Wires[Handle];
+    if (Wire.State == State)
+        return;
+
+    Wire.State = State;
+    if (Wire.bVisible)
+        MarkDirty(Wire);
+}
+
+
+void UWireBatchComponent::SetWireOrigin(int32 Handle, const FVector& Origin)
+{
+    FWireInstance& Wire = Wires[Handle];
+    if (Wire.Origin.Equals(Origin, UpdateTolerance))
+        return;
+
+    Wire.Origin = Origin;
+    if (Wire.bVisible)
+        MarkDirty(Wire);
+}
+
+
+void UWireBatchComponent::SetWireVisible(int32 Handle, bool bVisible)
+{
+    FWireInstance& Wire = Wires[Handle];
+    if (Wire.bVisible == bVisible)
+        return;
+
+    Wire.bVisible = bVisible;
+    MarkDirty(Wire);
+}
+
+
+int32 UWireBatchComponent::GetNumVisibleWires() const
+{
+    int32 NumVisible = 0;
+    for (const FWireInstance& Wire : Wires)
+    {
+        if (Wire.bInUse && Wire.bVisible)
+            ++NumVisible;
+    }
+    return NumVisible;
+}
+
+
+void UWireBatchComponent::FlushWires()
+{
+    if (!bRenderDataDirty || !SceneProxy)
+        return;
+
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireBatchFlush, WireBatchFlush);
+    bRenderDataDirty = false;
+
+    // 変化したワイヤーだけ頂点を作り直す（非表示・解放したワイヤーは空で送る）
+    TArray<FWireBatchUpdate> Updates;
+    int32 NumVisible = 0;
+    for (int32 Handle = 0; Handle < Wires.Num(); ++Handle)
+    {
+        FWireInstance& Wire = Wires[Handle];
+        const bool bShown = Wire.bInUse && Wire.bVisible;
+        NumVisible += bShown ? 1 : 0;
+        if (!Wire.bDirty)
+            continue;
+
+        Wire.bDirty = false;
+        FWireBatchUpdate& Update = Updates.AddDefaulted_GetRef();
+        Update.Handle = Handle;
+        if (bShown)
+            BuildWire(Wire, Update.Vertices, Update.Indices);
+    }
+    INC_DWORD_STAT(STAT_WireBatchPushes);
+    SET_DWORD_STAT(STAT_WireBatchedWires, NumVisible);
+
+    // 変化分を1回の描画コマンドで送る（配列はコピーせずに移す）
+    FWireBatchSceneProxy* Proxy = static_cast<FWireBatchSceneProxy*>(SceneProxy);
+    ENQUEUE_RENDER_COMMAND(WireBatchUpdate)(
+        [Proxy, Updates = MoveTemp(Updates)](FRHICommandListImmediate& RHICmdList) mutable
+        {
+            Proxy->UpdateWires_RenderThread(RHICmdList, MoveTemp(Updates));
+        });
+}
+
+
+void UWireBatchComponent::BuildWire(const FWireInstance& Wire, TArray<FDynamicMeshVertex>& OutVertices, TArray<uint32>& OutIndices) const
+{
+    // 接線がなければ直線なので分割しない
+    const bool bStraight = Wire.StartTangent.IsNearlyZero() && Wire.EndTangent.IsNearlyZero();
+    const int32 NumSegments = bStraight ? 1 : NumCurveSegments;
+    OutVertices.Reserve((NumSegments + 1) * NumSides);
+    OutIndices.Reserve(NumSegments * NumSides * 6);
+    const FVector Chord = (Wire.End - Wire.Start).GetSafeNormal();
+
+    for (int32 Segment = 0; Segment <= NumSegments; ++Segment)
+    {
+        const float Alpha = (float)Segment / NumSegments;
+        const FVector Position = bStraight
+            ? FMath::Lerp(Wire.Start, Wire.End, Alpha)
+            : FMath::CubicInterp(Wire.Start, Wire.StartTangent, Wire.End, Wire.EndTangent, Alpha);
+        FVector Direction = bStraight ? Chord : FMath::CubicInterpDerivative(Wire.Start, Wire.StartTangent, Wire.End, Wire.EndTangent, Alpha).GetSafeNormal();
+        if (Direction.IsNearlyZero())
+            Direction = Chord.IsNearlyZero() ? FVector::ForwardVector : Chord;
+
+        // 断面の向き
+        const FVector Up = FMath::Abs(Direction.Z) < 0.99f ? FVector::UpVector : FVector::ForwardVector;
+        const FVector Right = FVector::CrossProduct(Direction, Up).GetSafeNormal();
+        const FVector Normal = FVector::CrossProduct(Right, Direction);
+
+        for (int32 Side = 0; Side < NumSides; ++Side)
+        {
+            float Sin, Cos;
+            FMath::SinCos(&Sin, &Cos, UE_TWO_PI * Side / NumSides);
+            const FVector Outward = Right * Cos + Normal * Sin;
+
+            FDynamicMeshVertex Vertex(
+                FVector3f(Position + Outward * WireRadius),
+                FVector3f(Direction),
+                FVector3f(Outward),
+                FVector2f(Alpha, (float)Side / NumSides),
+                FColor::White);
+            Vertex.TextureCoordinate[1] = FVector2f(Wire.State, 0.0f);
+            Vertex.TextureCoordinate[2] = FVector2f(Wire.Origin.X, Wire.Origin.Y);
+            Vertex.TextureCoordinate[3] = FVector2f(Wire.Origin.Z, 0.0f);
+            OutVertices.Add(Vertex);
+        }
+    }
+
+    for (int32 Segment = 0; Segment < NumSegments; ++Segment)
+    {
+        for (int32 Side = 0; Side < NumSides; ++Side)
+        {
+            const uint32 A = Segment * NumSides + Side;
+            const uint32 B = Segment * NumSides + (Side + 1) % NumSides;
+            const uint32 C = A + NumSides;
+            const uint32 D = B + NumSides;
+            OutIndices.Append({ A, C, B, B, C, D });
+        }
+    }
+}
+
+
+FPrimitiveSceneProxy* UWireBatchComponent::CreateSceneProxy()
+{
+    // 作り直したプロキシには次の FlushWires で全ワイヤーを送る
+    for (FWireInstance& Wire : Wires)
+    {
+        if (Wire.bInUse && Wire.bVisible)
+            MarkDirty(Wire);
+    }
+    return new FWireBatchSceneProxy(this);
+}
+
+
+FBoxSphereBounds UWireBatchComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+    // ワイヤーはワールド中に散らばるので常に描画対象にする
+    return FBoxSphereBounds(FVector::ZeroVector, FVector(HALF_WORLD_MAX), HALF_WORLD_MAX);
+}
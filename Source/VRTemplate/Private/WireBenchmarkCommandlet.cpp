@@ -0,0 +1,602 @@
+﻿#include "WireBenchmarkCommandlet.h"
+#include "VRPawn.h"
+#include "WireSolver.h"
+#include "WireTickProfiler.h"
+#include "WireInputRecording.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/WorldSettings.h"
+#include "Components/StaticMeshComponent.h"
+#include "EngineUtils.h"
+#include "UObject/Package.h"
+#include "UObject/CoreNet.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWireBenchmark, Log, All);
+
+namespace WireBenchmark
+{
+    // 1フェーズ分の計測結果を出力
+    void ReportPhase(const FWireTickProfiler& Profiler, EWireTickPhase Phase)
+    {
+        if (Profiler.GetNumSamples(Phase) == 0)
+            return;
+
+        UE_LOG(LogWireBenchmark, Display, TEXT("%-20s samples=%7d mean=%8.2fus p50=%8.2fus p99=%8.2fus max=%8.2fus"),
+            FWireTickProfiler::GetPhaseName(Phase),
+            Profiler.GetNumSamples(Phase),
+            Profiler.GetMeanMicroseconds(Phase),
+            Profiler.GetPercentileMicroseconds(Phase, 0.5),
+            Profiler.GetPercentileMicroseconds(Phase, 0.99),
+            Profiler.GetPercentileMicroseconds(Phase, 1.0));
+    }
+
+    // RPC 1回あたりの見出しの目安（関数の識別子とバンチのヘッダー。パケット・UDP/IP のヘッダーは含まない）
+    constexpr int64 RpcHeaderBits = 64;
+
+    // RPC の引数の配列の要素数
+    constexpr int64 RpcArrayNumBits = 16;
+
+    // RPC の引数として送る FVRPawnMove のビット数（UPROPERTY を順にそれぞれの量子化で書いた量）
+    int64 MeasureMoveBits(const FVRPawnMove& InMove)
+    {
+        FVRPawnMove Move = InMove;
+        FNetBitWriter Writer(nullptr, 0);
+        bool bSuccess = true;
+        Writer << Move.TimeStamp << Move.DeltaTime << Move.Flags << Move.NumSubsteps << Move.MaxSweeps;
+        Writer << Move.MoveInput;
+        for (int32 i = 0; i < 2; ++i)
+        {
+            Move.HandLocation[i].NetSerialize(Writer, nullptr, bSuccess);
+            Move.HandRotation[i].NetSerialize(Writer, nullptr, bSuccess);
+        }
+        Move.ResultLocation.NetSerialize(Writer, nullptr, bSuccess);
+        return Writer.GetNumBits();
+    }
+
+    // p99 が閾値を超えていれば失敗
+    bool CheckThreshold(const FWireTickProfiler& Profiler, EWireTickPhase Phase, double MaxP99)
+    {
+        const double P99 = Profiler.GetPercentileMicroseconds(Phase, 0.99);
+        if (MaxP99 > 0.0 && P99 > MaxP99)
+        {
+            UE_LOG(LogWireBenchmark, Error, TEXT("%s p99 %.2fus exceeds threshold %.2fus"),
+                FWireTickProfiler::GetPhaseName(Phase), P99, MaxP99);
+            return false;
+        }
+        return true;
+    }
+}
+
+
+UWireBenchmarkCommandlet::UWireBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+
+int32 UWireBenchmarkCommandlet::Main(const FString& Params)
+{
+    if (FParse::Param(*Params, TEXT("SolverOnly")))
+    {
+        return RunSolverBenchmark(Params);
+    }
+    if (FParse::Param(*Params, TEXT("Bandwidth")))
+    {
+        return RunBandwidthBenchmark(Params);
+    }
+    FString ReplayName;
+    if (FParse::Value(*Params, TEXT("Replay="), ReplayName))
+    {
+        return RunReplayBenchmark(Params, ReplayName);
+    }
+    return RunPawnBenchmark(Params);
+}
+
+
+int32 UWireBenchmarkCommandlet::RunPawnBenchmark(const FString& Params)
+{
+    FString MapName;
+    FString PawnClassPath;
+    int32 NumTicks = 2000;
+    int32 NumWarmupTicks = 200;
+    float FrameRate = 90.0f;
+    double MaxTickP99 = 0.0;
+    FParse::Value(*Params, TEXT("Map="), MapName);
+    FParse::Value(*Params, TEXT("PawnClass="), PawnClassPath);
+    FParse::Value(*Params, TEXT("Ticks="), NumTicks);
+    FParse::Value(*Params, TEXT("Warmup="), NumWarmupTicks);
+    FParse::Value(*Params, TEXT("FrameRate="), FrameRate);
+    FParse::Value(*Params, TEXT("MaxTickP99="), MaxTickP99);
+
+    UWorld* World = CreateBenchmarkWorld(MapName);
+    if (!World)
+    {
+        return 1;
+    }
+
+    AVRPawn* Pawn = SpawnBenchmarkPawn(World, PawnClassPath);
+    if (!Pawn)
+    {
+        DestroyBenchmarkWorld(World);
+        return 1;
+    }
+
+    const float DeltaTime = 1.0f / FMath::Max(FrameRate, 1.0f);
+
+    // 計測前にキャッシュなどを温める
+    int32 TickIndex = 0;
+    for (; TickIndex < NumWarmupTicks; ++TickIndex)
+    {
+        ApplyScriptedInput(Pawn, TickIndex, DeltaTime);
+        World->Tick(LEVELTICK_All, DeltaTime);
+        ++GFrameCounter;
+    }
+
+    // 計測
+    FWireTickProfiler Profiler;
+    Profiler.Reserve(NumTicks * 2);
+    FWireTickProfiler::SetActive(&Profiler);
+    for (int32 i = 0; i < NumTicks; ++i, ++TickIndex)
+    {
+        ApplyScriptedInput(Pawn, TickIndex, DeltaTime);
+        World->Tick(LEVELTICK_All, DeltaTime);
+        ++GFrameCounter;
+    }
+    FWireTickProfiler::SetActive(nullptr);
+
+    UE_LOG(LogWireBenchmark, Display, TEXT("Pawn benchmark: %s, %d ticks at %.0f Hz"),
+        MapName.IsEmpty() ? TEXT("(empty world)") : *MapName, NumTicks, FrameRate);
+    for (int32 Phase = 0; Phase < (int32)EWireTickPhase::Num; ++Phase)
+    {
+        WireBenchmark::ReportPhase(Profiler, (EWireTickPhase)Phase);
+    }
+
+    uint32 CacheHits = 0;
+    uint32 CacheMisses = 0;
+    Pawn->GetAimCacheCounters(CacheHits, CacheMisses);
+    UE_LOG(LogWireBenchmark, Display, TEXT("AimCache             hits=%u misses=%u reused=%.1f%%"),
+        CacheHits, CacheMisses, CacheHits + CacheMisses > 0 ? 100.0 * CacheHits / (CacheHits + CacheMisses) : 0.0);
+
+    const bool bPassed = WireBenchmark::CheckThreshold(Profiler, EWireTickPhase::Tick, MaxTickP99);
+
+    DestroyBenchmarkWorld(World);
+    return bPassed ? 0 : 1;
+}
+
+
+int32 UWireBenchmarkCommandlet::RunReplayBenchmark(const FString& Params, const FString& ReplayName)
+{
+    FString MapName;
+    FString PawnClassPath;
+    double MaxTickP99 = 0.0;
+    double MaxDivergence = 0.0;
+    FParse::Value(*Params, TEXT("Map="), MapName);
+    FParse::Value(*Params, TEXT("PawnClass="), PawnClassPath);
+    FParse::Value(*Params, TEXT("MaxTickP99="), MaxTickP99);
+    FParse::Value(*Params, TEXT("MaxDivergence="), MaxDivergence);
+
+    const FString FilePath = FWireInputRecording::GetFilePath(ReplayName);
+    FWireInputRecording Recording;
+    if (!Recording.LoadFromFile(FilePath))
+    {
+        UE_LOG(LogWireBenchmark, Error, TEXT("Failed to load input recording %s"), *FilePath);
+        return 1;
+    }
+
+    // マップの指定がなければ記録したマップ
+    if (MapName.IsEmpty())
+    {
+        MapName = Recording.MapName;
+    }
+
+    UWorld* World = CreateBenchmarkWorld(MapName);
+    if (!World)
+    {
+        return 1;
+    }
+
+    AVRPawn* Pawn = SpawnBenchmarkPawn(World, PawnClassPath);
+    if (!Pawn)
+    {
+        DestroyBenchmarkWorld(World);
+        return 1;
+    }
+    Pawn->ApplyRecordingStart(Recording);
+
+    // 温めると状態が変わるので最初のフレームから計測する
+    FWireTickProfiler Profiler;
+    Profiler.Reserve(Recording.Frames.Num() * 2);
+    FWireTickProfiler::SetActive(&Profiler);
+
+    double TotalTime = 0.0;
+    double MaxError = 0.0;
+    int32 MaxErrorFrame = INDEX_NONE;
+    for (int32 i = 0; i < Recording.Frames.Num(); ++i)
+    {
+        const FWireInputFrame& Frame = Recording.Frames[i];
+        Pawn->ApplyRecordedFrame(Frame);
+        World->Tick(LEVELTICK_All, Frame.Move.DeltaTime);
+        ++GFrameCounter;
+        TotalTime += Frame.Move.DeltaTime;
+
+        // 記録時の移動後の位置との差（描画用の補間前の位置で比べる）
+        const double Error = FVector::Dist(Pawn->GetSimulatedLocation(), Frame.Move.ResultLocation);
+        if (Error > MaxError)
+        {
+            MaxError = Error;
+            MaxErrorFrame = i;
+        }
+    }
+    FWireTickProfiler::SetActive(nullptr);
+
+    UE_LOG(LogWireBenchmark, Display, TEXT("Replay benchmark: %s on %s, %d frames, %.1f s"),
+        *FilePath, *MapName, Recording.Frames.Num(), TotalTime);
+    for (int32 Phase = 0; Phase < (int32)EWireTickPhase::Num; ++Phase)
+    {
+        WireBenchmark::ReportPhase(Profiler, (EWireTickPhase)Phase);
+    }
+    UE_LOG(LogWireBenchmark, Display, TEXT("Divergence           max=%.3f cm at frame %d"), MaxError, MaxErrorFrame);
+
+    bool bPassed = WireBenchmark::CheckThreshold(Profiler, EWireTickPhase::Tick, MaxTickP99);
+    if (MaxDivergence > 0.0 && MaxError > MaxDivergence)
+    {
+        UE_LOG(LogWireBenchmark, Error, TEXT("Replay diverged %.3f cm from the recording (threshold %.3f cm)"), MaxError, MaxDivergence);
+        bPassed = false;
+    }
+
+    DestroyBenchmarkWorld(World);
+    return bPassed ? 0 : 1;
+}
+
+
+int32 UWireBenchmarkCommandlet::RunSolverBenchmark(const FString& Params)
+{
+    int32 NumTicks = 100000;
+    float FrameRate = 90.0f;
+    double MaxTickP99 = 0.0;
+    float SimulationRate = 360.0f;
+    FParse::Value(*Params, TEXT("Ticks="), NumTicks);
+    FParse::Value(*Params, TEXT("FrameRate="), FrameRate);
+    FParse::Value(*Params, TEXT("MaxTickP99="), MaxTickP99);
+    FParse::Value(*Params, TEXT("SimulationRate="), SimulationRate);
+
+    // VRPawn と同じ設定
+    FWireSolverSettings Settings;
+    Settings.bUseXPBD = !FParse::Param(*Params, TEXT("PenaltyTether"));
+    Settings.FixedTimeStep = 1.0f / FMath::Max(SimulationRate, 1.0f);
+    Settings.PullStrength = 300.0f;
+    Settings.Gravity = 500.0f;
+    Settings.AirResistance = 0.1f;
+    FWireSolver Solver(Settings);
+
+    const float DeltaTime = 1.0f / FMath::Max(FrameRate, 1.0f);
+
+    // 速度が発散していないかの確認用
+    float MaxSpeed = 0.0f;
+    float MaxStretch = 0.0f;
+
+    FWireTickProfiler Profiler;
+    Profiler.Reserve(NumTicks);
+    for (int32 i = 0; i < NumTicks; ++i)
+    {
+        // 定期的に両手のワイヤーを付け直す
+        const float Time = i * DeltaTime;
+        const FVector Origins[FWireSolver::MaxTethers]{
+            FVector(0.0f, -30.0f, 0.0f) + FVector(100.0f * FMath::Sin(Time), 0.0f, 50.0f * FMath::Cos(Time)),
+            FVector(0.0f, 30.0f, 0.0f) + FVector(100.0f * FMath::Sin(Time), 0.0f, 50.0f * FMath::Cos(Time))
+        };
+        if (i % 180 == 0)
+        {
+            Solver.SetVelocity(FVector::ZeroVector);
+            Solver.Attach(0, FVector(1500.0f, -800.0f, 2000.0f), Origins[0]);
+            Solver.Attach(1, FVector(1500.0f, 800.0f, 2000.0f), Origins[1]);
+            Solver.ReelWire(0, Origins[0], -200.0f, 100.0f, 5000.0f);
+        }
+
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        Solver.Step(DeltaTime, Origins);
+        Profiler.AddSample(EWireTickPhase::UpdateWireMovement, FPlatformTime::Cycles64() - StartCycles);
+
+        MaxSpeed = FMath::Max(MaxSpeed, (float)Solver.GetVelocity().Size());
+        for (int32 Index = 0; Index < Solver.GetNumTethers(); ++Index)
+        {
+            const FWireTether& Tether = Solver.GetTether(Index);
+            MaxStretch = FMath::Max(MaxStretch, (float)FVector::Dist(Origins[Index], Tether.GetPivot()) - Tether.GetFreeLength());
+        }
+    }
+
+    UE_LOG(LogWireBenchmark, Display, TEXT("Solver benchmark (%s): %d steps at %.0f Hz, simulation %.0f Hz"),
+        Settings.bUseXPBD ? TEXT("XPBD") : TEXT("Penalty"), NumTicks, FrameRate, SimulationRate);
+    WireBenchmark::ReportPhase(Profiler, EWireTickPhase::UpdateWireMovement);
+    UE_LOG(LogWireBenchmark, Display, TEXT("Max speed %.0f cm/s, max stretch %.1f cm"), MaxSpeed, MaxStretch);
+
+    // 速度が発散していたら失敗
+    if (!FMath::IsFinite(MaxSpeed))
+    {
+        UE_LOG(LogWireBenchmark, Error, TEXT("Solver diverged."));
+        return 1;
+    }
+
+    return WireBenchmark::CheckThreshold(Profiler, EWireTickPhase::UpdateWireMovement, MaxTickP99) ? 0 : 1;
+}
+
+
+int32 UWireBenchmarkCommandlet::RunBandwidthBenchmark(const FString& Params)
+{
+    FString MapName;
+    FString PawnClassPath;
+    int32 NumTicks = 5400;
+    float FrameRate = 90.0f;
+    float NetRate = 0.0f;
+    int32 NumPlayers = 16;
+    double MaxBytesPerClient = 0.0;
+    FParse::Value(*Params, TEXT("Map="), MapName);
+    FParse::Value(*Params, TEXT("PawnClass="), PawnClassPath);
+    FParse::Value(*Params, TEXT("Ticks="), NumTicks);
+    FParse::Value(*Params, TEXT("FrameRate="), FrameRate);
+    FParse::Value(*Params, TEXT("NetRate="), NetRate);
+    FParse::Value(*Params, TEXT("Players="), NumPlayers);
+    FParse::Value(*Params, TEXT("MaxBytesPerClient="), MaxBytesPerClient);
+
+    UWorld* World = CreateBenchmarkWorld(MapName);
+    if (!World)
+    {
+        return 1;
+    }
+
+    AVRPawn* Pawn = SpawnBenchmarkPawn(World, PawnClassPath);
+    if (!Pawn)
+    {
+        DestroyBenchmarkWorld(World);
+        return 1;
+    }
+
+    // 複製の頻度（指定がなければ Pawn の設定）
+    if (NetRate <= 0.0f)
+    {
+        NetRate = Pawn->GetNetUpdateFrequency();
+    }
+
+    const float DeltaTime = 1.0f / FMath::Max(FrameRate, 1.0f);
+    const float NetInterval = 1.0f / FMath::Max(NetRate, 1.0f);
+
+    // クライアントとして送る入力も数える
+    Pawn->bCaptureFrameMoves = true;
+    TArray<FVRPawnMove> PreviousMoves;
+    int64 ServerMoveBits = 0;
+    int32 NumServerMoves = 0;
+    int64 AckBits = 0;
+    int32 NumAcks = 0;
+    bool bAckPending = false;
+
+    // 一定間隔で状態を作り、前回送った状態から変化していれば送ったものとしてビット数を数える
+    FVRPawnNetState LastSent;
+    bool bHasSent = false;
+    float NetTimer = 0.0f;
+    int64 TotalBits = 0;
+    int32 NumUpdates = 0;
+    int32 NumSkipped = 0;
+    int64 MaxBits = 0;
+    for (int32 TickIndex = 0; TickIndex < NumTicks; ++TickIndex)
+    {
+        ApplyScriptedInput(Pawn, TickIndex, DeltaTime);
+        World->Tick(LEVELTICK_All, DeltaTime);
+        ++GFrameCounter;
+
+        // ServerMove はフレームごとに1回、このフレームと前フレームの入力を送る
+        if (Pawn->FrameMoves.Num() > 0)
+        {
+            ServerMoveBits += WireBenchmark::RpcHeaderBits + 2 * WireBenchmark::RpcArrayNumBits;
+            for (const FVRPawnMove& Move : Pawn->FrameMoves)
+                ServerMoveBits += WireBenchmark::MeasureMoveBits(Move);
+            for (const FVRPawnMove& Move : PreviousMoves)
+                ServerMoveBits += WireBenchmark::MeasureMoveBits(Move);
+            ++NumServerMoves;
+            PreviousMoves = Pawn->FrameMoves;
+            bAckPending = true;
+        }
+
+        NetTimer += DeltaTime;
+        if (NetTimer < NetInterval)
+            continue;
+        NetTimer -= NetInterval;
+
+        // ClientAckGoodMove は複製の度に最新のタイムスタンプ1つだけ返す（補正は起きないものとする）
+        if (bAckPending)
+        {
+            AckBits += WireBenchmark::RpcHeaderBits + 32;
+            ++NumAcks;
+            bAckPending = false;
+        }
+
+        const FVRPawnNetState State = Pawn->MakeNetState(TickIndex * DeltaTime);
+        if (bHasSent && State == LastSent)
+        {
+            ++NumSkipped;
+            continue;
+        }
+
+        FNetBitWriter Writer(nullptr, 0);
+        bool bSuccess = true;
+        FVRPawnNetState Copy = State;
+        Copy.NetSerialize(Writer, nullptr, bSuccess);
+
+        TotalBits += Writer.GetNumBits();
+        MaxBits = FMath::Max(MaxBits, Writer.GetNumBits());
+        ++NumUpdates;
+        LastSent = State;
+        bHasSent = true;
+    }
+
+    const double Seconds = NumTicks * DeltaTime;
+    auto ToBytesPerSecond = [Seconds](int64 Bits) { return Seconds > 0.0 ? Bits / 8.0 / Seconds : 0.0; };
+    const double BytesPerPlayer = ToBytesPerSecond(TotalBits);
+    const double AckBytes = ToBytesPerSecond(AckBits);
+    const double UpBytes = ToBytesPerSecond(ServerMoveBits);
+    const double BytesPerClient = BytesPerPlayer * FMath::Max(NumPlayers - 1, 0) + AckBytes;
+
+    // 数えているのはプロパティ・RPC の中身と RPC の見出しの目安まで（パケット・UDP/IP のヘッダーと再送は含まない）
+    UE_LOG(LogWireBenchmark, Display, TEXT("Bandwidth benchmark: %s, %.1f s at %.0f Hz, NetRate %.0f Hz (payload + %lld bit RPC header, no packet/UDP overhead)"),
+        MapName.IsEmpty() ? TEXT("(empty world)") : *MapName, Seconds, FrameRate, NetRate, WireBenchmark::RpcHeaderBits);
+    UE_LOG(LogWireBenchmark, Display, TEXT("NetState             updates=%d skipped=%d mean=%.1f bits max=%lld bits (property payload)"),
+        NumUpdates, NumSkipped, NumUpdates > 0 ? (double)TotalBits / NumUpdates : 0.0, MaxBits);
+    UE_LOG(LogWireBenchmark, Display, TEXT("ServerMove           rpcs=%d mean=%.1f bits (client -> server)"),
+        NumServerMoves, NumServerMoves > 0 ? (double)ServerMoveBits / NumServerMoves : 0.0);
+    UE_LOG(LogWireBenchmark, Display, TEXT("ClientAckGoodMove    rpcs=%d mean=%.1f bits (server -> client)"),
+        NumAcks, NumAcks > 0 ? (double)AckBits / NumAcks : 0.0);
+    UE_LOG(LogWireBenchmark, Display, TEXT("Per player           %.1f bytes/s (NetState)"), BytesPerPlayer);
+    UE_LOG(LogWireBenchmark, Display, TEXT("Per client (%2d) down %.1f bytes/s (NetState x %d + acks)"), NumPlayers, BytesPerClient, FMath::Max(NumPlayers - 1, 0));
+    UE_LOG(LogWireBenchmark, Display, TEXT("Per client up        %.1f bytes/s (ServerMove)"), UpBytes);
+
+    bool bPassed = true;
+    if (MaxBytesPerClient > 0.0 && BytesPerClient > MaxBytesPerClient)
+    {
+        UE_LOG(LogWireBenchmark, Error, TEXT("Per client %.1f bytes/s exceeds budget %.1f bytes/s"), BytesPerClient, MaxBytesPerClient);
+        bPassed = false;
+    }
+
+    DestroyBenchmarkWorld(World);
+    return bPassed ? 0 : 1;
+}
+
+
+AVRPawn* UWireBenchmarkCommandlet::SpawnBenchmarkPawn(UWorld* World, const FString& PawnClassPath)
+{
+    // 生成するポーンのクラス
+    UClass* PawnClass = AVRPawn::StaticClass();
+    if (!PawnClassPath.IsEmpty())
+    {
+        PawnClass = LoadClass<AVRPawn>(nullptr, *PawnClassPath);
+        if (!PawnClass)
+        {
+            UE_LOG(LogWireBenchmark, Error, TEXT("Failed to load pawn class %s"), *PawnClassPath);
+            return nullptr;
+        }
+    }
+
+    // PlayerStart があればそこに、なければ原点付近に生成
+    FTransform SpawnTransform(FVector(0.0f, 0.0f, 100.0f));
+    for (TActorIterator<APlayerStart> It(World); It; ++It)
+    {
+        SpawnTransform = It->GetActorTransform();
+        break;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+    AVRPawn* Pawn = World->SpawnActor<AVRPawn>(PawnClass, SpawnTransform, SpawnParams);
+    if (!Pawn)
+    {
+        UE_LOG(LogWireBenchmark, Error, TEXT("Failed to spawn %s"), *PawnClass->GetName());
+    }
+    return Pawn;
+}
+
+
+UWorld* UWireBenchmarkCommandlet::CreateBenchmarkWorld(const FString& MapName)
+{
+    UWorld* World = nullptr;
+
+    if (!MapName.IsEmpty())
+    {
+        // マップを読み込んでゲームワールドとして初期化
+        UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+        World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+        if (!World)
+        {
+            UE_LOG(LogWireBenchmark, Error, TEXT("Failed to load map %s"), *MapName);
+            return nullptr;
+        }
+
+        World->WorldType = EWorldType::Game;
+        World->AddToRoot();
+        if (!World->bIsWorldInitialized)
+        {
+            World->InitWorld(UWorld::InitializationValues()
+                .AllowAudioPlayback(false)
+                .RequiresHitProxies(false)
+                .CreateFXSystem(false));
+        }
+    }
+    else
+    {
+        World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("WireBenchmark"));
+    }
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+
+    World->UpdateWorldComponents(true, false);
+    World->InitializeActorsForPlay(FURL());
+
+    // 空のワールドには照準が当たるよう床と天井を置く
+    if (MapName.IsEmpty())
+    {
+        UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+        const FTransform Blocks[] = {
+            FTransform(FQuat::Identity, FVector(0.0f, 0.0f, -50.0f), FVector(200.0f, 200.0f, 1.0f)),
+            FTransform(FQuat::Identity, FVector(0.0f, 0.0f, 2000.0f), FVector(200.0f, 200.0f, 1.0f))
+        };
+        for (const FTransform& Block : Blocks)
+        {
+            AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Block);
+            Actor->GetStaticMeshComponent()->SetMobility(EComponentMobility::Movable);
+            Actor->GetStaticMeshComponent()->SetStaticMesh(Cube);
+        }
+    }
+
+    World->GetWorldSettings()->NotifyBeginPlay();
+
+    return World;
+}
+
+
+void UWireBenchmarkCommandlet::DestroyBenchmarkWorld(UWorld* World)
+{
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    World->RemoveFromRoot();
+}
+
+
+void UWireBenchmarkCommandlet::ApplyScriptedInput(AVRPawn* Pawn, int32 TickIndex, float DeltaTime)
+{
+    const float Time = TickIndex * DeltaTime;
+
+    // 1.5 秒周期で接続→巻き取り→切断を繰り返す（左右で半周期ずらす）
+    const int32 CycleTicks = FMath::Max(FMath::RoundToInt32(1.5f / DeltaTime), 10);
+
+    for (int32 i = 0; i < 2; ++i)
+    {
+        const float Side = i == 0 ? -1.0f : 1.0f;
+
+        // 前上方を中心にコントローラーを振る
+        const FRotator Aim(
+            35.0f + 15.0f * FMath::Sin(Time * 1.3f + i),
+            Side * (20.0f + 25.0f * FMath::Sin(Time * 0.7f)),
+            0.0f);
+        Pawn->MotionController[i]->SetRelativeLocationAndRotation(FVector(30.0f, Side * 25.0f, 0.0f), Aim);
+
+        const int32 Phase = (TickIndex + i * CycleTicks / 2) % CycleTicks;
+        const bool bAttached = Pawn->GetWireSolver().GetTether(i).bAttached;
+
+        if (Phase == 0 && !bAttached)
+        {
+            Pawn->PendingMoveFlags |= (uint8)VRPawnWantsWireFlag(i);
+        }
+        else if (Phase > CycleTicks * 3 / 10 && Phase < CycleTicks * 8 / 10 && bAttached)
+        {
+            Pawn->PendingMoveFlags |= (uint8)VRPawnRetractWireFlag(i);
+        }
+        else if (Phase == CycleTicks * 9 / 10 && bAttached)
+        {
+            Pawn->PendingMoveFlags &= ~(uint8)VRPawnWantsWireFlag(i);
+        }
+    }
+}
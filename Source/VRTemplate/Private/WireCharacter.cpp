@@ -11,8 +11,14 @@
 #include "Components/Image.h"
 #include "Components/AudioComponent.h"
 #include "InputActionValue.h"
-
-AWireCharacter::AWireCharacter()
+#include "WireAnchorSubsystem.h"
+#include "WireStats.h"
+#include "WireCharacterMovementComponent.h"
+#include "WireTetherComponent.h"
+#include "Net/UnrealNetwork.h"
+
+AWireCharacter::AWireCharacter(const FObjectInitializer& ObjectInitializer)
+    : Super(ObjectInitializer.SetDefaultSubobjectClass<UWireCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
     PrimaryActorTick.bCanEverTick = true;
 
@@ -52,6 +58,12 @@ AWireCharacter::AWireCharacter()
     // Spline Mesh の作成
     SplineMeshComponent = CreateDefaultSubobject<USplineMeshComponent>(TEXT("SplineMeshComponent"));
 
+    // ワイヤーの演算用。移動は CharacterMovement で行うので自動では動かさない
+    WireTether = CreateDefaultSubobject<UWireTetherComponent>(TEXT("WireTether"));
+    WireTether->NumTethers = 1;
+    WireTether->AirResistance = 0.0f;
+    WireTether->bAutoMove = false;
+
     // アンカー用の SceneComponent を作成
     AnchorComponent = CreateDefaultSubobject<USceneComponent>(TEXT("AnchorComponent"));
 
@@ -74,24 +86,60 @@ void AWireCharacter::SetCrosshairWidget(UImage* image)
 void AWireCharacter::BeginPlay()
 {
     Super::BeginPlay();
+
+    // ワイヤー機動の設定をソルバーと CharacterMovement に反映
+    WireTether->bUseXPBD = bUseXPBDTether;
+    WireTether->Compliance = WireCompliance;
+    WireTether->PullStrength = WirePullStrength;
+    WireTether->SimulationRate = SimulationRate;
+    WireTether->MaxLength = WireMaxLength;
+    WireTether->ApplySolverSettings();
+    if (UWireCharacterMovementComponent* WireMovement = GetWireMovement())
+    {
+        WireMovement->WirePullStrength = WirePullStrength;
+        WireMovement->bUseXPBDTether = bUseXPBDTether;
+        WireMovement->WireCompliance = WireCompliance;
+        WireMovement->MaxWireLength = WireMaxLength;
+        WireMovement->RetractSpeed = RetractSpeed;
+        WireMovement->ExtendSpeed = ExtendSpeed;
+        WireMovement->SimulationRate = SimulationRate;
+        WireMovement->ApplySolverSettings();
+    }
 }
 
 
 void AWireCharacter::Tick(float deltaTime)
 {
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireCharacterTick, WireCharacterTick);
+
     Super::Tick(deltaTime);
 
-    // ワイヤー接続中は専用の演算
-    if (bIsWireAttached)
+    WireStats::UpdateAttachRate(GetWorld());
+
+    // サーバーでは他プレイヤーに送るワイヤーの状態を更新（量子化後に変化がなければ送られない）
+    if (HasAuthority())
     {
-        UpdateWireMovement(deltaTime);
+        const UWireCharacterMovementComponent* WireMovement = GetWireMovement();
+        WireState.SetTether(0, WireMovement->IsWireAttached(), WireMovement->GetWireAnchor(), WireMovement->GetWireLength());
+    }
+
+    // サーバーに接続を受け付けられず補正で外れた時も描画を合わせる
+    if (IsLocallyControlled())
+    {
+        SplineMeshComponent->SetVisibility(IsWireAttached());
+    }
+
+    // ワイヤー接続中はワイヤーを描画（移動は CharacterMovement の Swinging モードで行う）
+    if (IsWireAttached())
+    {
+        UpdateWireVisual();
     }
 
     // ワイヤー未接続中で照準の画像が変数登録されているなら
     else if (CrosshairImage)
     {
         // 接続状態の変化があれば色を変更
-        if (CheckConnectable() != bIsPrevConnectable)
+        if (CheckConnectable(bUseAsyncAimTrace) != bIsPrevConnectable)
         {
             bIsPrevConnectable = !bIsPrevConnectable;
             CrosshairImage->SetColorAndOpacity(bIsPrevConnectable ? FLinearColor::Green : FLinearColor::Red);
@@ -100,55 +148,117 @@ void AWireCharacter::Tick(float deltaTime)
 }
 
 
-bool AWireCharacter::CheckConnectable()
+bool AWireCharacter::CheckConnectable(bool bAllowAsync)
 {
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireCharacterCheckConnectable, WireCharacterCheckConnectable);
+
     // カメラの向きでレイを飛ばしてチェック
     FVector Start = CameraBoom->GetComponentLocation();
     FVector Forward = FollowCamera->GetComponentRotation().Vector();
     FVector End = Start + (Forward * WireRange);
 
-    FHitResult Hit;
     FCollisionQueryParams Params;
     Params.AddIgnoredActor(this);
 
-    return GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params);
+    // 姿勢がほぼ変わっていなければ前回の結果をそのまま使う
+    const double Now = GetWorld()->GetTimeSeconds();
+    bool bCachedHit = false;
+    if (bAllowAsync && AimCache.TryGet(AimCacheSettings, Start, Forward, Now, bCachedHit))
+    {
+        return bCachedHit;
+    }
+
+    if (bAllowAsync && !GetAnchorIndex())
+    {
+        // 前フレームに発行したトレースの結果を反映（結果がなければ前回の状態を維持）
+        FTraceDatum Datum;
+        if (AimTraceHandle.IsValid() && GetWorld()->QueryTraceData(AimTraceHandle, Datum))
+        {
+            bAsyncConnectable = Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit;
+            AimCache.Store(Datum.Start, (Datum.End - Datum.Start).GetSafeNormal(), Now, bAsyncConnectable ? &Datum.OutHits[0] : nullptr);
+        }
+
+        // 次フレーム用のトレースを発行
+        WIRE_COUNT_TRACE();
+        AimTraceHandle = GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, Params);
+
+        return bAsyncConnectable;
+    }
+
+    FHitResult Hit;
+    bAsyncConnectable = TraceAim(Start, Forward, Hit);
+    AimCache.Store(Start, Forward, Now, bAsyncConnectable ? &Hit : nullptr);
+    AimTraceHandle = FTraceHandle();
+
+    return bAsyncConnectable;
 }
 
 
-void AWireCharacter::UpdateWireMovement(float deltaTime)
+void AWireCharacter::UpdateWireVisual()
 {
-    FVector anchorPos = GetAnchorLocation();
-    FVector playerPos = GetActorLocation();
-    FVector ToAnchor = anchorPos - playerPos;
-    float Distance = ToAnchor.Size();
-    FVector Direction = ToAnchor.GetSafeNormal();
+    // 他プレイヤーのキャラクターは複製されたアンカーを使う
+    const FVector Anchor = GetLocalRole() == ROLE_SimulatedProxy ? WireState.Anchor[0] : GetWireMovement()->GetWireAnchor();
 
     //ワイヤー描画
-    SplineMeshComponent->SetStartAndEnd(playerPos, FVector::ZeroVector, anchorPos, FVector::ZeroVector);
+    SplineMeshComponent->SetStartAndEnd(GetActorLocation(), FVector::ZeroVector, Anchor, FVector::ZeroVector);
+}
+
+
+bool AWireCharacter::IsWireAttached() const
+{
+    return GetLocalRole() == ROLE_SimulatedProxy ? WireState.IsAttached(0) : GetWireMovement()->IsWireAttached();
+}
+
 
-    //ワイヤーの範囲外なら
-    if (Distance > CurrentWireLength)
+void AWireCharacter::OnRep_WireState(const FWireNetState& OldState)
+{
+    SplineMeshComponent->SetVisibility(WireState.IsAttached(0));
+
+    // 他プレイヤーの接続音
+    if (WireState.IsAttached(0) && !OldState.IsAttached(0))
     {
-        // ワイヤー方向の速度を取得
-        float DotProduct = FVector::DotProduct(GetCharacterMovement()->Velocity, Direction);
+        WireAttachAudio->Stop();
+        WireAttachAudio->Play(0.0f);
+    }
+}
 
-        // 逆方向の速度を打ち消し
-        if (DotProduct < 0)
-        {
-            GetCharacterMovement()->Velocity -= (Direction * DotProduct);
-        }
 
-        // 地面にいて上に引っ張られているなら一時的に "Falling" モードに変更
-        if (GetCharacterMovement()->IsMovingOnGround() && Direction.Z > 0.707)
-        {
-            GetCharacterMovement()->SetMovementMode(MOVE_Falling);
-        }
+void AWireCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // 自分のキャラクターはワイヤーの状態を CharacterMovement で予測しているので他プレイヤーにだけ送る
+    DOREPLIFETIME_CONDITION(AWireCharacter, WireState, COND_SkipOwner);
+}
+
+
+UWireCharacterMovementComponent* AWireCharacter::GetWireMovement() const
+{
+    return CastChecked<UWireCharacterMovementComponent>(GetCharacterMovement());
+}
+
 
-        // 引き寄せ処理（距離に応じて調整）
-        float PullStrength = (Distance - CurrentWireLength) * 1000;
-        FVector PullVelocity = Direction * PullStrength;
-        GetCharacterMovement()->Velocity += PullVelocity * deltaTime;
+//照準用レイでワイヤーの接続先を探す
+bool AWireCharacter::TraceAim(const FVector& Start, const FVector& Forward, FHitResult& OutHit)
+{
+    // 接続先の索引があればそちらで検索（照準アシスト付き）
+    if (UWireAnchorSubsystem* AnchorIndex = GetAnchorIndex())
+    {
+        return AnchorIndex->FindAnchor(Start, Forward, WireRange, AimAssistAngle, OutHit, this);
     }
+
+    FCollisionQueryParams Params;
+    Params.AddIgnoredActor(this);
+
+    WIRE_COUNT_TRACE();
+    return GetWorld()->LineTraceSingleByChannel(OutHit, Start, Start + Forward * WireRange, ECC_Visibility, Params);
+}
+
+
+//接続先の索引を取得
+UWireAnchorSubsystem* AWireCharacter::GetAnchorIndex() const
+{
+    return bUseAnchorIndex ? GetWorld()->GetSubsystem<UWireAnchorSubsystem>() : nullptr;
 }
 
 
@@ -169,7 +279,7 @@ FVector AWireCharacter::GetAnchorLocation() const
 //ワイヤー接続の切り替え
 void AWireCharacter::ToggleWire()
 {
-    if (bIsWireAttached)
+    if (IsWireAttached())
     {
         DetachWire();
     }
@@ -185,17 +295,20 @@ void AWireCharacter::AttachWire()
     // カメラの向きでレイを飛ばしてワイヤーを接続
     FVector Start = CameraBoom->GetComponentLocation();
     FVector Forward = FollowCamera->GetComponentRotation().Vector();
-    FVector End = Start + (Forward * WireRange);
-
-    FHitResult Hit;
-    FCollisionQueryParams Params;
-    Params.AddIgnoredActor(this);
 
-    if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params))
+    // 照準のキャッシュが新しければトレースせずにその結果を使う
+    const double Now = GetWorld()->GetTimeSeconds();
+    bool bHit = false;
+    if (!AimCache.TryGet(AimCacheSettings, Start, Forward, Now, bHit) || !bHit)
     {
-        // 接続フラグを立てる
-        bIsWireAttached = true;
+        FHitResult TraceHit;
+        bHit = TraceAim(Start, Forward, TraceHit);
+        AimCache.Store(Start, Forward, Now, bHit ? &TraceHit : nullptr);
+    }
 
+    if (bHit)
+    {
+        const FHitResult& Hit = AimCache.GetHit();
 
         // Movable かどうか判定
         if (Hit.GetActor()->IsRootComponentMovable())
@@ -215,8 +328,8 @@ void AWireCharacter::AttachWire()
             StaticAnchorLocation = Hit.ImpactPoint;
         }
 
-        // 接続時にワイヤー長を現在の距離に設定
-        CurrentWireLength = FVector::Dist(GetActorLocation(), GetAnchorLocation());
+        // 接続フラグを立て、接続時にワイヤー長を現在の距離に設定
+        GetWireMovement()->AttachWire(GetAnchorLocation(), AttachedComponent ? AnchorComponent : nullptr);
 
         // ワイヤーを可視化
         SplineMeshComponent->SetVisibility(true);
@@ -224,6 +337,8 @@ void AWireCharacter::AttachWire()
         // 照準を透明に
         CrosshairImage->SetColorAndOpacity(FLinearColor::Transparent);
 
+        WireStats::RecordAttach(GetWorld());
+
         // 効果音の再生
         WireAttachAudio->Stop();
         WireAttachAudio->Play(0.0f);
@@ -234,7 +349,7 @@ void AWireCharacter::AttachWire()
 void AWireCharacter::DetachWire()
 {
     // 接続フラグを下ろす
-    bIsWireAttached = false;
+    GetWireMovement()->DetachWire();
 
     // ワイヤーを不可視化
     SplineMeshComponent->SetVisibility(false);
@@ -260,25 +375,29 @@ void AWireCharacter::OnAttachedActorDestroyed(AActor* DestroyedActor)
 }
 
 
-// Wキーでワイヤーを巻き取る
+// Wキーでワイヤーを巻き取る（押している間、CharacterMovement の移動ごとに巻き取る）
 void AWireCharacter::RetractWire()
 {
-    if (bIsWireAttached)
-    {
-        float Distance = (GetAnchorLocation() - GetActorLocation()).Size();
-        CurrentWireLength = FMath::Clamp(Distance - RetractSpeed * GetWorld()->GetDeltaSeconds(), 100.0f, WireMaxLength);
-    }
+    GetWireMovement()->SetWantsToRetract(true);
+}
+
+
+void AWireCharacter::StopRetractWire()
+{
+    GetWireMovement()->SetWantsToRetract(false);
 }
 
 
 // Sキーでワイヤーを伸ばす
 void AWireCharacter::ExtendWire()
 {
-    if (bIsWireAttached)
-    {
-        float Distance = (GetAnchorLocation() - GetActorLocation()).Size();
-        CurrentWireLength = FMath::Clamp(Distance + ExtendSpeed * GetWorld()->GetDeltaSeconds(), 100.0f, WireMaxLength);
-    }
+    GetWireMovement()->SetWantsToExtend(true);
+}
+
+
+void AWireCharacter::StopExtendWire()
+{
+    GetWireMovement()->SetWantsToExtend(false);
 }
 
 
@@ -317,7 +436,11 @@ void AWireCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompo
 
         //ワイヤー巻き取り・伸ばし
         EnhancedInputComponent->BindAction(RetractWireAction, ETriggerEvent::Triggered, this, &AWireCharacter::RetractWire);
+        EnhancedInputComponent->BindAction(RetractWireAction, ETriggerEvent::Completed, this, &AWireCharacter::StopRetractWire);
+        EnhancedInputComponent->BindAction(RetractWireAction, ETriggerEvent::Canceled, this, &AWireCharacter::StopRetractWire);
         EnhancedInputComponent->BindAction(ExtendWireAction, ETriggerEvent::Triggered, this, &AWireCharacter::ExtendWire);
+        EnhancedInputComponent->BindAction(ExtendWireAction, ETriggerEvent::Completed, this, &AWireCharacter::StopExtendWire);
+        EnhancedInputComponent->BindAction(ExtendWireAction, ETriggerEvent::Canceled, this, &AWireCharacter::StopExtendWire);
     }
 }
 
@@ -0,0 +1,534 @@
+﻿#include "WireCharacterMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "Engine/World.h"
+#include "WireStats.h"
+#include "WireNetSerialization.h"
+
+
+UWireCharacterMovementComponent::UWireCharacterMovementComponent()
+{
+    // 接続を始める時のアンカーを ServerMove に、サーバーのワイヤーの状態を補正に載せる
+    SetNetworkMoveDataContainer(WireMoveDataContainer);
+    SetMoveResponseDataContainer(WireMoveResponseDataContainer);
+}
+
+
+void UWireCharacterMovementComponent::OnRegister()
+{
+    Super::OnRegister();
+
+    // ワイヤーの演算はオーナーの UWireTetherComponent のソルバーで行う（無ければワイヤーを使わない）
+    WireTether = GetOwner() ? GetOwner()->FindComponentByClass<UWireTetherComponent>() : nullptr;
+    if (!WireTether && GetOwner() && !GetOwner()->IsTemplate())
+    {
+        UE_LOG(LogWire, Error, TEXT("%s has no UWireTetherComponent, wire movement is disabled"), *GetNameSafe(GetOwner()));
+    }
+}
+
+
+const FWireSolver& UWireCharacterMovementComponent::GetWireSolver() const
+{
+    static const FWireSolver EmptySolver;
+    return WireTether ? WireTether->GetSolver() : EmptySolver;
+}
+
+
+void UWireCharacterMovementComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    ApplySolverSettings();
+}
+
+
+void UWireCharacterMovementComponent::ApplySolverSettings()
+{
+    FWireSolver* WireSolver = GetMutableWireSolver();
+    if (!WireSolver)
+        return;
+
+    // 重力は PhysSwinging で CharacterMovement の値に合わせる
+    FWireSolverSettings SolverSettings = WireSolver->GetSettings();
+    SolverSettings.bUseXPBD = bUseXPBDTether;
+    SolverSettings.Compliance = WireCompliance;
+    SolverSettings.PullStrength = WirePullStrength;
+    SolverSettings.FixedTimeStep = 1.0f / SimulationRate;
+    WireSolver->SetSettings(SolverSettings);
+}
+
+
+FNetworkPredictionData_Client* UWireCharacterMovementComponent::GetPredictionData_Client() const
+{
+    if (ClientPredictionData == nullptr)
+    {
+        UWireCharacterMovementComponent* MutableThis = const_cast<UWireCharacterMovementComponent*>(this);
+        MutableThis->ClientPredictionData = new FWireNetworkPredictionData_Client(*this);
+    }
+    return ClientPredictionData;
+}
+
+
+FString UWireCharacterMovementComponent::GetMovementName() const
+{
+    if (IsSwinging())
+    {
+        return TEXT("Swinging");
+    }
+    return Super::GetMovementName();
+}
+
+
+void UWireCharacterMovementComponent::AttachWire(const FVector& Anchor, USceneComponent* InAnchorComponent)
+{
+    FWireSolver* WireSolver = GetMutableWireSolver();
+    if (!WireSolver)
+        return;
+
+    // 接続時にワイヤー長を現在の距離に設定
+    WireSolver->Attach(0, Anchor, UpdatedComponent->GetComponentLocation());
+    AnchorComponent = InAnchorComponent;
+    AnchorOffset = InAnchorComponent ? InAnchorComponent->GetComponentTransform().InverseTransformPosition(Anchor) : FVector::ZeroVector;
+}
+
+
+void UWireCharacterMovementComponent::DetachWire()
+{
+    if (FWireSolver* WireSolver = GetMutableWireSolver())
+        WireSolver->Detach(0);
+    AnchorComponent = nullptr;
+}
+
+
+void UWireCharacterMovementComponent::SetWireState(bool bAttached, const FVector& Anchor, float Length)
+{
+    FWireSolver* WireSolver = GetMutableWireSolver();
+    if (!WireSolver)
+        return;
+
+    if (!bAttached)
+    {
+        WireSolver->Detach(0);
+        return;
+    }
+
+    FWireTether& Tether = WireSolver->GetTether(0);
+    if (!Tether.bAttached)
+    {
+        WireSolver->Attach(0, Anchor, UpdatedComponent->GetComponentLocation());
+    }
+    Tether.Anchor = Anchor;
+    Tether.CurrentLength = FMath::Clamp(Length, MinWireLength, MaxWireLength);
+}
+
+
+void UWireCharacterMovementComponent::ApplyWireIntent(bool bWantsAttached, const FVector& Anchor, bool bValidateAnchor)
+{
+    FWireSolver* WireSolver = GetMutableWireSolver();
+    if (!WireSolver || bWantsAttached == IsWireAttached())
+        return;
+
+    // 自分の入力の再生では接続した時のアンカーとコンポーネントをそのまま使う
+    if (!bValidateAnchor)
+    {
+        if (bWantsAttached)
+            WireSolver->Attach(0, Anchor, UpdatedComponent->GetComponentLocation());
+        else
+            WireSolver->Detach(0);
+        return;
+    }
+
+    if (!bWantsAttached)
+    {
+        DetachWire();
+        return;
+    }
+
+    // サーバーは自分のトレースで当たった点に接続する（面が無ければ接続せず、クライアントは補正される）
+    FHitResult Hit;
+    if (!ValidateAnchor(Anchor, Hit))
+    {
+        if (FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character())
+            ServerData->bForceClientUpdate = true;
+        return;
+    }
+
+    UPrimitiveComponent* HitComponent = Hit.GetComponent();
+    AttachWire(Hit.ImpactPoint, HitComponent && HitComponent->Mobility == EComponentMobility::Movable ? HitComponent : nullptr);
+}
+
+
+bool UWireCharacterMovementComponent::ValidateAnchor(const FVector& Anchor, FHitResult& OutHit) const
+{
+    const FVector Start = UpdatedComponent->GetComponentLocation();
+    const FVector ToAnchor = Anchor - Start;
+    const float Distance = ToAnchor.Size();
+    if (Distance < KINDA_SMALL_NUMBER || Distance > MaxWireLength + MaxAnchorDistanceError)
+        return false;
+
+    // アンカーの少し先までトレースし、当たった点がアンカーの近くなら面があるとみなす
+    FCollisionQueryParams Params(SCENE_QUERY_STAT(WireValidateAnchor), false, GetOwner());
+    const FVector End = Anchor + ToAnchor / Distance * MaxAnchorSurfaceError;
+
+    WIRE_COUNT_TRACE();
+    return GetWorld()->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, Params)
+        && FVector::DistSquared(OutHit.ImpactPoint, Anchor) <= FMath::Square(MaxAnchorSurfaceError);
+}
+
+
+bool UWireCharacterMovementComponent::IsPulledUpward() const
+{
+    const FWireTether& Tether = GetWireSolver().GetTether(0);
+    if (!Tether.bAttached)
+        return false;
+
+    const FVector ToPivot = Tether.GetPivot() - UpdatedComponent->GetComponentLocation();
+    return ToPivot.Size() > Tether.GetFreeLength() && ToPivot.GetSafeNormal().Z > LiftOffDirectionZ;
+}
+
+
+void UWireCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+    Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+    FWireSolver* WireSolver = GetMutableWireSolver();
+    if (!WireSolver)
+        return;
+
+    FWireTether& Tether = WireSolver->GetTether(0);
+    const FVector Location = UpdatedComponent->GetComponentLocation();
+
+    if (Tether.bAttached)
+    {
+        // Movable なアンカーは毎回位置を更新
+        if (AnchorComponent.IsValid())
+        {
+            Tether.Anchor = AnchorComponent->GetComponentTransform().TransformPosition(AnchorOffset);
+        }
+
+        // ワイヤーの巻き取り・伸ばし
+        if (bWantsToRetract || bWantsToExtend)
+        {
+            const float ReelSpeed = (bWantsToExtend ? ExtendSpeed : 0.0f) - (bWantsToRetract ? RetractSpeed : 0.0f);
+            WireSolver->ReelWire(0, Location, ReelSpeed * DeltaSeconds, MinWireLength, MaxWireLength);
+        }
+    }
+
+    if (IsSwinging())
+    {
+        // 切断されたら落下へ
+        if (!Tether.bAttached)
+        {
+            SetMovementMode(MOVE_Falling);
+        }
+    }
+    else if (Tether.bAttached)
+    {
+        // 空中、または地上で上に引っ張られていればスイングを開始
+        if (IsFalling() || (IsMovingOnGround() && IsPulledUpward()))
+        {
+            SetMovementMode(MOVE_Custom, CMOVE_Swinging);
+        }
+        else if (IsMovingOnGround())
+        {
+            // 地上ではワイヤーが張っている間、アンカーから離れる向きの速度と加速度を打ち消す
+            const FVector ToPivot = Tether.GetPivot() - Location;
+            if (ToPivot.Size() > Tether.GetFreeLength())
+            {
+                const FVector Direction = ToPivot.GetSafeNormal();
+                Velocity -= Direction * FMath::Min(FVector::DotProduct(Velocity, Direction), 0.0f);
+                Acceleration -= Direction * FMath::Min(FVector::DotProduct(Acceleration, Direction), 0.0f);
+            }
+        }
+    }
+}
+
+
+void UWireCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+    if (CustomMovementMode == CMOVE_Swinging)
+    {
+        PhysSwinging(deltaTime, Iterations);
+    }
+
+    Super::PhysCustom(deltaTime, Iterations);
+}
+
+
+void UWireCharacterMovementComponent::PhysSwinging(float deltaTime, int32 Iterations)
+{
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireCharacterUpdateWireMovement, WireCharacterUpdateWireMovement);
+
+    if (deltaTime < MIN_TICK_TIME)
+        return;
+
+    FWireSolver* WireSolverPtr = GetMutableWireSolver();
+    if (!WireSolverPtr)
+    {
+        SetMovementMode(MOVE_Falling);
+        StartNewPhysics(deltaTime, Iterations);
+        return;
+    }
+    FWireSolver& WireSolver = *WireSolverPtr;
+
+    // 重力は CharacterMovement の値をソルバーで扱う
+    const float Gravity = -GetGravityZ();
+    if (WireSolver.GetSettings().Gravity != Gravity)
+    {
+        FWireSolverSettings SolverSettings = WireSolver.GetSettings();
+        SolverSettings.Gravity = Gravity;
+        WireSolver.SetSettings(SolverSettings);
+    }
+
+    float RemainingTime = deltaTime;
+    while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations && IsSwinging())
+    {
+        Iterations++;
+        const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+        RemainingTime -= TimeTick;
+
+        const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+
+        // 空中制御（水平方向の入力のみ）
+        const FVector HorizontalAcceleration(Acceleration.X, Acceleration.Y, 0.0f);
+        Velocity += GetAirControl(TimeTick, AirControl, HorizontalAcceleration) * TimeTick;
+
+        // 重力・外方向の速度の打ち消し・引き寄せをソルバーで演算
+        WireSolver.SetVelocity(Velocity);
+        const FWireSolverStepResult StepResult = WireSolver.StepSubdivided(TimeTick, MakeArrayView(&OldLocation, 1));
+        WireStats::RecordPullMagnitude(StepResult.PullAcceleration.Size());
+        Velocity = WireSolver.GetVelocity();
+
+        FHitResult Hit(1.0f);
+        SafeMoveUpdatedComponent(StepResult.Displacement, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+        if (Hit.IsValidBlockingHit())
+        {
+            // 上に引っ張られていなければ着地
+            if (IsValidLandingSpot(UpdatedComponent->GetComponentLocation(), Hit) && !IsPulledUpward())
+            {
+                RemainingTime += TimeTick * (1.0f - Hit.Time);
+                ProcessLanded(Hit, RemainingTime, Iterations);
+                return;
+            }
+
+            HandleImpact(Hit, TimeTick, StepResult.Displacement);
+            SlideAlongSurface(StepResult.Displacement, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+
+            // 面に向かう速度を打ち消す
+            if (FVector::DotProduct(Velocity, Hit.Normal) < 0.0f)
+            {
+                Velocity = FVector::VectorPlaneProject(Velocity, Hit.Normal);
+            }
+        }
+    }
+
+    // 途中で切断・モード変更されたら残りの時間を新しいモードで処理
+    if (!IsSwinging() && RemainingTime >= MIN_TICK_TIME)
+    {
+        StartNewPhysics(RemainingTime, Iterations);
+    }
+}
+
+
+void UWireCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+    // サーバーではクライアントから接続したいかだけを受け取る（アンカーは自分で確かめ、長さは巻き取り・伸ばしの入力から計算する）
+    if (const FWireCharacterNetworkMoveData* MoveData = static_cast<const FWireCharacterNetworkMoveData*>(GetCurrentNetworkMoveData()))
+    {
+        ApplyWireIntent((CompressedFlags & FWireSavedMove::FLAG_WireAttached) != 0, MoveData->WireAnchor, true);
+    }
+
+    Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
+
+void UWireCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+    Super::UpdateFromCompressedFlags(Flags);
+
+    bWantsToRetract = (Flags & FWireSavedMove::FLAG_WantsToRetract) != 0;
+    bWantsToExtend = (Flags & FWireSavedMove::FLAG_WantsToExtend) != 0;
+}
+
+
+void UWireCharacterMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+    Super::ClientHandleMoveResponse(MoveResponse);
+
+    if (MoveResponse.IsGoodMove())
+        return;
+
+    // 受け付けられた補正ならサーバーのワイヤーの状態から再生し直す
+    FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+    if (!ClientData || !ClientData->LastAckedMove.IsValid() || ClientData->LastAckedMove->TimeStamp != MoveResponse.ClientAdjustment.TimeStamp)
+        return;
+
+    const FWireCharacterMoveResponseDataContainer& WireResponse = static_cast<const FWireCharacterMoveResponseDataContainer&>(MoveResponse);
+    SetWireState(WireResponse.bWireAttached, WireResponse.WireAnchor, WireResponse.WireLength);
+
+    // サーバーが接続を受け付けなかったら、その接続のまま保存した移動からも接続したい意図を外す
+    const FWireSavedMove* AckedMove = static_cast<const FWireSavedMove*>(ClientData->LastAckedMove.Get());
+    if (WireResponse.bWireAttached || !AckedMove->bSavedWireAttached)
+        return;
+
+    for (FSavedMovePtr& SavedMove : ClientData->SavedMoves)
+    {
+        FWireSavedMove* WireMove = static_cast<FWireSavedMove*>(SavedMove.Get());
+        if (!WireMove->bSavedWireAttached)
+            break;
+        WireMove->bSavedWireAttached = false;
+    }
+    if (ClientData->PendingMove.IsValid())
+        static_cast<FWireSavedMove*>(ClientData->PendingMove.Get())->bSavedWireAttached = false;
+}
+
+
+void FWireSavedMove::Clear()
+{
+    Super::Clear();
+
+    bSavedWantsToRetract = false;
+    bSavedWantsToExtend = false;
+    bSavedWireAttached = false;
+    SavedWireAnchor = FVector::ZeroVector;
+}
+
+
+uint8 FWireSavedMove::GetCompressedFlags() const
+{
+    uint8 Result = Super::GetCompressedFlags();
+
+    if (bSavedWantsToRetract)
+        Result |= FLAG_WantsToRetract;
+    if (bSavedWantsToExtend)
+        Result |= FLAG_WantsToExtend;
+    if (bSavedWireAttached)
+        Result |= FLAG_WireAttached;
+
+    return Result;
+}
+
+
+bool FWireSavedMove::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+    const FWireSavedMove* WireMove = static_cast<const FWireSavedMove*>(NewMove.Get());
+
+    // ワイヤー接続中はスイングの結果が移動の区切りに左右されるのでまとめない
+    if (bSavedWireAttached || WireMove->bSavedWireAttached)
+        return false;
+
+    if (bSavedWantsToRetract != WireMove->bSavedWantsToRetract || bSavedWantsToExtend != WireMove->bSavedWantsToExtend)
+        return false;
+
+    return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+
+void FWireSavedMove::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+    Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+    // 移動開始時の入力と接続の有無・アンカーを保存
+    if (const UWireCharacterMovementComponent* Movement = Cast<UWireCharacterMovementComponent>(C->GetCharacterMovement()))
+    {
+        const FWireTether& Tether = Movement->GetWireSolver().GetTether(0);
+        bSavedWantsToRetract = Movement->bWantsToRetract;
+        bSavedWantsToExtend = Movement->bWantsToExtend;
+        bSavedWireAttached = Tether.bAttached;
+        SavedWireAnchor = Tether.Anchor;
+    }
+}
+
+
+void FWireSavedMove::PrepMoveFor(ACharacter* C)
+{
+    Super::PrepMoveFor(C);
+
+    // 再生前に移動開始時の入力と接続の有無を戻す（長さは補正後の状態から巻き取り・伸ばしで計算し直す）
+    if (UWireCharacterMovementComponent* Movement = Cast<UWireCharacterMovementComponent>(C->GetCharacterMovement()))
+    {
+        Movement->bWantsToRetract = bSavedWantsToRetract;
+        Movement->bWantsToExtend = bSavedWantsToExtend;
+        Movement->ApplyWireIntent(bSavedWireAttached, SavedWireAnchor, false);
+    }
+}
+
+
+FWireNetworkPredictionData_Client::FWireNetworkPredictionData_Client(const UCharacterMovementComponent& ClientMovement)
+    : Super(ClientMovement)
+{
+}
+
+
+FSavedMovePtr FWireNetworkPredictionData_Client::AllocateNewMove()
+{
+    return FSavedMovePtr(new FWireSavedMove());
+}
+
+
+void FWireCharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+    Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+    const FWireSavedMove& WireMove = static_cast<const FWireSavedMove&>(ClientMove);
+    WireAnchor = WireMove.SavedWireAnchor;
+}
+
+
+bool FWireCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+    Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+    // 未接続ならアンカーは送らない
+    if (CompressedMoveFlags & FWireSavedMove::FLAG_WireAttached)
+    {
+        bool bLocalSuccess = true;
+        WireAnchor.NetSerialize(Ar, PackageMap, bLocalSuccess);
+    }
+    else if (Ar.IsLoading())
+    {
+        WireAnchor = FVector::ZeroVector;
+    }
+
+    return !Ar.IsError();
+}
+
+
+FWireCharacterNetworkMoveDataContainer::FWireCharacterNetworkMoveDataContainer()
+{
+    NewMoveData = &WireMoveData[0];
+    PendingMoveData = &WireMoveData[1];
+    OldMoveData = &WireMoveData[2];
+}
+
+
+void FWireCharacterMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+    Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+    const UWireCharacterMovementComponent& WireMovement = static_cast<const UWireCharacterMovementComponent&>(CharacterMovement);
+    bWireAttached = WireMovement.IsWireAttached();
+    WireLength = WireMovement.GetWireLength();
+    WireAnchor = WireMovement.GetWireAnchor();
+}
+
+
+bool FWireCharacterMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+    if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+        return false;
+
+    // 補正の時だけ送る（未接続なら 1bit のみ）
+    if (!IsGoodMove())
+    {
+        WireNetSerialization::SerializeBit(Ar, bWireAttached);
+        if (bWireAttached)
+        {
+            bool bLocalSuccess = true;
+            WireNetSerialization::SerializeLength(Ar, WireLength);
+            WireAnchor.NetSerialize(Ar, PackageMap, bLocalSuccess);
+        }
+    }
+
+    return !Ar.IsError();
+}
@@ -0,0 +1,160 @@
+﻿#include "WireGhost.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SplineMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInterface.h"
+#include "UObject/ConstructorHelpers.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "Misc/Paths.h"
+#include "WireStats.h"
+
+
+AWireGhost::AWireGhost()
+{
+    PrimaryActorTick.bCanEverTick = true;
+    SetActorEnableCollision(false);
+
+    RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+    Head = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Head"));
+    Head->SetupAttachment(RootComponent);
+    Hand_L = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Hand_L"));
+    Hand_L->SetupAttachment(RootComponent);
+    Hand_R = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Hand_R"));
+    Hand_R->SetupAttachment(RootComponent);
+    Wire_L = CreateDefaultSubobject<USplineMeshComponent>(TEXT("Wire_L"));
+    Wire_L->SetupAttachment(RootComponent);
+    Wire_R = CreateDefaultSubobject<USplineMeshComponent>(TEXT("Wire_R"));
+    Wire_R->SetupAttachment(RootComponent);
+
+    for (UPrimitiveComponent* Component : { (UPrimitiveComponent*)Head, (UPrimitiveComponent*)Hand_L, (UPrimitiveComponent*)Hand_R, (UPrimitiveComponent*)Wire_L, (UPrimitiveComponent*)Wire_R })
+    {
+        SetupVisualOnly(Component);
+    }
+
+    // 既定の見た目（Blueprint で差し替えなくても見えるよう、エンジンの基本形状を使う）
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> SphereMesh(TEXT("/Engine/BasicShapes/Sphere.Sphere"));
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> CylinderMesh(TEXT("/Engine/BasicShapes/Cylinder.Cylinder"));
+    static ConstructorHelpers::FObjectFinder<UMaterialInterface> ShapeMaterial(TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
+    for (UStaticMeshComponent* Component : { Head, Hand_L, Hand_R })
+    {
+        Component->SetStaticMesh(SphereMesh.Object);
+        Component->SetMaterial(0, ShapeMaterial.Object);
+    }
+    Head->SetRelativeScale3D(FVector(0.25f));
+    Hand_L->SetRelativeScale3D(FVector(0.1f));
+    Hand_R->SetRelativeScale3D(FVector(0.1f));
+
+    // ワイヤーは円柱を Z 軸に沿って伸ばす（直径 100cm の円柱を 2cm に）
+    for (USplineMeshComponent* Wire : { Wire_L, Wire_R })
+    {
+        Wire->SetStaticMesh(CylinderMesh.Object);
+        Wire->SetMaterial(0, ShapeMaterial.Object);
+        Wire->SetForwardAxis(ESplineMeshAxis::Z, false);
+        Wire->SetStartScale(FVector2D(0.02f), false);
+        Wire->SetEndScale(FVector2D(0.02f), false);
+    }
+
+    // ワイヤーはワールド座標で描く
+    Wire_L->SetUsingAbsoluteLocation(true);
+    Wire_L->SetUsingAbsoluteRotation(true);
+    Wire_R->SetUsingAbsoluteLocation(true);
+    Wire_R->SetUsingAbsoluteRotation(true);
+    Wire_L->SetVisibility(false);
+    Wire_R->SetVisibility(false);
+}
+
+
+void AWireGhost::SetupVisualOnly(UPrimitiveComponent* Component)
+{
+    Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Component->SetGenerateOverlapEvents(false);
+    Component->SetCastShadow(false);
+    Component->CanCharacterStepUpOn = ECB_No;
+}
+
+
+AWireGhost* AWireGhost::SpawnGhost(UObject* WorldContextObject, const FString& Name, TSubclassOf<AWireGhost> GhostClass)
+{
+    UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+    if (!World)
+        return nullptr;
+
+    // 読み込めなければ生成しない
+    const FString FilePath = FWireGhostRecorder::GetGhostFilePath(Name);
+    if (!FPaths::FileExists(FilePath))
+        return nullptr;
+
+    AWireGhost* Ghost = World->SpawnActor<AWireGhost>(GhostClass ? *GhostClass : StaticClass());
+    if (Ghost && !Ghost->LoadGhost(FilePath))
+    {
+        Ghost->Destroy();
+        return nullptr;
+    }
+    return Ghost;
+}
+
+
+bool AWireGhost::LoadGhost(const FString& FilePath)
+{
+    if (!Track.LoadFromFile(FilePath))
+    {
+        UE_LOG(LogWire, Warning, TEXT("Failed to load ghost %s"), *FilePath);
+        return false;
+    }
+
+    Restart();
+    return true;
+}
+
+
+void AWireGhost::Restart()
+{
+    PlaybackTime = 0.0f;
+    SetActorTickEnabled(!Track.IsEmpty());
+}
+
+
+void AWireGhost::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    if (Track.IsEmpty())
+        return;
+
+    PlaybackTime += DeltaSeconds;
+    if (PlaybackTime > Track.GetDuration())
+    {
+        if (!bLoop)
+        {
+            // 最後の姿勢で止める
+            SetActorTickEnabled(false);
+            PlaybackTime = Track.GetDuration();
+        }
+        else
+        {
+            PlaybackTime = 0.0f;
+        }
+    }
+
+    FWireGhostSample Sample;
+    Track.Evaluate(PlaybackTime, Sample);
+
+    SetActorLocation(Sample.PawnLocation);
+    Head->SetWorldLocationAndRotation(Sample.HeadLocation, Sample.HeadRotation);
+
+    UStaticMeshComponent* Hands[2] = { Hand_L, Hand_R };
+    USplineMeshComponent* Wires[2] = { Wire_L, Wire_R };
+    for (int32 i = 0; i < 2; ++i)
+    {
+        Hands[i]->SetWorldLocationAndRotation(Sample.HandLocation[i], Sample.HandRotation[i]);
+
+        // ワイヤーは手からアンカーへの直線
+        const bool bAttached = Sample.IsAttached(i);
+        if (bAttached)
+            Wires[i]->SetStartAndEnd(Sample.HandLocation[i], FVector::ZeroVector, Sample.Anchor[i], FVector::ZeroVector);
+        if (Wires[i]->IsVisible() != bAttached)
+            Wires[i]->SetVisibility(bAttached);
+    }
+}
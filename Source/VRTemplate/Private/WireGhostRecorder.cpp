@@ -0,0 +1,416 @@
+﻿#include "WireGhostRecorder.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Event.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "WireStats.h"
+
+namespace
+{
+    // 位置は 1mm 単位
+    constexpr float GhostLocationScale = 10.0f;
+
+    // 角度は 1周 = 65536
+    constexpr float GhostRotationScale = 65536.0f / 360.0f;
+
+    // ゴーストファイルの拡張子
+    const TCHAR* GhostFileExtension = TEXT(".wghost");
+
+    // 書き込みスレッドが待つ最大時間 (ms)
+    constexpr uint32 WriterWaitMs = 100;
+
+    // 符号付き整数を小さい絶対値ほど短くなる符号なし整数へ
+    uint32 ZigZag(int32 Value) { return ((uint32)Value << 1) ^ (uint32)(Value >> 31); }
+    int32 UnZigZag(uint32 Value) { return (int32)(Value >> 1) ^ -(int32)(Value & 1); }
+
+    void SerializeSigned(FArchive& Ar, int32& Value)
+    {
+        uint32 Packed = Ar.IsSaving() ? ZigZag(Value) : 0;
+        Ar.SerializeIntPacked(Packed);
+        if (Ar.IsLoading())
+            Value = UnZigZag(Packed);
+    }
+
+    // Predicted との差を書く・読む
+    void SerializeResidual(FArchive& Ar, FIntVector& Value, const FIntVector& Predicted)
+    {
+        FIntVector Residual = Value - Predicted;
+        SerializeSigned(Ar, Residual.X);
+        SerializeSigned(Ar, Residual.Y);
+        SerializeSigned(Ar, Residual.Z);
+        if (Ar.IsLoading())
+            Value = Predicted + Residual;
+    }
+
+    // 角度の差は 16bit で回り込む
+    void SerializeRotationDelta(FArchive& Ar, FIntVector& Value, const FIntVector& Prev)
+    {
+        FIntVector Delta = Value - Prev;
+        Delta.X = (int16)Delta.X;
+        Delta.Y = (int16)Delta.Y;
+        Delta.Z = (int16)Delta.Z;
+        SerializeSigned(Ar, Delta.X);
+        SerializeSigned(Ar, Delta.Y);
+        SerializeSigned(Ar, Delta.Z);
+        if (Ar.IsLoading())
+            Value = FIntVector((uint16)(Prev.X + Delta.X), (uint16)(Prev.Y + Delta.Y), (uint16)(Prev.Z + Delta.Z));
+    }
+
+    FIntVector QuantizeLocation(const FVector& Location)
+    {
+        return FIntVector(
+            FMath::RoundToInt32(Location.X * GhostLocationScale),
+            FMath::RoundToInt32(Location.Y * GhostLocationScale),
+            FMath::RoundToInt32(Location.Z * GhostLocationScale));
+    }
+
+    FVector DequantizeLocation(const FIntVector& Value)
+    {
+        return FVector(Value) / GhostLocationScale;
+    }
+
+    FIntVector QuantizeRotation(const FRotator& Rotation)
+    {
+        return FIntVector(
+            FMath::RoundToInt32(FRotator::ClampAxis(Rotation.Pitch) * GhostRotationScale) & 0xFFFF,
+            FMath::RoundToInt32(FRotator::ClampAxis(Rotation.Yaw) * GhostRotationScale) & 0xFFFF,
+            FMath::RoundToInt32(FRotator::ClampAxis(Rotation.Roll) * GhostRotationScale) & 0xFFFF);
+    }
+
+    FRotator DequantizeRotation(const FIntVector& Value)
+    {
+        return FRotator(Value.X / GhostRotationScale, Value.Y / GhostRotationScale, Value.Z / GhostRotationScale);
+    }
+}
+
+
+void FWireGhostCodec::SerializeHeader(FArchive& Ar, float& SampleRate)
+{
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    Ar << FileMagic;
+    Ar << FileVersion;
+    Ar << SampleRate;
+
+    if (Ar.IsLoading() && (FileMagic != Magic || FileVersion != Version))
+        Ar.SetError();
+}
+
+
+FWireGhostCodec::FState FWireGhostCodec::Quantize(const FWireGhostSample& Sample)
+{
+    // 頭と手は Pawn からの相対位置（値が小さく、変化も小さい）
+    FState State;
+    State.TimeMs = FMath::RoundToInt32(Sample.Time * 1000.0f);
+    State.Pawn = QuantizeLocation(Sample.PawnLocation);
+    State.Head = QuantizeLocation(Sample.HeadLocation - Sample.PawnLocation);
+    State.HeadRotation = QuantizeRotation(Sample.HeadRotation);
+    for (int32 i = 0; i < 2; ++i)
+    {
+        State.Hand[i] = QuantizeLocation(Sample.HandLocation[i] - Sample.PawnLocation);
+        State.HandRotation[i] = QuantizeRotation(Sample.HandRotation[i]);
+        State.Anchor[i] = Sample.IsAttached(i) ? QuantizeLocation(Sample.Anchor[i]) : FIntVector::ZeroValue;
+    }
+    State.AttachedMask = Sample.AttachedMask & 0x3;
+    return State;
+}
+
+
+FWireGhostSample FWireGhostCodec::Dequantize(const FState& State)
+{
+    FWireGhostSample Sample;
+    Sample.Time = State.TimeMs / 1000.0f;
+    Sample.PawnLocation = DequantizeLocation(State.Pawn);
+    Sample.HeadLocation = Sample.PawnLocation + DequantizeLocation(State.Head);
+    Sample.HeadRotation = DequantizeRotation(State.HeadRotation);
+    for (int32 i = 0; i < 2; ++i)
+    {
+        Sample.HandLocation[i] = Sample.PawnLocation + DequantizeLocation(State.Hand[i]);
+        Sample.HandRotation[i] = DequantizeRotation(State.HandRotation[i]);
+        Sample.Anchor[i] = DequantizeLocation(State.Anchor[i]);
+    }
+    Sample.AttachedMask = State.AttachedMask;
+    return Sample;
+}
+
+
+void FWireGhostCodec::Encode(FArchive& Ar, const FWireGhostSample& Sample)
+{
+    FState State = Quantize(Sample);
+
+    // 下位2bit が接続状態、その上がアンカーの変化
+    uint8 Flags = State.AttachedMask;
+    for (int32 i = 0; i < 2; ++i)
+    {
+        if ((State.AttachedMask & (1 << i)) && (!(Prev.AttachedMask & (1 << i)) || State.Anchor[i] != Prev.Anchor[i] || NumCoded == 0))
+            Flags |= 1 << (2 + i);
+    }
+    Ar << Flags;
+
+    int32 DeltaMs = State.TimeMs - Prev.TimeMs;
+    SerializeSigned(Ar, DeltaMs);
+
+    // Pawn は等速とみなした予測との差
+    const FIntVector Predicted = NumCoded >= 2 ? Prev.Pawn * 2 - PrevPrev.Pawn : Prev.Pawn;
+    SerializeResidual(Ar, State.Pawn, Predicted);
+    SerializeResidual(Ar, State.Head, Prev.Head);
+    SerializeRotationDelta(Ar, State.HeadRotation, Prev.HeadRotation);
+    for (int32 i = 0; i < 2; ++i)
+    {
+        SerializeResidual(Ar, State.Hand[i], Prev.Hand[i]);
+        SerializeRotationDelta(Ar, State.HandRotation[i], Prev.HandRotation[i]);
+    }
+
+    // アンカーは変わった時だけ Pawn からの相対位置で書く
+    for (int32 i = 0; i < 2; ++i)
+    {
+        if (Flags & (1 << (2 + i)))
+            SerializeResidual(Ar, State.Anchor[i], State.Pawn);
+    }
+
+    PrevPrev = Prev;
+    Prev = State;
+    ++NumCoded;
+}
+
+
+bool FWireGhostCodec::Decode(FArchive& Ar, FWireGhostSample& OutSample)
+{
+    FState State;
+
+    uint8 Flags = 0;
+    Ar << Flags;
+    State.AttachedMask = Flags & 0x3;
+
+    int32 DeltaMs = 0;
+    SerializeSigned(Ar, DeltaMs);
+    State.TimeMs = Prev.TimeMs + DeltaMs;
+
+    const FIntVector Predicted = NumCoded >= 2 ? Prev.Pawn * 2 - PrevPrev.Pawn : Prev.Pawn;
+    SerializeResidual(Ar, State.Pawn, Predicted);
+    SerializeResidual(Ar, State.Head, Prev.Head);
+    SerializeRotationDelta(Ar, State.HeadRotation, Prev.HeadRotation);
+    for (int32 i = 0; i < 2; ++i)
+    {
+        SerializeResidual(Ar, State.Hand[i], Prev.Hand[i]);
+        SerializeRotationDelta(Ar, State.HandRotation[i], Prev.HandRotation[i]);
+    }
+
+    for (int32 i = 0; i < 2; ++i)
+    {
+        if (Flags & (1 << (2 + i)))
+            SerializeResidual(Ar, State.Anchor[i], State.Pawn);
+        else if (State.AttachedMask & (1 << i))
+            State.Anchor[i] = Prev.Anchor[i];
+    }
+
+    if (Ar.IsError())
+        return false;
+
+    PrevPrev = Prev;
+    Prev = State;
+    ++NumCoded;
+
+    OutSample = Dequantize(State);
+    return true;
+}
+
+
+FWireGhostRecorder::FWireGhostRecorder(const FString& InFilePath, float InSampleRate, uint32 Capacity)
+    : FilePath(InFilePath)
+    , SampleRate(FMath::Max(InSampleRate, 1.0f))
+    , Queue(Capacity)
+{
+}
+
+
+FWireGhostRecorder::~FWireGhostRecorder()
+{
+    Finish();
+}
+
+
+FString FWireGhostRecorder::GetGhostFilePath(const FString& Name)
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Ghosts"), Name + GhostFileExtension);
+}
+
+
+bool FWireGhostRecorder::Start()
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+    FileHandle.Reset(PlatformFile.OpenWrite(*FilePath));
+    if (!FileHandle)
+    {
+        UE_LOG(LogWire, Warning, TEXT("Failed to open ghost file %s"), *FilePath);
+        return false;
+    }
+
+    // ヘッダーを書いてから書き込みスレッドを開始
+    FMemoryWriter Writer(EncodeBuffer);
+    FWireGhostCodec::SerializeHeader(Writer, SampleRate);
+    FileHandle->Write(EncodeBuffer.GetData(), EncodeBuffer.Num());
+    EncodeBuffer.Reset();
+
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("WireGhostWriter"), 0, TPri_BelowNormal);
+    return Thread != nullptr;
+}
+
+
+void FWireGhostRecorder::Finish()
+{
+    if (Thread)
+    {
+        Stop();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+    }
+
+    if (WakeEvent)
+    {
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+
+    if (FileHandle)
+    {
+        // スレッドが止まった後に残ったサンプルを書き切る
+        Flush();
+        FileHandle->Flush();
+        FileHandle.Reset();
+
+        if (NumDropped > 0)
+            UE_LOG(LogWire, Warning, TEXT("Ghost %s dropped %u samples"), *FilePath, NumDropped);
+    }
+}
+
+
+bool FWireGhostRecorder::ShouldRecord(float DeltaTime)
+{
+    ElapsedTime += DeltaTime;
+    SampleTimer += DeltaTime;
+
+    const float Interval = 1.0f / SampleRate;
+    if (SampleTimer < Interval)
+        return false;
+
+    // ヒッチ後にまとめて記録しないよう余りは1回分まで
+    SampleTimer = FMath::Min(SampleTimer - Interval, Interval);
+    return true;
+}
+
+
+void FWireGhostRecorder::Record(const FWireGhostSample& Sample)
+{
+    // 書き込みが追いつかず満杯なら捨てる（ゲームスレッドは待たない）
+    if (!Queue.Enqueue(Sample))
+        ++NumDropped;
+}
+
+
+uint32 FWireGhostRecorder::Run()
+{
+    while (!bStopping)
+    {
+        WakeEvent->Wait(WriterWaitMs);
+        Flush();
+    }
+    return 0;
+}
+
+
+void FWireGhostRecorder::Stop()
+{
+    bStopping = true;
+    if (WakeEvent)
+        WakeEvent->Trigger();
+}
+
+
+void FWireGhostRecorder::Flush()
+{
+    FWireGhostSample Sample;
+    FMemoryWriter Writer(EncodeBuffer);
+    while (Queue.Dequeue(Sample))
+    {
+        Codec.Encode(Writer, Sample);
+    }
+
+    if (EncodeBuffer.Num() > 0)
+    {
+        FileHandle->Write(EncodeBuffer.GetData(), EncodeBuffer.Num());
+        EncodeBuffer.Reset();
+    }
+}
+
+
+bool FWireGhostTrack::LoadFromFile(const FString& FilePath)
+{
+    Samples.Reset();
+    LastIndex = 0;
+
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *FilePath, FILEREAD_Silent))
+        return false;
+
+    FMemoryReader Reader(Data);
+    float SampleRate = 0.0f;
+    FWireGhostCodec::SerializeHeader(Reader, SampleRate);
+    if (Reader.IsError())
+    {
+        UE_LOG(LogWire, Warning, TEXT("%s is not a ghost file"), *FilePath);
+        return false;
+    }
+
+    // 書き込み途中で終わったファイルも読めたところまで使う
+    Samples.Reserve(FMath::CeilToInt32(Data.Num() / 16.0f));
+    FWireGhostCodec Codec;
+    FWireGhostSample Sample;
+    while (!Reader.AtEnd() && Codec.Decode(Reader, Sample))
+    {
+        Samples.Add(Sample);
+    }
+
+    return Samples.Num() > 0;
+}
+
+
+void FWireGhostTrack::Evaluate(float Time, FWireGhostSample& OutSample) const
+{
+    if (Samples.Num() == 0)
+        return;
+
+    // 巻き戻されたら先頭から探し直す
+    if (LastIndex >= Samples.Num() || Samples[LastIndex].Time > Time)
+        LastIndex = 0;
+    while (LastIndex + 1 < Samples.Num() && Samples[LastIndex + 1].Time <= Time)
+        ++LastIndex;
+
+    const FWireGhostSample& A = Samples[LastIndex];
+    if (LastIndex + 1 >= Samples.Num())
+    {
+        OutSample = A;
+        return;
+    }
+
+    const FWireGhostSample& B = Samples[LastIndex + 1];
+    const float Alpha = B.Time > A.Time ? FMath::Clamp((Time - A.Time) / (B.Time - A.Time), 0.0f, 1.0f) : 0.0f;
+
+    OutSample = A;
+    OutSample.Time = Time;
+    OutSample.PawnLocation = FMath::Lerp(A.PawnLocation, B.PawnLocation, Alpha);
+    OutSample.HeadLocation = FMath::Lerp(A.HeadLocation, B.HeadLocation, Alpha);
+    OutSample.HeadRotation = FQuat::Slerp(A.HeadRotation.Quaternion(), B.HeadRotation.Quaternion(), Alpha).Rotator();
+    for (int32 i = 0; i < 2; ++i)
+    {
+        OutSample.HandLocation[i] = FMath::Lerp(A.HandLocation[i], B.HandLocation[i], Alpha);
+        OutSample.HandRotation[i] = FQuat::Slerp(A.HandRotation[i].Quaternion(), B.HandRotation[i].Quaternion(), Alpha).Rotator();
+    }
+}
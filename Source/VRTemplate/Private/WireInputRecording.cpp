@@ -0,0 +1,148 @@
+﻿#include "WireInputRecording.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "WireStats.h"
+
+namespace
+{
+    void SerializeVector(FArchive& Ar, FVector& Vector)
+    {
+        Ar << Vector.X << Vector.Y << Vector.Z;
+    }
+
+    void SerializeRotator(FArchive& Ar, FRotator& Rotator)
+    {
+        Ar << Rotator.Pitch << Rotator.Yaw << Rotator.Roll;
+    }
+
+    void SerializeMove(FArchive& Ar, FVRPawnMove& Move)
+    {
+        Ar << Move.TimeStamp;
+        Ar << Move.DeltaTime;
+        Ar << Move.Flags;
+        Ar << Move.MoveInput.X << Move.MoveInput.Y;
+        for (int32 i = 0; i < 2; ++i)
+        {
+            SerializeVector(Ar, Move.HandLocation[i]);
+            SerializeRotator(Ar, Move.HandRotation[i]);
+        }
+        SerializeVector(Ar, Move.ResultLocation);
+    }
+
+    void SerializeNetState(FArchive& Ar, FVRPawnNetState& State)
+    {
+        Ar << State.TimeStamp;
+        SerializeVector(Ar, State.Location);
+        SerializeVector(Ar, State.Velocity);
+        for (int32 i = 0; i < 2; ++i)
+        {
+            FVRPawnTetherState& Tether = State.Tethers[i];
+            Ar << Tether.bAttached;
+            SerializeVector(Ar, Tether.Anchor);
+            Ar << Tether.CurrentLength;
+            Ar << Tether.AttachLength;
+
+            int32 NumWrapPoints = FMath::Min(Tether.WrapLocations.Num(), Tether.WrapBendAxes.Num());
+            Ar << NumWrapPoints;
+            if (Ar.IsLoading())
+            {
+                NumWrapPoints = FMath::Clamp(NumWrapPoints, 0, 64);
+                Tether.WrapLocations.SetNum(NumWrapPoints);
+                Tether.WrapBendAxes.SetNum(NumWrapPoints);
+            }
+            for (int32 k = 0; k < NumWrapPoints; ++k)
+            {
+                SerializeVector(Ar, Tether.WrapLocations[k]);
+                SerializeVector(Ar, Tether.WrapBendAxes[k]);
+            }
+
+            SerializeVector(Ar, State.HandLocation[i]);
+            SerializeRotator(Ar, State.HandRotation[i]);
+        }
+    }
+}
+
+
+FString FWireInputRecording::GetFilePath(const FString& Name)
+{
+    if (Name.Contains(TEXT("/")) || Name.Contains(TEXT("\\")))
+        return Name;
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputRecordings"), Name + TEXT(".winput"));
+}
+
+
+void FWireInputRecording::Serialize(FArchive& Ar)
+{
+    uint32 FileMagic = Magic;
+    uint32 FileVersion = Version;
+    Ar << FileMagic;
+    Ar << FileVersion;
+    if (Ar.IsLoading() && (FileMagic != Magic || FileVersion != Version))
+    {
+        Ar.SetError();
+        return;
+    }
+
+    Ar << MapName;
+    SerializeRotator(Ar, StartRotation);
+    SerializeNetState(Ar, StartState);
+
+    int32 NumFrames = Frames.Num();
+    Ar << NumFrames;
+    if (Ar.IsLoading())
+    {
+        // 壊れたファイルで巨大な配列を確保しないよう、残りのサイズで上限をかける
+        if (NumFrames < 0 || Ar.IsError() || NumFrames > Ar.TotalSize() - Ar.Tell())
+        {
+            Ar.SetError();
+            return;
+        }
+        Frames.SetNum(NumFrames);
+    }
+
+    for (FWireInputFrame& Frame : Frames)
+    {
+        SerializeMove(Ar, Frame.Move);
+        SerializeVector(Ar, Frame.HeadLocation);
+        SerializeRotator(Ar, Frame.HeadRotation);
+        if (Ar.IsError())
+            return;
+    }
+}
+
+
+bool FWireInputRecording::SaveToFile(const FString& FilePath) const
+{
+    TArray<uint8> Data;
+    FMemoryWriter Writer(Data);
+    const_cast<FWireInputRecording*>(this)->Serialize(Writer);
+
+    if (!FFileHelper::SaveArrayToFile(Data, *FilePath))
+    {
+        UE_LOG(LogWire, Warning, TEXT("Failed to save input recording %s"), *FilePath);
+        return false;
+    }
+
+    UE_LOG(LogWire, Log, TEXT("Saved input recording %s (%d frames)"), *FilePath, Frames.Num());
+    return true;
+}
+
+
+bool FWireInputRecording::LoadFromFile(const FString& FilePath)
+{
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *FilePath, FILEREAD_Silent))
+        return false;
+
+    FMemoryReader Reader(Data);
+    Serialize(Reader);
+    if (Reader.IsError())
+    {
+        UE_LOG(LogWire, Warning, TEXT("%s is not a valid input recording"), *FilePath);
+        Frames.Reset();
+        return false;
+    }
+    return true;
+}
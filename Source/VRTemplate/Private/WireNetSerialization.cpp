@@ -0,0 +1,87 @@
+﻿#include "WireNetSerialization.h"
+
+
+void WireNetSerialization::SerializeLength(FArchive& Ar, float& Length)
+{
+    uint32 Quantized = Ar.IsSaving() ? (uint32)FMath::Clamp(FMath::RoundToInt32(Length), 0, (int32)MaxQuantizedLength) : 0;
+    Ar.SerializeInt(Quantized, MaxQuantizedLength + 1);
+    if (Ar.IsLoading())
+        Length = (float)Quantized;
+}
+
+
+bool WireNetSerialization::SerializeRelativeLocation(FArchive& Ar, FVector& Location, const FVector& Origin)
+{
+    FVector Relative = Ar.IsSaving() ? Location - Origin : FVector::ZeroVector;
+    const bool bSuccess = SerializePackedVector<LocationScale, 24>(Relative, Ar);
+    if (Ar.IsLoading())
+        Location = Origin + Relative;
+    return bSuccess;
+}
+
+
+void WireNetSerialization::SerializeBit(FArchive& Ar, bool& bValue)
+{
+    uint8 Bit = bValue ? 1 : 0;
+    Ar.SerializeBits(&Bit, 1);
+    bValue = Bit != 0;
+}
+
+
+void FWireNetState::SetTether(int32 Index, bool bAttached, const FVector& InAnchor, float InLength)
+{
+    if (bAttached)
+    {
+        AttachedMask |= (1 << Index);
+        Anchor[Index] = InAnchor;
+        Length[Index] = InLength;
+    }
+    else
+    {
+        // 未接続の値は比較で差が出ないよう揃えておく
+        AttachedMask &= ~(1 << Index);
+        Anchor[Index] = FVector::ZeroVector;
+        Length[Index] = 0.0f;
+    }
+}
+
+
+bool FWireNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+
+    Ar.SerializeBits(&AttachedMask, 2);
+
+    for (int32 i = 0; i < 2; ++i)
+    {
+        if (IsAttached(i))
+        {
+            bOutSuccess &= SerializePackedVector<WireNetSerialization::LocationScale, 24>(Anchor[i], Ar);
+            WireNetSerialization::SerializeLength(Ar, Length[i]);
+        }
+        else if (Ar.IsLoading())
+        {
+            SetTether(i, false, FVector::ZeroVector, 0.0f);
+        }
+    }
+
+    return true;
+}
+
+
+bool FWireNetState::operator==(const FWireNetState& Other) const
+{
+    if (AttachedMask != Other.AttachedMask)
+        return false;
+
+    for (int32 i = 0; i < 2; ++i)
+    {
+        if (!IsAttached(i))
+            continue;
+
+        if (!Anchor[i].Equals(Other.Anchor[i], WireNetSerialization::LocationTolerance)
+            || !WireNetSerialization::IsSameLength(Length[i], Other.Length[i]))
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+﻿#include "WireRenderSubsystem.h"
+#include "WireBatchComponent.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInterface.h"
+
+
+bool UWireRenderSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // 専用サーバーでは描画しない
+    return Super::ShouldCreateSubsystem(Outer) && !IsRunningDedicatedServer();
+}
+
+
+bool UWireRenderSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UWireRenderSubsystem::Deinitialize()
+{
+    if (Renderer)
+    {
+        Renderer->DestroyComponent();
+        Renderer = nullptr;
+    }
+
+    Super::Deinitialize();
+}
+
+
+TStatId UWireRenderSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UWireRenderSubsystem, STATGROUP_Tickables);
+}
+
+
+void UWireRenderSubsystem::Tick(float DeltaTime)
+{
+    // Pawn の Tick はすべて終わっているので、このフレームの変化をまとめて送る
+    if (Renderer)
+        Renderer->FlushWires();
+}
+
+
+UWireBatchComponent* UWireRenderSubsystem::GetRenderer(UMaterialInterface* DefaultMaterial)
+{
+    if (!Renderer)
+    {
+        Renderer = NewObject<UWireBatchComponent>(this);
+        Renderer->WireRadius = WireRadius;
+        Renderer->NumSides = FMath::Clamp(NumSides, 3, 16);
+        Renderer->NumCurveSegments = FMath::Clamp(NumCurveSegments, 1, 32);
+        Renderer->UpdateTolerance = UpdateTolerance;
+
+        UMaterialInterface* Material = Cast<UMaterialInterface>(WireMaterial.TryLoad());
+        Renderer->SetMaterial(0, Material ? Material : DefaultMaterial);
+        Renderer->RegisterComponentWithWorld(GetWorld());
+    }
+    return Renderer;
+}
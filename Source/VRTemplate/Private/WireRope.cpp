@@ -0,0 +1,226 @@
+﻿#include "WireRope.h"
+#include "Math/VectorRegister.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+    // Simulate 1回あたりの最大ステップ幅（大きなヒッチでロープが暴れないように）
+    constexpr float MaxRopeTimeStep = 1.0f / 30.0f;
+
+    // 巻き戻しを終えたとみなす長さ (cm)
+    constexpr float MinRopeLength = 1.0f;
+}
+
+void FWireRope::SetSettings(const FWireRopeSettings& InSettings)
+{
+    Settings = InSettings;
+    Settings.MinParticles = FMath::Clamp(Settings.MinParticles, 3, Capacity);
+    Settings.MaxParticles = FMath::Clamp(Settings.MaxParticles, Settings.MinParticles, Capacity);
+    AdaptiveMaxParticles = Settings.MaxParticles;
+}
+
+void FWireRope::Attach(const FVector& Start, const FVector& End, float Length)
+{
+    bAttached = true;
+    RopeLength = Length;
+
+    // 始点から終点まで直線に並べる
+    NumParticles = FMath::Clamp(
+        FMath::CeilToInt(Length / Settings.SegmentLength) + 1, Settings.MinParticles, AdaptiveMaxParticles);
+    for (int32 i = 0; i < NumParticles; ++i)
+    {
+        SetParticle(i, FMath::Lerp(Start, End, (float)i / (NumParticles - 1)));
+    }
+}
+
+void FWireRope::Release()
+{
+    // アンカー側の端を自由にして、残った速度と巻き戻しで根元へしならせる
+    bAttached = false;
+}
+
+void FWireRope::Simulate(float DeltaTime, const FVector& Start, const FVector& End, float Length)
+{
+    if (!IsActive() || DeltaTime <= 0.0f)
+    {
+        return;
+    }
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    if (bAttached)
+    {
+        RopeLength = Length;
+    }
+    else
+    {
+        // 巻き戻しを終えたら非表示
+        RopeLength -= Settings.RecoilSpeed * DeltaTime;
+        if (RopeLength <= MinRopeLength)
+        {
+            NumParticles = 0;
+            return;
+        }
+    }
+
+    // 長さと処理時間の予算に合わせて粒子数を調整
+    const int32 DesiredParticles = FMath::Clamp(
+        FMath::CeilToInt(RopeLength / Settings.SegmentLength) + 1, Settings.MinParticles, AdaptiveMaxParticles);
+    if (DesiredParticles != NumParticles)
+    {
+        Resample(DesiredParticles);
+    }
+
+    const float Step = FMath::Min(DeltaTime, MaxRopeTimeStep);
+    Integrate(Step);
+
+    // 端点の固定
+    SetParticle(0, Start);
+    if (bAttached)
+    {
+        SetParticle(NumParticles - 1, End);
+    }
+
+    const float RestLength = RopeLength / (NumParticles - 1);
+    for (int32 Iteration = 0; Iteration < Settings.Iterations; ++Iteration)
+    {
+        SolveConstraints(RestLength);
+    }
+
+    LastSimulateMicroseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+
+    // 予算を超えたら粒子数の上限を下げ、余裕があれば少しずつ戻す
+    if (LastSimulateMicroseconds > Settings.BudgetMicroseconds)
+    {
+        AdaptiveMaxParticles = FMath::Max(Settings.MinParticles, AdaptiveMaxParticles * 3 / 4);
+    }
+    else if (LastSimulateMicroseconds < Settings.BudgetMicroseconds * 0.5 && AdaptiveMaxParticles < Settings.MaxParticles)
+    {
+        ++AdaptiveMaxParticles;
+    }
+}
+
+void FWireRope::GetHermite(FVector& OutStart, FVector& OutStartTangent, FVector& OutEnd, FVector& OutEndTangent) const
+{
+    const FVector P0 = GetParticle(0);
+    const FVector P3 = GetParticle(NumParticles - 1);
+
+    // 曲線がロープの 1/3・2/3 の位置を通るようにベジエの制御点を決める
+    const FVector Q1 = GetPointAt(1.0f / 3.0f);
+    const FVector Q2 = GetPointAt(2.0f / 3.0f);
+    const FVector C1 = (-5.0f * P0 + 18.0f * Q1 - 9.0f * Q2 + 2.0f * P3) / 6.0f;
+    const FVector C2 = (2.0f * P0 - 9.0f * Q1 + 18.0f * Q2 - 5.0f * P3) / 6.0f;
+
+    // ベジエの制御点からエルミートの接線へ
+    OutStart = P0;
+    OutStartTangent = 3.0f * (C1 - P0);
+    OutEnd = P3;
+    OutEndTangent = 3.0f * (P3 - C2);
+}
+
+void FWireRope::Resample(int32 NewNumParticles)
+{
+    // 現在の形を一時的に保存してから等間隔に取り直す
+    FVector Positions[Capacity];
+    FVector Velocities[Capacity];
+    for (int32 i = 0; i < NewNumParticles; ++i)
+    {
+        const float Alpha = (float)i / (NewNumParticles - 1);
+        const float Position = Alpha * (NumParticles - 1);
+        const int32 Index = FMath::Min(FMath::FloorToInt(Position), NumParticles - 2);
+        const float Frac = Position - Index;
+
+        Positions[i] = FMath::Lerp(GetParticle(Index), GetParticle(Index + 1), Frac);
+        Velocities[i] = Positions[i] - FMath::Lerp(
+            FVector(PrevX[Index], PrevY[Index], PrevZ[Index]),
+            FVector(PrevX[Index + 1], PrevY[Index + 1], PrevZ[Index + 1]),
+            Frac);
+    }
+
+    NumParticles = NewNumParticles;
+    for (int32 i = 0; i < NumParticles; ++i)
+    {
+        SetParticle(i, Positions[i]);
+        PrevX[i] -= (float)Velocities[i].X;
+        PrevY[i] -= (float)Velocities[i].Y;
+        PrevZ[i] -= (float)Velocities[i].Z;
+    }
+}
+
+void FWireRope::Integrate(float DeltaTime)
+{
+    // x' = x + (x - x_prev) * (1 - Damping) + g * dt^2 を 4 粒子ずつ計算
+    const VectorRegister4Float Keep = VectorSetFloat1(1.0f - Settings.Damping);
+    const VectorRegister4Float GravityStep = VectorSetFloat1(-Settings.Gravity * DeltaTime * DeltaTime);
+
+    const int32 NumPadded = Align(NumParticles, 4);
+    for (int32 i = 0; i < NumPadded; i += 4)
+    {
+        const VectorRegister4Float CurX = VectorLoadAligned(&X[i]);
+        const VectorRegister4Float CurY = VectorLoadAligned(&Y[i]);
+        const VectorRegister4Float CurZ = VectorLoadAligned(&Z[i]);
+
+        const VectorRegister4Float NewX = VectorMultiplyAdd(VectorSubtract(CurX, VectorLoadAligned(&PrevX[i])), Keep, CurX);
+        const VectorRegister4Float NewY = VectorMultiplyAdd(VectorSubtract(CurY, VectorLoadAligned(&PrevY[i])), Keep, CurY);
+        const VectorRegister4Float NewZ = VectorAdd(
+            VectorMultiplyAdd(VectorSubtract(CurZ, VectorLoadAligned(&PrevZ[i])), Keep, CurZ), GravityStep);
+
+        VectorStoreAligned(CurX, &PrevX[i]);
+        VectorStoreAligned(CurY, &PrevY[i]);
+        VectorStoreAligned(CurZ, &PrevZ[i]);
+        VectorStoreAligned(NewX, &X[i]);
+        VectorStoreAligned(NewY, &Y[i]);
+        VectorStoreAligned(NewZ, &Z[i]);
+    }
+}
+
+void FWireRope::SolveConstraints(float RestLength)
+{
+    // 伸びだけを戻す（縮みは許してたるませる）
+    const int32 Last = NumParticles - 1;
+    for (int32 i = 0; i < Last; ++i)
+    {
+        const float DX = X[i + 1] - X[i];
+        const float DY = Y[i + 1] - Y[i];
+        const float DZ = Z[i + 1] - Z[i];
+        const float DistSquared = DX * DX + DY * DY + DZ * DZ;
+        if (DistSquared <= RestLength * RestLength)
+        {
+            continue;
+        }
+
+        // 固定された端点は動かさない
+        const float WeightA = (i == 0) ? 0.0f : 1.0f;
+        const float WeightB = (i + 1 == Last && bAttached) ? 0.0f : 1.0f;
+        const float WeightSum = WeightA + WeightB;
+        if (WeightSum <= 0.0f)
+        {
+            continue;
+        }
+
+        const float Dist = FMath::Sqrt(DistSquared);
+        const float Correction = (Dist - RestLength) / (Dist * WeightSum);
+
+        X[i] += DX * Correction * WeightA;
+        Y[i] += DY * Correction * WeightA;
+        Z[i] += DZ * Correction * WeightA;
+        X[i + 1] -= DX * Correction * WeightB;
+        Y[i + 1] -= DY * Correction * WeightB;
+        Z[i + 1] -= DZ * Correction * WeightB;
+    }
+}
+
+void FWireRope::SetParticle(int32 Index, const FVector& Position)
+{
+    // 位置を置き換えて速度は 0 にする
+    X[Index] = PrevX[Index] = (float)Position.X;
+    Y[Index] = PrevY[Index] = (float)Position.Y;
+    Z[Index] = PrevZ[Index] = (float)Position.Z;
+}
+
+FVector FWireRope::GetPointAt(float Alpha) const
+{
+    const float Position = Alpha * (NumParticles - 1);
+    const int32 Index = FMath::Min(FMath::FloorToInt(Position), NumParticles - 2);
+    return FMath::Lerp(GetParticle(Index), GetParticle(Index + 1), Position - Index);
+}
@@ -0,0 +1,118 @@
+﻿#include "WireSignificanceSubsystem.h"
+#include "VRPawn.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "WireStats.h"
+
+
+bool UWireSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UWireSignificanceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UWireSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+
+void UWireSignificanceSubsystem::RegisterPawn(AVRPawn* Pawn)
+{
+    Pawns.AddUnique(Pawn);
+}
+
+
+void UWireSignificanceSubsystem::UnregisterPawn(AVRPawn* Pawn)
+{
+    Pawns.RemoveSwap(Pawn);
+}
+
+
+void UWireSignificanceSubsystem::Tick(float DeltaTime)
+{
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireSignificanceUpdate, SignificanceUpdate);
+
+    Pawns.RemoveAllSwap([](const TWeakObjectPtr<AVRPawn>& Pawn) { return !Pawn.IsValid(); });
+
+    // 各 Pawn の見た目の更新はワールドの Tick 内で済んでいるので、全員が毎フレーム更新した場合との差を集計
+    LastSavedUpdates = FMath::Max(Pawns.Num() * CosmeticUpdatesPerPawn - NumCosmeticUpdates, 0);
+    NumCosmeticUpdates = 0;
+    SET_DWORD_STAT(STAT_WireCosmeticUpdatesSaved, LastSavedUpdates);
+    CSV_CUSTOM_STAT(Wire, CosmeticUpdatesSaved, LastSavedUpdates, ECsvCustomStatOp::Set);
+
+    // 視点がなければ（専用サーバー・ベンチマーク）すべて更新する
+    FVector ViewLocation, ViewDirection;
+    const bool bHasView = GetViewPoint(ViewLocation, ViewDirection);
+
+    // 次のフレームの段階を決める
+    int32 NumSignificant = 0;
+    for (const TWeakObjectPtr<AVRPawn>& Pawn : Pawns)
+    {
+        const EWireCosmeticSignificance Level = bHasView
+            ? GetLevel(CalculateSignificance(Pawn.Get(), ViewLocation, ViewDirection))
+            : EWireCosmeticSignificance::Full;
+        Pawn->SetCosmeticSignificance(Level, GetTickRate(Level));
+
+        if (Level == EWireCosmeticSignificance::Full)
+            ++NumSignificant;
+    }
+    SET_DWORD_STAT(STAT_WireSignificantPawns, NumSignificant);
+}
+
+
+float UWireSignificanceSubsystem::CalculateSignificance(const AVRPawn* Pawn, const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+    // 自分の Pawn は常に最大
+    if (Pawn->IsLocallyControlled())
+        return 1.0f;
+
+    // 距離による重要度（近距離は 1、遠距離で 0）
+    const FVector ToPawn = Pawn->GetActorLocation() - ViewLocation;
+    const float Distance = ToPawn.Size();
+    const float DistanceScore = 1.0f - FMath::Clamp((Distance - NearDistance) / FMath::Max(FarDistance - NearDistance, 1.0f), 0.0f, 1.0f);
+
+    // 視野外なら下げる（近すぎる時は向きに関係なく視野内とする）
+    const bool bInView = Distance < UE_KINDA_SMALL_NUMBER
+        || FVector::DotProduct(ToPawn / Distance, ViewDirection) >= FMath::Cos(FMath::DegreesToRadians(ViewHalfAngle))
+        || Distance < NearDistance * 0.5f;
+
+    return bInView ? DistanceScore : DistanceScore * OutOfViewScale;
+}
+
+
+bool UWireSignificanceSubsystem::GetViewPoint(FVector& OutLocation, FVector& OutDirection) const
+{
+    const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+    if (!PlayerController || !PlayerController->IsLocalController())
+        return false;
+
+    FRotator ViewRotation;
+    PlayerController->GetPlayerViewPoint(OutLocation, ViewRotation);
+    OutDirection = ViewRotation.Vector();
+    return true;
+}
+
+
+EWireCosmeticSignificance UWireSignificanceSubsystem::GetLevel(float Significance) const
+{
+    if (Significance >= FullThreshold)
+        return EWireCosmeticSignificance::Full;
+    if (Significance >= ReducedThreshold)
+        return EWireCosmeticSignificance::Reduced;
+    if (Significance >= MinimalThreshold)
+        return EWireCosmeticSignificance::Minimal;
+    return EWireCosmeticSignificance::Culled;
+}
+
+
+float UWireSignificanceSubsystem::GetTickRate(EWireCosmeticSignificance Level) const
+{
+    switch (Level)
+    {
+    case EWireCosmeticSignificance::Reduced: return ReducedTickRate;
+    case EWireCosmeticSignificance::Minimal: return MinimalTickRate;
+    case EWireCosmeticSignificance::Culled:  return MinimalTickRate;
+    default:                                 return 0.0f;
+    }
+}
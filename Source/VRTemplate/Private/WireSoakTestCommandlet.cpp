@@ -0,0 +1,270 @@
+﻿#include "WireSoakTestCommandlet.h"
+#include "WireSoakTestSubsystem.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWireSoakTest, Log, All);
+
+namespace WireSoakTest
+{
+    // サーバーがマップを開くまでの待ち時間・終了を待つ余裕（秒）
+    constexpr double ServerStartupTime = 15.0;
+    constexpr double ShutdownTimeout = 60.0;
+
+    // クライアントを起動する間隔と、最後のクライアントが接続し終えるまでの余裕（秒）
+    constexpr float ClientLaunchInterval = 0.5f;
+    constexpr double ClientJoinTime = 30.0;
+
+    // CSV の列
+    enum EColumn
+    {
+        Time,
+        Clients,
+        TickMeanMs,
+        TickP99Ms,
+        TickMaxMs,
+        OutBytesPerClient,
+        InBytesPerClient,
+        MaxOutBytesPerClient,
+        Moves,
+        Corrections,
+        UsedMemoryMB,
+        NumColumns,
+    };
+}
+
+
+UWireSoakTestCommandlet::UWireSoakTestCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+
+int32 UWireSoakTestCommandlet::Main(const FString& Params)
+{
+    FString MapName;
+    FString ServerExe;
+    FString ClientExe;
+    FString ReplayName;
+    FString ReportName = TEXT("Soak");
+    int32 NumClients = 8;
+    int32 Port = 7777;
+    double Duration = 600.0;
+    double MaxTickP99 = 0.0;
+    double MaxBytesPerClient = 0.0;
+    double MaxMemoryGrowth = 0.0;
+    FParse::Value(*Params, TEXT("Map="), MapName);
+    FParse::Value(*Params, TEXT("ServerExe="), ServerExe);
+    FParse::Value(*Params, TEXT("ClientExe="), ClientExe);
+    FParse::Value(*Params, TEXT("Replay="), ReplayName);
+    FParse::Value(*Params, TEXT("Report="), ReportName);
+    FParse::Value(*Params, TEXT("Clients="), NumClients);
+    FParse::Value(*Params, TEXT("Port="), Port);
+    FParse::Value(*Params, TEXT("Duration="), Duration);
+    FParse::Value(*Params, TEXT("MaxTickP99="), MaxTickP99);
+    FParse::Value(*Params, TEXT("MaxBytesPerClient="), MaxBytesPerClient);
+    FParse::Value(*Params, TEXT("MaxMemoryGrowth="), MaxMemoryGrowth);
+
+    // 実行ファイルの指定がなければこのエディタでプロジェクトを開く
+    const FString ProjectArg = FString::Printf(TEXT("\"%s\" "), *FPaths::ConvertRelativePathToFull(FPaths::GetProjectFilePath()));
+    const FString EditorExe = FPlatformProcess::ExecutablePath();
+    const FString LogDir = FPaths::ConvertRelativePathToFull(FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Soak")));
+    const FString CommonArgs = TEXT("-unattended -nosplash -nopause -nosound -nosteam -WireSoak");
+
+    // 古い結果を残さない
+    const FString ReportPath = UWireSoakTestSubsystem::GetReportPath(ReportName);
+    IFileManager::Get().Delete(*ReportPath, false, true, true);
+
+    // 全クライアントが接続するまでは計測に含めない
+    // CSV の時刻はサーバーがマップを読み込んでからの実時間なので、起動待ちを含めれば接続完了より後になる
+    const double WarmupTime = WireSoakTest::ServerStartupTime + NumClients * WireSoakTest::ClientLaunchInterval + WireSoakTest::ClientJoinTime;
+
+    // サーバーは計測時間が過ぎたら自分で終了して最後の間隔を書き出す
+    const FString ServerArgs = FString::Printf(TEXT("%s%s -server -port=%d %s -SoakDuration=%.0f -SoakReport=%s -abslog=\"%s\""),
+        ServerExe.IsEmpty() ? *ProjectArg : TEXT(""), *MapName, Port, *CommonArgs, WarmupTime + Duration, *ReportName,
+        *FPaths::Combine(LogDir, ReportName + TEXT("_Server.log")));
+    FProcHandle ServerHandle = LaunchProcess(ServerExe.IsEmpty() ? EditorExe : ServerExe, ServerArgs);
+    if (!ServerHandle.IsValid())
+    {
+        return 1;
+    }
+
+    // サーバーがマップを開くのを待ってからクライアントを順に接続
+    FPlatformProcess::Sleep((float)WireSoakTest::ServerStartupTime);
+
+    TArray<FProcHandle> ClientHandles;
+    for (int32 i = 0; i < NumClients && FPlatformProcess::IsProcRunning(ServerHandle); ++i)
+    {
+        FString ClientArgs = FString::Printf(TEXT("%s127.0.0.1:%d -game -nullrhi %s -SoakClientIndex=%d -abslog=\"%s\""),
+            ClientExe.IsEmpty() ? *ProjectArg : TEXT(""), Port, *CommonArgs, i,
+            *FPaths::Combine(LogDir, FString::Printf(TEXT("%s_Client%d.log"), *ReportName, i)));
+        if (!ReplayName.IsEmpty())
+        {
+            ClientArgs += FString::Printf(TEXT(" -SoakReplay=\"%s\""), *ReplayName);
+        }
+
+        FProcHandle ClientHandle = LaunchProcess(ClientExe.IsEmpty() ? EditorExe : ClientExe, ClientArgs);
+        if (ClientHandle.IsValid())
+        {
+            ClientHandles.Add(ClientHandle);
+        }
+        FPlatformProcess::Sleep(WireSoakTest::ClientLaunchInterval);
+    }
+
+    UE_LOG(LogWireSoakTest, Display, TEXT("Soak test: %d clients for %.0fs on %s"),
+        ClientHandles.Num(), Duration, MapName.IsEmpty() ? TEXT("(default map)") : *MapName);
+
+    // サーバーの終了を待つ（途中で落ちたクライアントは数えておく）
+    const double EndTime = FPlatformTime::Seconds() + WarmupTime + Duration + WireSoakTest::ShutdownTimeout;
+    int32 NumLostClients = 0;
+    TArray<bool> ClientLost;
+    ClientLost.SetNumZeroed(ClientHandles.Num());
+    while (FPlatformProcess::IsProcRunning(ServerHandle) && FPlatformTime::Seconds() < EndTime)
+    {
+        for (int32 i = 0; i < ClientHandles.Num(); ++i)
+        {
+            if (!ClientLost[i] && !FPlatformProcess::IsProcRunning(ClientHandles[i]))
+            {
+                ClientLost[i] = true;
+                ++NumLostClients;
+                UE_LOG(LogWireSoakTest, Warning, TEXT("Client %d exited early"), i);
+            }
+        }
+        FPlatformProcess::Sleep(1.0f);
+    }
+
+    // 時間内に終わらなければサーバーも止める
+    bool bServerTimedOut = false;
+    if (FPlatformProcess::IsProcRunning(ServerHandle))
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Server did not exit in time"));
+        FPlatformProcess::TerminateProc(ServerHandle, true);
+        bServerTimedOut = true;
+    }
+    FPlatformProcess::CloseProc(ServerHandle);
+
+    for (FProcHandle& ClientHandle : ClientHandles)
+    {
+        if (FPlatformProcess::IsProcRunning(ClientHandle))
+        {
+            FPlatformProcess::TerminateProc(ClientHandle, true);
+        }
+        FPlatformProcess::CloseProc(ClientHandle);
+    }
+
+    const bool bPassed = SummarizeReport(ReportPath, WarmupTime, ClientHandles.Num(), MaxTickP99, MaxBytesPerClient, MaxMemoryGrowth);
+    if (NumLostClients > 0)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("%d of %d clients exited early, see %s"), NumLostClients, ClientHandles.Num(), *LogDir);
+    }
+    return bPassed && NumLostClients == 0 && !bServerTimedOut ? 0 : 1;
+}
+
+
+FProcHandle UWireSoakTestCommandlet::LaunchProcess(const FString& ExePath, const FString& Args) const
+{
+    UE_LOG(LogWireSoakTest, Log, TEXT("Launching %s %s"), *ExePath, *Args);
+
+    FProcHandle Handle = FPlatformProcess::CreateProc(*ExePath, *Args, false, true, true, nullptr, 0, nullptr, nullptr);
+    if (!Handle.IsValid())
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Failed to launch %s"), *ExePath);
+    }
+    return Handle;
+}
+
+
+bool UWireSoakTestCommandlet::SummarizeReport(const FString& ReportPath, double WarmupTime, int32 NumClients, double MaxTickP99, double MaxBytesPerClient, double MaxMemoryGrowth) const
+{
+    using namespace WireSoakTest;
+
+    TArray<FString> Lines;
+    if (!FFileHelper::LoadFileToStringArray(Lines, *ReportPath) || Lines.Num() < 2)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("No soak report at %s"), *ReportPath);
+        return false;
+    }
+
+    // 1行目は見出し、接続待ちの間の行は捨てる
+    TArray<TArray<double>> Rows;
+    for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+    {
+        TArray<FString> Cells;
+        Lines[LineIndex].ParseIntoArray(Cells, TEXT(","));
+        if (Cells.Num() != NumColumns)
+            continue;
+
+        if (FCString::Atod(*Cells[Time]) < WarmupTime)
+            continue;
+
+        TArray<double>& Row = Rows.AddDefaulted_GetRef();
+        for (const FString& Cell : Cells)
+        {
+            Row.Add(FCString::Atod(*Cell));
+        }
+    }
+    if (Rows.Num() == 0)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Soak report %s has no samples"), *ReportPath);
+        return false;
+    }
+
+    double WorstTickP99 = 0.0;
+    double PeakTickMs = 0.0;
+    double TickMeanSum = 0.0;
+    double OutBytesSum = 0.0;
+    double PeakOutBytes = 0.0;
+    double InBytesSum = 0.0;
+    double TotalMoves = 0.0;
+    double TotalCorrections = 0.0;
+    double PeakMemory = 0.0;
+    int32 MinClients = MAX_int32;
+    for (const TArray<double>& Row : Rows)
+    {
+        WorstTickP99 = FMath::Max(WorstTickP99, Row[TickP99Ms]);
+        PeakTickMs = FMath::Max(PeakTickMs, Row[TickMaxMs]);
+        TickMeanSum += Row[TickMeanMs];
+        OutBytesSum += Row[OutBytesPerClient];
+        PeakOutBytes = FMath::Max(PeakOutBytes, Row[MaxOutBytesPerClient]);
+        InBytesSum += Row[InBytesPerClient];
+        TotalMoves += Row[Moves];
+        TotalCorrections += Row[Corrections];
+        PeakMemory = FMath::Max(PeakMemory, Row[UsedMemoryMB]);
+        MinClients = FMath::Min(MinClients, (int32)Row[Clients]);
+    }
+    const double MemoryGrowth = Rows.Last()[UsedMemoryMB] - Rows[0][UsedMemoryMB];
+
+    UE_LOG(LogWireSoakTest, Display, TEXT("Soak report: %s, %d samples over %.0fs"), *ReportPath, Rows.Num(), Rows.Last()[Time] - WarmupTime);
+    UE_LOG(LogWireSoakTest, Display, TEXT("Clients              launched=%d connected(min)=%d"), NumClients, MinClients);
+    UE_LOG(LogWireSoakTest, Display, TEXT("ServerTick           mean=%.2fms worst p99=%.2fms max=%.2fms"), TickMeanSum / Rows.Num(), WorstTickP99, PeakTickMs);
+    UE_LOG(LogWireSoakTest, Display, TEXT("Bandwidth/client     out=%.0fB/s (peak %.0fB/s) in=%.0fB/s"), OutBytesSum / Rows.Num(), PeakOutBytes, InBytesSum / Rows.Num());
+    UE_LOG(LogWireSoakTest, Display, TEXT("Corrections          %.0f of %.0f moves (%.2f%%)"), TotalCorrections, TotalMoves, TotalMoves > 0.0 ? 100.0 * TotalCorrections / TotalMoves : 0.0);
+    UE_LOG(LogWireSoakTest, Display, TEXT("Memory               first=%.1fMB last=%.1fMB peak=%.1fMB growth=%.1fMB"), Rows[0][UsedMemoryMB], Rows.Last()[UsedMemoryMB], PeakMemory, MemoryGrowth);
+
+    bool bPassed = true;
+    if (MinClients < NumClients)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Only %d of %d clients were connected for the whole run"), MinClients, NumClients);
+        bPassed = false;
+    }
+    if (MaxTickP99 > 0.0 && WorstTickP99 > MaxTickP99)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Server tick p99 %.2fms exceeds threshold %.2fms"), WorstTickP99, MaxTickP99);
+        bPassed = false;
+    }
+    if (MaxBytesPerClient > 0.0 && PeakOutBytes > MaxBytesPerClient)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Bandwidth %.0f bytes/s per client exceeds threshold %.0f"), PeakOutBytes, MaxBytesPerClient);
+        bPassed = false;
+    }
+    if (MaxMemoryGrowth > 0.0 && MemoryGrowth > MaxMemoryGrowth)
+    {
+        UE_LOG(LogWireSoakTest, Error, TEXT("Memory grew %.1fMB, exceeds threshold %.1fMB"), MemoryGrowth, MaxMemoryGrowth);
+        bPassed = false;
+    }
+    return bPassed;
+}
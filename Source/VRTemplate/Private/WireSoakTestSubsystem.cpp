@@ -0,0 +1,297 @@
+﻿#include "WireSoakTestSubsystem.h"
+#include "VRPawn.h"
+#include "CoreGlobals.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "EngineUtils.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogWireSoak, Log, All);
+
+const TCHAR* UWireSoakTestSubsystem::CsvHeader =
+    TEXT("Time,Clients,TickMeanMs,TickP99Ms,TickMaxMs,OutBytesPerClient,InBytesPerClient,MaxOutBytesPerClient,Moves,Corrections,UsedMemoryMB");
+
+namespace WireSoak
+{
+    double GetUsedMemoryMB()
+    {
+        return FPlatformMemory::GetStats().UsedPhysical / (1024.0 * 1024.0);
+    }
+}
+
+
+bool UWireSoakTestSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("WireSoak"));
+}
+
+
+bool UWireSoakTestSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game;
+}
+
+
+TStatId UWireSoakTestSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UWireSoakTestSubsystem, STATGROUP_Tickables);
+}
+
+
+FString UWireSoakTestSubsystem::GetReportPath(const FString& Name)
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Soak"), Name + TEXT(".csv"));
+}
+
+
+void UWireSoakTestSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    const TCHAR* CommandLine = FCommandLine::Get();
+    ReportName = TEXT("Soak");
+    FParse::Value(CommandLine, TEXT("SoakDuration="), Duration);
+    FParse::Value(CommandLine, TEXT("SoakReport="), ReportName);
+    FParse::Value(CommandLine, TEXT("SoakClientIndex="), ClientIndex);
+    NextReportTime = ReportInterval;
+
+    FString ReplayName;
+    if (FParse::Value(CommandLine, TEXT("SoakReplay="), ReplayName))
+    {
+        Replay = MakeUnique<FWireInputRecording>();
+        if (!Replay->LoadFromFile(FWireInputRecording::GetFilePath(ReplayName)) || Replay->Frames.Num() == 0)
+        {
+            UE_LOG(LogWireSoak, Warning, TEXT("Failed to load input recording %s, using bot input"), *ReplayName);
+            Replay.Reset();
+        }
+    }
+}
+
+
+void UWireSoakTestSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // コースの地点を名前順に集める
+    TArray<AActor*> WaypointActors;
+    for (TActorIterator<AActor> It(&InWorld); It; ++It)
+    {
+        if (It->ActorHasTag(WaypointTag))
+            WaypointActors.Add(*It);
+    }
+    WaypointActors.Sort([](const AActor& A, const AActor& B) { return A.GetName() < B.GetName(); });
+
+    Waypoints.Reset(WaypointActors.Num());
+    for (const AActor* Actor : WaypointActors)
+    {
+        Waypoints.Add(Actor->GetActorLocation());
+    }
+
+    // クライアントごとに違う地点から始める
+    WaypointIndex = Waypoints.Num() > 0 ? ClientIndex % Waypoints.Num() : 0;
+}
+
+
+void UWireSoakTestSubsystem::Tick(float DeltaTime)
+{
+    // 計測・終了の時刻はこのワールドの実時間で数える（DeltaTime の積算はヒッチ時の切り詰めでずれる）
+    ElapsedTime = GetWorld()->GetRealTimeSeconds();
+
+    const ENetMode NetMode = GetWorld()->GetNetMode();
+    if (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)
+        TickServer(DeltaTime);
+    if (NetMode != NM_DedicatedServer)
+        TickClient(DeltaTime);
+
+    if (Duration > 0.0 && ElapsedTime >= Duration && !IsEngineExitRequested())
+    {
+        // 終了前に残りを書き出して全体をまとめる
+        if (!ReportPath.IsEmpty())
+        {
+            WriteReport();
+            UE_LOG(LogWireSoak, Display, TEXT("Soak finished: %.0fs, tick max %.2fms, moves %llu, corrections %llu, memory %.1fMB -> %.1fMB (peak %.1fMB)"),
+                ElapsedTime, PeakTickMs, TotalMoves, TotalCorrections, StartMemoryMB, WireSoak::GetUsedMemoryMB(), PeakMemoryMB);
+        }
+        FPlatformMisc::RequestExit(false, TEXT("WireSoak"));
+    }
+}
+
+
+void UWireSoakTestSubsystem::TickServer(float DeltaTime)
+{
+    // 待機を除いたゲームスレッドの時間
+    const float TickMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    TickSamples.Add(TickMs);
+    PeakTickMs = FMath::Max(PeakTickMs, TickMs);
+
+    if (ElapsedTime >= NextReportTime)
+    {
+        WriteReport();
+        NextReportTime = ElapsedTime + ReportInterval;
+    }
+}
+
+
+void UWireSoakTestSubsystem::WriteReport()
+{
+    // 最初の書き出しでファイルを作り直す
+    if (ReportPath.IsEmpty())
+    {
+        ReportPath = GetReportPath(ReportName);
+        FFileHelper::SaveStringToFile(FString(CsvHeader) + LINE_TERMINATOR, *ReportPath);
+        StartMemoryMB = WireSoak::GetUsedMemoryMB();
+    }
+
+    // 間隔内の Tick 時間
+    float TickMean = 0.0f;
+    float TickP99 = 0.0f;
+    float TickMax = 0.0f;
+    if (TickSamples.Num() > 0)
+    {
+        TickSamples.Sort();
+        for (float Sample : TickSamples)
+            TickMean += Sample;
+        TickMean /= TickSamples.Num();
+        TickP99 = TickSamples[FMath::Min(FMath::FloorToInt32(TickSamples.Num() * 0.99f), TickSamples.Num() - 1)];
+        TickMax = TickSamples.Last();
+    }
+    TickSamples.Reset();
+
+    // クライアントごとの帯域（直前の1秒間）
+    int32 NumClients = 0;
+    double OutBytes = 0.0;
+    double InBytes = 0.0;
+    int32 MaxOutBytes = 0;
+    if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
+    {
+        for (const UNetConnection* Connection : NetDriver->ClientConnections)
+        {
+            if (!Connection)
+                continue;
+            ++NumClients;
+            OutBytes += Connection->OutBytesPerSecond;
+            InBytes += Connection->InBytesPerSecond;
+            MaxOutBytes = FMath::Max(MaxOutBytes, Connection->OutBytesPerSecond);
+        }
+    }
+
+    // 前回からの入力と補正の数（抜けたクライアントの Pawn の分は数えない）
+    uint64 Moves = 0;
+    uint64 Corrections = 0;
+    for (TActorIterator<AVRPawn> It(GetWorld()); It; ++It)
+    {
+        uint32 PawnMoves = 0;
+        uint32 PawnCorrections = 0;
+        It->GetServerMoveCounters(PawnMoves, PawnCorrections);
+        Moves += PawnMoves;
+        Corrections += PawnCorrections;
+    }
+    const uint64 NewMoves = Moves >= LastMoves ? Moves - LastMoves : Moves;
+    const uint64 NewCorrections = Corrections >= LastCorrections ? Corrections - LastCorrections : Corrections;
+    LastMoves = Moves;
+    LastCorrections = Corrections;
+    TotalMoves += NewMoves;
+    TotalCorrections += NewCorrections;
+
+    const double UsedMemoryMB = WireSoak::GetUsedMemoryMB();
+    PeakMemoryMB = FMath::Max(PeakMemoryMB, UsedMemoryMB);
+
+    const double OutPerClient = NumClients > 0 ? OutBytes / NumClients : 0.0;
+    const double InPerClient = NumClients > 0 ? InBytes / NumClients : 0.0;
+    const FString Row = FString::Printf(TEXT("%.1f,%d,%.3f,%.3f,%.3f,%.0f,%.0f,%d,%llu,%llu,%.1f"),
+        ElapsedTime, NumClients, TickMean, TickP99, TickMax, OutPerClient, InPerClient, MaxOutBytes, NewMoves, NewCorrections, UsedMemoryMB);
+    FFileHelper::SaveStringToFile(Row + LINE_TERMINATOR, *ReportPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+
+    UE_LOG(LogWireSoak, Display, TEXT("t=%6.0fs clients=%d tick mean=%.2fms p99=%.2fms max=%.2fms out=%.0fB/s in=%.0fB/s per client, corrections=%llu/%llu, memory=%.1fMB"),
+        ElapsedTime, NumClients, TickMean, TickP99, TickMax, OutPerClient, InPerClient, NewCorrections, NewMoves, UsedMemoryMB);
+}
+
+
+void UWireSoakTestSubsystem::TickClient(float DeltaTime)
+{
+    const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+    AVRPawn* Pawn = PlayerController ? Cast<AVRPawn>(PlayerController->GetPawn()) : nullptr;
+    if (!Pawn)
+        return;
+
+    // 記録があれば繰り返し再生、なければボット
+    if (Replay)
+    {
+        Pawn->ApplyRecordedFrame(Replay->Frames[ReplayFrame]);
+        ReplayFrame = (ReplayFrame + 1) % Replay->Frames.Num();
+    }
+    else
+    {
+        ApplyBotInput(Pawn, DeltaTime);
+    }
+}
+
+
+void UWireSoakTestSubsystem::ApplyBotInput(AVRPawn* Pawn, float DeltaTime)
+{
+    const float PrevTime = BotTime;
+    BotTime += DeltaTime;
+
+    // 目標の方向を向く
+    const FVector ToTarget = GetBotTarget(Pawn) - Pawn->GetActorLocation();
+    const float TargetYaw = FRotator::NormalizeAxis(ToTarget.Rotation().Yaw - Pawn->GetActorRotation().Yaw);
+
+    FWireInputFrame Frame;
+    Frame.Move.DeltaTime = DeltaTime;
+    Frame.HeadRotation = FRotator(0.0f, TargetYaw, 0.0f);
+
+    // 目標の前上方にコントローラーを振りながら、BotCycleTime 周期で接続→巻き取り→切断を繰り返す
+    // （左右で半周期、クライアントごとにも周期をずらす）
+    const float CycleTime = FMath::Max(BotCycleTime, 0.1f);
+    for (int32 i = 0; i < 2; ++i)
+    {
+        const float Side = i == 0 ? -1.0f : 1.0f;
+        const float Offset = 0.5f * i + 0.37f * ClientIndex;
+        const float PrevPhase = FMath::Frac(PrevTime / CycleTime + Offset);
+        const float Phase = FMath::Frac(BotTime / CycleTime + Offset);
+
+        Frame.Move.HandLocation[i] = FVector(30.0f, Side * 25.0f, 0.0f);
+        Frame.Move.HandRotation[i] = FRotator(
+            BotAimPitch + 15.0f * FMath::Sin(BotTime * 1.3f + i + ClientIndex),
+            TargetYaw + Side * (20.0f + 25.0f * FMath::Sin(BotTime * 0.7f)),
+            0.0f);
+
+        // 接続は状態で送るので、切り替えない間は今の接続状態をそのまま入れる
+        const bool bAttached = Pawn->IsWireAttached(i);
+        bool bWantsWire = bAttached;
+        if (Phase < PrevPhase && !bAttached)
+        {
+            bWantsWire = true;
+        }
+        else if (Phase > 0.3f && Phase < 0.8f && bAttached)
+        {
+            Frame.Move.Flags |= (uint8)VRPawnRetractWireFlag(i);
+        }
+        else if (PrevPhase < 0.9f && Phase >= 0.9f && bAttached)
+        {
+            bWantsWire = false;
+        }
+        if (bWantsWire)
+            Frame.Move.Flags |= (uint8)VRPawnWantsWireFlag(i);
+    }
+
+    Pawn->ApplyRecordedFrame(Frame);
+}
+
+
+FVector UWireSoakTestSubsystem::GetBotTarget(const AVRPawn* Pawn)
+{
+    const FVector Location = Pawn->GetActorLocation();
+
+    // コースがなければ大きく旋回し続ける
+    if (Waypoints.Num() == 0)
+        return Location + FRotator(0.0f, BotTime * 10.0f + ClientIndex * 45.0f, 0.0f).Vector() * WaypointRadius * 2.0f;
+
+    if (FVector::DistSquared(Location, Waypoints[WaypointIndex]) < FMath::Square(WaypointRadius))
+        WaypointIndex = (WaypointIndex + 1) % Waypoints.Num();
+    return Waypoints[WaypointIndex];
+}
@@ -0,0 +1,356 @@
+﻿#include "WireSolver.h"
+
+
+FWireSolver::FWireSolver(const FWireSolverSettings& InSettings)
+{
+    SetSettings(InSettings);
+}
+
+
+void FWireSolver::SetSettings(const FWireSolverSettings& InSettings)
+{
+    Settings = InSettings;
+
+    // 0 以下のタイムステップではシミュレーションが進まないので補正
+    Settings.FixedTimeStep = FMath::Max(Settings.FixedTimeStep, UE_KINDA_SMALL_NUMBER);
+    Settings.NumTethers = FMath::Clamp(Settings.NumTethers, 1, MaxTethers);
+    Settings.MaxSubsteps = FMath::Max(Settings.MaxSubsteps, 1);
+    Settings.Compliance = FMath::Max(Settings.Compliance, 0.0f);
+    Settings.NumIterations = FMath::Max(Settings.NumIterations, 1);
+    Settings.MaxWrapPoints = FMath::Max(Settings.MaxWrapPoints, 0);
+    Settings.WrapRefineSteps = FMath::Max(Settings.WrapRefineSteps, 0);
+}
+
+
+bool FWireSolver::IsAnyAttached() const
+{
+    for (const FWireTether& Tether : Tethers)
+    {
+        if (Tether.bAttached)
+            return true;
+    }
+    return false;
+}
+
+
+void FWireSolver::Attach(int32 Index, const FVector& Anchor, const FVector& Origin)
+{
+    FWireTether& Tether = Tethers[Index];
+
+    // 接続フラグを立てて接続位置を記憶
+    Tether.bAttached = true;
+    Tether.Anchor = Anchor;
+
+    // 接続時にワイヤー長を現在の距離に設定
+    Tether.CurrentLength = FVector::Dist(Origin, Anchor);
+    Tether.AttachLength = Tether.CurrentLength;
+
+    // 巻き付きはなし
+    Tether.WrapPoints.Reset();
+    Tether.WrappedLength = 0.0f;
+    Tether.LastOrigin = Origin;
+}
+
+
+void FWireSolver::Detach(int32 Index)
+{
+    Tethers[Index].bAttached = false;
+    Tethers[Index].WrapPoints.Reset();
+    Tethers[Index].WrappedLength = 0.0f;
+}
+
+
+void FWireSolver::SetTether(int32 Index, const FWireTether& InTether)
+{
+    FWireTether& Tether = Tethers[Index];
+    Tether = InTether;
+
+    // アンカーから巻き付き点をたどった長さ
+    Tether.WrappedLength = 0.0f;
+    FVector Prev = Tether.Anchor;
+    for (const FWireWrapPoint& WrapPoint : Tether.WrapPoints)
+    {
+        Tether.WrappedLength += FVector::Dist(Prev, WrapPoint.Location);
+        Prev = WrapPoint.Location;
+    }
+}
+
+
+bool FWireSolver::UpdateWrap(int32 Index, const FVector& Origin, FWireWrapTraceFunction Trace)
+{
+    FWireTether& Tether = Tethers[Index];
+    if (!Tether.bAttached)
+        return false;
+
+    bool bChanged = false;
+
+    // 巻き付きの解除（トレースせず、支点での曲がる向きが反転したかで判定）
+    while (Tether.WrapPoints.Num() > 0)
+    {
+        const FWireWrapPoint& Last = Tether.WrapPoints.Last();
+        const FVector Prev = Tether.WrapPoints.Num() > 1 ? Tether.WrapPoints.Last(1).Location : Tether.Anchor;
+        const FVector Bend = FVector::CrossProduct(Last.Location - Prev, Origin - Last.Location);
+        if (FVector::DotProduct(Bend, Last.BendAxis) >= 0.0f)
+            break;
+
+        Tether.WrappedLength = FMath::Max(Tether.WrappedLength - FVector::Dist(Prev, Last.Location), 0.0f);
+        Tether.WrapPoints.Pop(EAllowShrinking::No);
+        bChanged = true;
+    }
+
+    const FVector PrevOrigin = Tether.LastOrigin;
+    Tether.LastOrigin = Origin;
+
+    if (Tether.WrapPoints.Num() >= Settings.MaxWrapPoints)
+        return bChanged;
+
+    // 支点の面にかからないよう少し離れた位置から根元までをトレース
+    const FVector Pivot = Tether.GetPivot();
+    auto TraceFromPivot = [&](const FVector& End, FVector& OutLocation, FVector& OutNormal)
+    {
+        const FVector Start = Pivot + (End - Pivot).GetSafeNormal() * Settings.WrapOffset * 2.0f;
+        return Trace(Start, End, OutLocation, OutNormal);
+    };
+
+    FVector HitLocation, HitNormal;
+    if (!TraceFromPivot(Origin, HitLocation, HitNormal))
+        return bChanged;
+
+    // 前回の根元までは遮られていなかったので、その間で遮られ始める位置を二分探索して角に近づける
+    FVector Clear = PrevOrigin;
+    FVector Blocked = Origin;
+    for (int32 i = 0; i < Settings.WrapRefineSteps; ++i)
+    {
+        const FVector Mid = (Clear + Blocked) * 0.5f;
+        FVector MidLocation, MidNormal;
+        if (TraceFromPivot(Mid, MidLocation, MidNormal))
+        {
+            Blocked = Mid;
+            HitLocation = MidLocation;
+            HitNormal = MidNormal;
+        }
+        else
+        {
+            Clear = Mid;
+        }
+    }
+
+    // 面から少し離した位置を巻き付き点とする
+    const FVector WrapLocation = HitLocation + HitNormal * Settings.WrapOffset;
+    const FVector BendAxis = FVector::CrossProduct(WrapLocation - Pivot, Origin - WrapLocation);
+    if (BendAxis.IsNearlyZero())
+        return bChanged;
+
+    Tether.WrappedLength += FVector::Dist(Pivot, WrapLocation);
+    Tether.WrapPoints.Add({ WrapLocation, BendAxis });
+
+    return true;
+}
+
+
+float FWireSolver::ReelWire(int32 Index, const FVector& Origin, float DeltaLength, float MinLength, float MaxLength)
+{
+    FWireTether& Tether = Tethers[Index];
+
+    // 巻き付き点を経由したアンカーまでの距離を基準にワイヤーの長さを更新
+    const float Distance = Tether.WrappedLength + FVector::Dist(Tether.GetPivot(), Origin);
+    Tether.CurrentLength = FMath::Clamp(Distance + DeltaLength, MinLength, MaxLength);
+
+    return Tether.AttachLength > 0.0f ? Tether.CurrentLength / Tether.AttachLength : 1.0f;
+}
+
+
+FWireSolverStepResult FWireSolver::Step(float DeltaTime, TArrayView<const FVector> Origins)
+{
+    return StepFixed(ConsumeSubsteps(DeltaTime), Origins);
+}
+
+
+int32 FWireSolver::ConsumeSubsteps(float DeltaTime)
+{
+    // 固定タイムステップ何回分の時間が経過したか（浮動小数点誤差で1回分欠けないよう僅かに余裕を持たせる）
+    const double Dt = Settings.FixedTimeStep;
+    Accumulator += FMath::Max(DeltaTime, 0.0f);
+    int32 NumSteps = FMath::FloorToInt32((Accumulator + Dt * 1.0e-3) / Dt);
+
+    // 上限を超えたらその分の時間は捨てる（ヒッチ時に処理が膨らまないように）
+    if (NumSteps > Settings.MaxSubsteps)
+    {
+        NumSteps = Settings.MaxSubsteps;
+        Accumulator = 0.0;
+    }
+    else
+    {
+        Accumulator = FMath::Max(Accumulator - NumSteps * Dt, 0.0);
+    }
+
+    return NumSteps;
+}
+
+
+FWireSolverStepResult FWireSolver::StepFixed(int32 NumSteps, TArrayView<const FVector> Origins)
+{
+    FWireSolverStepResult Result;
+    GatherBatch(Origins);
+
+    // サブステップが無いフレームでも引き寄せ加速度が途切れないよう前回の値を返す（接続が無ければ 0）
+    if (Batch.Num == 0)
+    {
+        LastPullAcceleration = FVector::ZeroVector;
+    }
+    for (int32 i = 0; i < NumSteps; ++i)
+    {
+        LastPullAcceleration = Substep(Settings.FixedTimeStep, Result.Displacement);
+        Result.Displacement += Velocity * Settings.FixedTimeStep;
+    }
+    Result.PullAcceleration = LastPullAcceleration;
+    Result.NumSubsteps = NumSteps;
+
+    return Result;
+}
+
+
+FWireSolverStepResult FWireSolver::StepSubdivided(float DeltaTime, TArrayView<const FVector> Origins)
+{
+    FWireSolverStepResult Result;
+    if (DeltaTime <= 0.0f)
+        return Result;
+
+    // 固定タイムステップを超えない幅で等分
+    const int32 NumSteps = FMath::Clamp(
+        FMath::CeilToInt32(DeltaTime / Settings.FixedTimeStep - 1.0e-3f), 1, Settings.MaxSubsteps);
+    const float Dt = DeltaTime / NumSteps;
+
+    GatherBatch(Origins);
+    for (int32 i = 0; i < NumSteps; ++i)
+    {
+        LastPullAcceleration = Substep(Dt, Result.Displacement);
+        Result.Displacement += Velocity * Dt;
+    }
+    Result.PullAcceleration = LastPullAcceleration;
+    Result.NumSubsteps = NumSteps;
+
+    return Result;
+}
+
+
+void FWireSolver::GatherBatch(TArrayView<const FVector> Origins)
+{
+    Batch.Num = 0;
+
+    const int32 NumTethers = FMath::Min(Origins.Num(), Settings.NumTethers);
+    for (int32 i = 0; i < NumTethers; ++i)
+    {
+        const FWireTether& Tether = Tethers[i];
+        if (!Tether.bAttached)
+            continue;
+
+        // 巻き付いていれば最後の巻き付き点へ引く
+        const FVector ToPivot = Tether.GetPivot() - Origins[i];
+        Batch.ToPivotX[Batch.Num] = ToPivot.X;
+        Batch.ToPivotY[Batch.Num] = ToPivot.Y;
+        Batch.ToPivotZ[Batch.Num] = ToPivot.Z;
+        Batch.FreeLength[Batch.Num] = Tether.GetFreeLength();
+        ++Batch.Num;
+    }
+}
+
+
+FVector FWireSolver::Substep(float Dt, const FVector& Offset)
+{
+    // 重力演算
+    Velocity += FVector::DownVector * Settings.Gravity * Dt;
+
+    // 空気抵抗による減速処理
+    Velocity *= (1 - Settings.AirResistance * Dt);
+
+    return Settings.bUseXPBD ? SubstepXPBD(Dt, Offset) : SubstepPenalty(Dt, Offset);
+}
+
+
+FVector FWireSolver::SubstepPenalty(float Dt, const FVector& Offset)
+{
+    // 根元はこのステップ内で移動した分だけずらし、全ワイヤーの支点までの距離をまとめて求める
+    FVector::FReal ToAnchorX[MaxTethers], ToAnchorY[MaxTethers], ToAnchorZ[MaxTethers], Distance[MaxTethers];
+    for (int32 i = 0; i < Batch.Num; ++i)
+    {
+        ToAnchorX[i] = Batch.ToPivotX[i] - Offset.X;
+        ToAnchorY[i] = Batch.ToPivotY[i] - Offset.Y;
+        ToAnchorZ[i] = Batch.ToPivotZ[i] - Offset.Z;
+        Distance[i] = FMath::Sqrt(ToAnchorX[i] * ToAnchorX[i] + ToAnchorY[i] * ToAnchorY[i] + ToAnchorZ[i] * ToAnchorZ[i]);
+    }
+
+    // 引き寄せ加速度を定義
+    FVector PullAcceleration = FVector::ZeroVector;
+
+    for (int32 i = 0; i < Batch.Num; ++i)
+    {
+        // ワイヤーが張っていなければ何もしない
+        if (Distance[i] <= Batch.FreeLength[i])
+            continue;
+
+        const FVector Direction = FVector(ToAnchorX[i], ToAnchorY[i], ToAnchorZ[i]) / Distance[i];
+
+        // ワイヤー方向の速度を取得し、外方向の速度を打ち消し
+        const float DotProduct = FVector::DotProduct(Velocity, Direction);
+        if (DotProduct < 0)
+            Velocity -= Direction * DotProduct;
+
+        // 引き寄せ加速度の加算
+        PullAcceleration += Direction * (Distance[i] - Batch.FreeLength[i]) * Settings.PullStrength;
+    }
+
+    Velocity += PullAcceleration * Dt;
+
+    return PullAcceleration;
+}
+
+
+FVector FWireSolver::SubstepXPBD(float Dt, const FVector& Offset)
+{
+    // 速度で進めた予測位置（Step 開始時からの移動量）
+    const FVector Predicted = Offset + Velocity * Dt;
+    FVector Position = Predicted;
+
+    // コンプライアンスをタイムステップで割った値（大きいステップほど1回の補正が強くなり、伸びの解消が遅れない）
+    const float AlphaTilde = Settings.Compliance / (Dt * Dt);
+
+    // 各ワイヤーのラグランジュ乗数（片側拘束なので張っている間だけ蓄積する）
+    float Lambda[MaxTethers] = {};
+
+    for (int32 Iteration = 0; Iteration < Settings.NumIterations; ++Iteration)
+    {
+        for (int32 i = 0; i < Batch.Num; ++i)
+        {
+            // 支点から根元への向きと伸び（縮んでいる時は拘束しない）
+            const FVector FromPivot(Position.X - Batch.ToPivotX[i], Position.Y - Batch.ToPivotY[i], Position.Z - Batch.ToPivotZ[i]);
+            const float Distance = FromPivot.Size();
+            const float Stretch = Distance - Batch.FreeLength[i];
+            if (Stretch <= 0.0f || Distance <= UE_KINDA_SMALL_NUMBER)
+                continue;
+
+            // 質量 1 の点として乗数の増分を求め、支点へ向けて位置を補正
+            const float DeltaLambda = (-Stretch - AlphaTilde * Lambda[i]) / (1.0f + AlphaTilde);
+            Lambda[i] += DeltaLambda;
+            Position += FromPivot / Distance * DeltaLambda;
+        }
+    }
+
+    // 位置の変化から速度を求める
+    Velocity = (Position - Offset) / Dt;
+
+    // 張っているワイヤーから離れる向きの速度は残さない（ワイヤーは跳ね返らない）
+    for (int32 i = 0; i < Batch.Num; ++i)
+    {
+        if (Lambda[i] == 0.0f)
+            continue;
+
+        const FVector Direction = FVector(Batch.ToPivotX[i] - Position.X, Batch.ToPivotY[i] - Position.Y, Batch.ToPivotZ[i] - Position.Z).GetSafeNormal();
+        const float DotProduct = FVector::DotProduct(Velocity, Direction);
+        if (DotProduct < 0)
+            Velocity -= Direction * DotProduct;
+    }
+
+    // 拘束による補正を加速度に換算して返す
+    return (Position - Predicted) / (Dt * Dt);
+}
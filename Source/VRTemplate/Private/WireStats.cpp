@@ -0,0 +1,66 @@
+﻿#include "WireStats.h"
+#include "WireStatsSubsystem.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY(LogWire);
+
+DEFINE_STAT(STAT_WireVRPawnTick);
+DEFINE_STAT(STAT_WireVRPawnCheckConnectable);
+DEFINE_STAT(STAT_WireVRPawnUpdateWireMovement);
+DEFINE_STAT(STAT_WireVRPawnWireWrap);
+DEFINE_STAT(STAT_WireVRPawnWireRender);
+DEFINE_STAT(STAT_WireVRPawnCollisionMove);
+DEFINE_STAT(STAT_WireVRPawnCosmetic);
+DEFINE_STAT(STAT_WireVRPawnTrajectoryPreview);
+DEFINE_STAT(STAT_WireCharacterTick);
+DEFINE_STAT(STAT_WireCharacterCheckConnectable);
+DEFINE_STAT(STAT_WireCharacterUpdateWireMovement);
+DEFINE_STAT(STAT_WireAnchorIndexQuery);
+DEFINE_STAT(STAT_WireBatchFlush);
+DEFINE_STAT(STAT_WireSignificanceUpdate);
+DEFINE_STAT(STAT_WireStreamingPrediction);
+DEFINE_STAT(STAT_WireRopeSimulate);
+DEFINE_STAT(STAT_WireTracesIssued);
+DEFINE_STAT(STAT_WireAimCacheHits);
+DEFINE_STAT(STAT_WireAttaches);
+DEFINE_STAT(STAT_WireRopeParticles);
+DEFINE_STAT(STAT_WireWrapPoints);
+DEFINE_STAT(STAT_WireCollisionSubsteps);
+DEFINE_STAT(STAT_WireCollisionSweeps);
+DEFINE_STAT(STAT_WireVRPawnCorrections);
+DEFINE_STAT(STAT_WireVRPawnSavedMoves);
+DEFINE_STAT(STAT_WireSignificantPawns);
+DEFINE_STAT(STAT_WireCosmeticUpdatesSaved);
+DEFINE_STAT(STAT_WireBatchPushes);
+DEFINE_STAT(STAT_WireBatchedWires);
+DEFINE_STAT(STAT_WireStreamingShapes);
+DEFINE_STAT(STAT_WireAttachesPerSecond);
+DEFINE_STAT(STAT_WirePullMagnitude);
+
+CSV_DEFINE_CATEGORY_MODULE(VRTEMPLATE_API, Wire, true);
+
+UE_TRACE_CHANNEL_DEFINE(WireChannel);
+
+namespace WireStats
+{
+    void RecordAttach(const UWorld* World)
+    {
+        INC_DWORD_STAT(STAT_WireAttaches);
+        CSV_CUSTOM_STAT(Wire, Attaches, 1, ECsvCustomStatOp::Accumulate);
+
+        if (UWireStatsSubsystem* Subsystem = World ? World->GetSubsystem<UWireStatsSubsystem>() : nullptr)
+            Subsystem->RecordAttach(World->GetTimeSeconds());
+    }
+
+    void UpdateAttachRate(const UWorld* World)
+    {
+        if (UWireStatsSubsystem* Subsystem = World ? World->GetSubsystem<UWireStatsSubsystem>() : nullptr)
+            Subsystem->UpdateAttachRate(World->GetTimeSeconds());
+    }
+
+    void RecordPullMagnitude(float Magnitude)
+    {
+        INC_FLOAT_STAT_BY(STAT_WirePullMagnitude, Magnitude);
+        CSV_CUSTOM_STAT(Wire, PullMagnitude, Magnitude, ECsvCustomStatOp::Max);
+    }
+}
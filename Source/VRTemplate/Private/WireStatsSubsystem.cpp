@@ -0,0 +1,24 @@
+﻿#include "WireStatsSubsystem.h"
+#include "WireStats.h"
+
+
+bool UWireStatsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UWireStatsSubsystem::RecordAttach(double Time)
+{
+    RecentAttachTimes.Add(Time);
+}
+
+
+void UWireStatsSubsystem::UpdateAttachRate(double Time)
+{
+    // 1秒より前の記録を捨てて残りを数える
+    RecentAttachTimes.RemoveAll([Time](double AttachTime) { return Time - AttachTime > 1.0; });
+
+    SET_FLOAT_STAT(STAT_WireAttachesPerSecond, RecentAttachTimes.Num());
+    CSV_CUSTOM_STAT(Wire, AttachesPerSecond, RecentAttachTimes.Num(), ECsvCustomStatOp::Set);
+}
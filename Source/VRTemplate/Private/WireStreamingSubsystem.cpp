@@ -0,0 +1,190 @@
+﻿#include "WireStreamingSubsystem.h"
+#include "VRPawn.h"
+#include "WireCharacterMovementComponent.h"
+#include "WireStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionSubsystem.h"
+
+
+bool UWireStreamingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UWireStreamingSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UWireStreamingSubsystem, STATGROUP_Tickables);
+}
+
+
+void UWireStreamingSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // World Partition のマップ（Course_City・DistantView など）のみ
+    if (!InWorld.GetWorldPartition() || InWorld.GetNetMode() == NM_DedicatedServer)
+        return;
+
+    if (UWorldPartitionSubsystem* WorldPartitionSubsystem = InWorld.GetSubsystem<UWorldPartitionSubsystem>())
+    {
+        WorldPartitionSubsystem->RegisterStreamingSourceProvider(this);
+        bRegistered = true;
+    }
+}
+
+
+void UWireStreamingSubsystem::Deinitialize()
+{
+    if (bRegistered)
+    {
+        if (UWorldPartitionSubsystem* WorldPartitionSubsystem = GetWorld()->GetSubsystem<UWorldPartitionSubsystem>())
+            WorldPartitionSubsystem->UnregisterStreamingSourceProvider(this);
+        bRegistered = false;
+    }
+
+    Super::Deinitialize();
+}
+
+
+void UWireStreamingSubsystem::Tick(float DeltaTime)
+{
+    if (!bRegistered)
+        return;
+
+    // 軌道は数フレームに1回だけ先読みし直す
+    TimeUntilPrediction -= DeltaTime;
+    if (TimeUntilPrediction > 0.0f)
+        return;
+    TimeUntilPrediction = PredictionInterval;
+
+    WIRE_SCOPE_CYCLE_COUNTER(STAT_WireStreamingPrediction, StreamingPrediction);
+
+    Predictions.Reset();
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (!PlayerController || !PlayerController->IsLocalController() || !PlayerController->GetPawn())
+            continue;
+
+        FPrediction Prediction;
+        if (Predict(PlayerController->GetPawn(), Prediction))
+            Predictions.Add(Prediction);
+    }
+
+    int32 NumShapes = 0;
+    for (const FPrediction& Prediction : Predictions)
+        NumShapes += Prediction.NumPoints + Prediction.NumAnchors;
+    SET_DWORD_STAT(STAT_WireStreamingShapes, NumShapes);
+}
+
+
+bool UWireStreamingSubsystem::Predict(const APawn* Pawn, FPrediction& OutPrediction) const
+{
+    // ワイヤー機動の Pawn の状態と速度
+    const FWireSolver* Solver = nullptr;
+    FVector Velocity;
+    if (const AVRPawn* VRPawn = Cast<AVRPawn>(Pawn))
+    {
+        Solver = &VRPawn->GetWireSolver();
+        Velocity = VRPawn->GetWireVelocity();
+    }
+    else if (const UWireCharacterMovementComponent* WireMovement = Cast<UWireCharacterMovementComponent>(Pawn->GetMovementComponent()))
+    {
+        Solver = &WireMovement->GetWireSolver();
+        Velocity = Pawn->GetVelocity();
+    }
+    if (!Solver)
+        return false;
+
+    // 遅い間は通常のストリーミングに任せる
+    OutPrediction.Location = Pawn->GetActorLocation();
+    OutPrediction.Speed = Velocity.Size();
+    if (OutPrediction.Speed < MinSpeed)
+        return false;
+
+    for (int32 i = 0; i < Solver->GetNumTethers(); ++i)
+    {
+        const FWireTether& Tether = Solver->GetTether(i);
+        if (Tether.bAttached)
+            OutPrediction.Anchors[OutPrediction.NumAnchors++] = Tether.Anchor;
+    }
+
+    // ソルバーを複製して低い周波数で先へ進める（衝突は見ない。根元は体の中心で近似する）
+    FWireSolver Predictor = *Solver;
+    FWireSolverSettings Settings = Predictor.GetSettings();
+    if (!Settings.bUseXPBD)
+    {
+        Settings.bUseXPBD = true;
+        Settings.Compliance = Settings.PullStrength > 0.0f ? 1.0f / Settings.PullStrength : 0.0f;
+    }
+    Settings.FixedTimeStep = 1.0f / FMath::Max(PredictionRate, 1.0f);
+    Predictor.SetSettings(Settings);
+    Predictor.SetVelocity(Velocity);
+    Predictor.ResetAccumulator();
+
+    FVector Origins[FWireSolver::MaxTethers];
+    FVector Location = OutPrediction.Location;
+    const int32 NumSamples = FMath::Clamp(FMath::CeilToInt32(LookaheadTime / FMath::Max(SampleInterval, 0.01f)), 1, MaxSamples);
+    for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+    {
+        for (int32 i = 0; i < Predictor.GetNumTethers(); ++i)
+            Origins[i] = Location;
+        Location += Predictor.StepSubdivided(SampleInterval, MakeArrayView(Origins, Predictor.GetNumTethers())).Displacement;
+        OutPrediction.Points[OutPrediction.NumPoints++] = Location;
+    }
+
+    return true;
+}
+
+
+bool UWireStreamingSubsystem::GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const
+{
+    // 形の位置はソースからの相対位置（回転なし）
+    auto MakeSource = [](FName Name, const FVector& Location, EStreamingSourcePriority Priority, EStreamingSourceTargetState TargetState)
+    {
+        FWorldPartitionStreamingSource Source;
+        Source.Name = Name;
+        Source.Location = Location;
+        Source.Rotation = FRotator::ZeroRotator;
+        Source.Priority = Priority;
+        Source.TargetState = TargetState;
+        Source.bBlockOnSlowLoading = false;
+        return Source;
+    };
+    auto AddShape = [](FWorldPartitionStreamingSource& Source, const FVector& Location, float Radius)
+    {
+        FStreamingSourceShape& Shape = Source.Shapes.AddDefaulted_GetRef();
+        Shape.bUseGridLoadingRange = false;
+        Shape.Radius = Radius;
+        Shape.Location = Location - Source.Location;
+    };
+
+    const int32 NumNearPoints = FMath::Clamp(FMath::CeilToInt32(NearTime / FMath::Max(SampleInterval, 0.01f)), 0, MaxSamples);
+    for (int32 Index = 0; Index < Predictions.Num(); ++Index)
+    {
+        const FPrediction& Prediction = Predictions[Index];
+
+        FWorldPartitionStreamingSource Near = MakeSource(FName(TEXT("WirePathNear"), Index), Prediction.Location,
+            EStreamingSourcePriority::Highest, EStreamingSourceTargetState::Activated);
+        FWorldPartitionStreamingSource Far = MakeSource(FName(TEXT("WirePathFar"), Index), Prediction.Location,
+            EStreamingSourcePriority::High, EStreamingSourceTargetState::Loaded);
+        for (int32 i = 0; i < Prediction.NumPoints; ++i)
+            AddShape(i < NumNearPoints ? Near : Far, Prediction.Points[i], PathRadius);
+
+        FWorldPartitionStreamingSource Anchor = MakeSource(FName(TEXT("WireAnchor"), Index), Prediction.Location,
+            EStreamingSourcePriority::High, EStreamingSourceTargetState::Activated);
+        for (int32 i = 0; i < Prediction.NumAnchors; ++i)
+            AddShape(Anchor, Prediction.Anchors[i], AnchorRadius);
+
+        for (FWorldPartitionStreamingSource* Source : { &Near, &Far, &Anchor })
+        {
+            if (Source->Shapes.Num() > 0)
+                OutStreamingSources.Add(MoveTemp(*Source));
+        }
+    }
+
+    return Predictions.Num() > 0;
+}
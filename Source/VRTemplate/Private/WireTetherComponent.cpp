@@ -0,0 +1,111 @@
+﻿#include "WireTetherComponent.h"
+#include "GameFramework/Actor.h"
+#include "Components/SceneComponent.h"
+
+
+UWireTetherComponent::UWireTetherComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.TickGroup = TG_PrePhysics;
+}
+
+
+void UWireTetherComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    ApplySolverSettings();
+    SetComponentTickEnabled(bAutoMove);
+}
+
+
+void UWireTetherComponent::SetAutoMove(bool bInAutoMove)
+{
+    bAutoMove = bInAutoMove;
+    SetComponentTickEnabled(bAutoMove);
+}
+
+
+void UWireTetherComponent::ApplySolverSettings()
+{
+    FWireSolverSettings Settings = Solver.GetSettings();
+    Settings.NumTethers = NumTethers;
+    Settings.bUseXPBD = bUseXPBD;
+    Settings.Compliance = Compliance;
+    Settings.PullStrength = PullStrength;
+    Settings.Gravity = Gravity;
+    Settings.AirResistance = AirResistance;
+    Settings.FixedTimeStep = 1.0f / SimulationRate;
+    Settings.MaxWrapPoints = MaxWrapPoints;
+    Solver.SetSettings(Settings);
+}
+
+
+void UWireTetherComponent::AttachTether(int32 Index, const FVector& Anchor)
+{
+    if (Index >= 0 && Index < Solver.GetNumTethers())
+        Solver.Attach(Index, Anchor, GetTetherOrigin(Index));
+}
+
+
+void UWireTetherComponent::DetachTether(int32 Index)
+{
+    if (Index >= 0 && Index < Solver.GetNumTethers())
+        Solver.Detach(Index);
+}
+
+
+void UWireTetherComponent::ReelTether(int32 Index, float DeltaLength)
+{
+    if (IsTetherAttached(Index))
+        Solver.ReelWire(Index, GetTetherOrigin(Index), DeltaLength, MinLength, MaxLength);
+}
+
+
+bool UWireTetherComponent::IsTetherAttached(int32 Index) const
+{
+    return Index >= 0 && Index < Solver.GetNumTethers() && Solver.GetTether(Index).bAttached;
+}
+
+
+FVector UWireTetherComponent::GetTetherOrigin(int32 Index) const
+{
+    const AActor* Owner = GetOwner();
+    const FVector Offset = OriginOffsets.IsValidIndex(Index) ? OriginOffsets[Index] : FVector::ZeroVector;
+    return Owner ? Owner->GetActorTransform().TransformPosition(Offset) : Offset;
+}
+
+
+void UWireTetherComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    USceneComponent* Root = GetOwner() ? GetOwner()->GetRootComponent() : nullptr;
+    if (!bAutoMove || !Root)
+        return;
+
+    // 全ワイヤーの根元を固定長の配列に集めてまとめて演算
+    const FTransform& Transform = Root->GetComponentTransform();
+    FVector Origins[FWireSolver::MaxTethers];
+    for (int32 i = 0; i < Solver.GetNumTethers(); ++i)
+    {
+        Origins[i] = Transform.TransformPosition(OriginOffsets.IsValidIndex(i) ? OriginOffsets[i] : FVector::ZeroVector);
+    }
+    const FWireSolverStepResult Result = Solver.Step(DeltaTime, MakeArrayView(Origins, Solver.GetNumTethers()));
+    if (Result.Displacement.IsNearlyZero())
+        return;
+
+    // 衝突したら面に沿って残りを1回だけ動かし、面に向かう速度を打ち消す
+    FHitResult Hit;
+    Root->MoveComponent(Result.Displacement, Root->GetComponentQuat(), true, &Hit);
+    if (Hit.IsValidBlockingHit())
+    {
+        FVector Velocity = Solver.GetVelocity();
+        Velocity -= Hit.Normal * FMath::Min(FVector::DotProduct(Velocity, Hit.Normal), 0.0);
+        Solver.SetVelocity(Velocity);
+
+        const FVector Remaining = FVector::VectorPlaneProject(Result.Displacement * (1.0f - Hit.Time), Hit.Normal);
+        if (!Remaining.IsNearlyZero())
+            Root->MoveComponent(Remaining, Root->GetComponentQuat(), true);
+    }
+}
@@ -0,0 +1,67 @@
+﻿#include "WireTickProfiler.h"
+
+FWireTickProfiler* FWireTickProfiler::Active = nullptr;
+
+
+const TCHAR* FWireTickProfiler::GetPhaseName(EWireTickPhase Phase)
+{
+    switch (Phase)
+    {
+    case EWireTickPhase::Tick:               return TEXT("Tick");
+    case EWireTickPhase::CheckConnectable:   return TEXT("CheckConnectable");
+    case EWireTickPhase::UpdateWireMovement: return TEXT("UpdateWireMovement");
+    case EWireTickPhase::CollisionMove:      return TEXT("CollisionMove");
+    case EWireTickPhase::TrajectoryPreview:  return TEXT("TrajectoryPreview");
+    case EWireTickPhase::Cosmetic:           return TEXT("Cosmetic");
+    default:                                 return TEXT("Unknown");
+    }
+}
+
+
+void FWireTickProfiler::Reserve(int32 NumSamplesPerPhase)
+{
+    for (TArray<uint64>& PhaseSamples : Samples)
+    {
+        PhaseSamples.Reserve(NumSamplesPerPhase);
+    }
+}
+
+
+void FWireTickProfiler::Reset()
+{
+    for (TArray<uint64>& PhaseSamples : Samples)
+    {
+        PhaseSamples.Reset();
+    }
+}
+
+
+double FWireTickProfiler::GetPercentileMicroseconds(EWireTickPhase Phase, double Percentile) const
+{
+    const TArray<uint64>& PhaseSamples = Samples[(int32)Phase];
+    if (PhaseSamples.IsEmpty())
+        return 0.0;
+
+    // 並べ替えて該当順位の値を取得
+    TArray<uint64> Sorted = PhaseSamples;
+    Sorted.Sort();
+    const int32 Index = FMath::Clamp(FMath::CeilToInt32(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+
+    return FPlatformTime::ToMilliseconds64(Sorted[Index]) * 1000.0;
+}
+
+
+double FWireTickProfiler::GetMeanMicroseconds(EWireTickPhase Phase) const
+{
+    const TArray<uint64>& PhaseSamples = Samples[(int32)Phase];
+    if (PhaseSamples.IsEmpty())
+        return 0.0;
+
+    uint64 Total = 0;
+    for (uint64 Cycles : PhaseSamples)
+    {
+        Total += Cycles;
+    }
+
+    return FPlatformTime::ToMilliseconds64(Total) * 1000.0 / PhaseSamples.Num();
+}
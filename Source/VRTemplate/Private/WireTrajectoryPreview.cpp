@@ -0,0 +1,103 @@
+﻿#include "WireTrajectoryPreview.h"
+#include "HAL/PlatformTime.h"
+
+
+void FWireTrajectoryPreview::SetSettings(const FWireTrajectoryPreviewSettings& InSettings)
+{
+    Settings = InSettings;
+    Settings.StepsPerSecond = FMath::Max(Settings.StepsPerSecond, 1.0f);
+    Settings.ProbeInterval = FMath::Max(Settings.ProbeInterval, 1);
+}
+
+
+void FWireTrajectoryPreview::Begin(const FWireSolver& InSolver, int32 Index, const FVector& Anchor,
+    const FVector& InLocation, const FVector& InVelocity, TArrayView<const FVector> Origins)
+{
+    // ソルバーを複製して、照準先に接続した状態にする（既に接続中のワイヤーはそのまま）
+    Solver = InSolver;
+    Solver.SetVelocity(InVelocity);
+    Solver.ResetAccumulator();
+    Location = InLocation;
+    for (int32 i = 0; i < Solver.GetNumTethers(); ++i)
+    {
+        OriginOffset[i] = Origins.IsValidIndex(i) ? Origins[i] - InLocation : FVector::ZeroVector;
+    }
+    Solver.Attach(Index, Anchor, Location + OriginOffset[Index]);
+
+    TargetIndex = Index;
+    TargetAnchor = Anchor;
+
+    // 予測時間を区間に分ける（頂点数の上限で打ち切る）
+    const float SegmentTime = Settings.ProbeInterval / Settings.StepsPerSecond;
+    RemainingSegments = FMath::Clamp(FMath::CeilToInt32(Settings.PreviewTime / SegmentTime), 1, MaxPoints - 1);
+
+    Points[0] = Location;
+    NumPoints = 1;
+    bRunning = true;
+}
+
+
+bool FWireTrajectoryPreview::Advance(FWireTrajectoryProbeFunction Probe)
+{
+    if (!bRunning)
+        return false;
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    const uint64 BudgetCycles = (uint64)(Settings.BudgetMicroseconds / (FPlatformTime::GetSecondsPerCycle64() * 1.0e6));
+
+    // 予算を使い切るまで区間単位で進める（必ず1区間は進める）
+    do
+    {
+        AdvanceSegment(Probe);
+    }
+    while (bRunning && FPlatformTime::Cycles64() - StartCycles < BudgetCycles);
+
+    LastAdvanceMicroseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0;
+
+    if (bRunning)
+        return false;
+
+    // 完了したので表示用に移す
+    FMemory::Memcpy(ResultPoints, Points, NumPoints * sizeof(FVector));
+    NumResultPoints = NumPoints;
+    return true;
+}
+
+
+void FWireTrajectoryPreview::AdvanceSegment(FWireTrajectoryProbeFunction Probe)
+{
+    // 根元は Pawn との位置関係を保って動かす
+    const float StepTime = 1.0f / Settings.StepsPerSecond;
+    FVector Origins[FWireSolver::MaxTethers];
+    for (int32 Step = 0; Step < Settings.ProbeInterval; ++Step)
+    {
+        for (int32 i = 0; i < Solver.GetNumTethers(); ++i)
+        {
+            Origins[i] = Location + OriginOffset[i];
+        }
+        Location += Solver.StepSubdivided(StepTime, MakeArrayView(Origins, Solver.GetNumTethers())).Displacement;
+    }
+
+    // 進んだ区間が遮られていればそこで終わり
+    const FVector& Prev = Points[NumPoints - 1];
+    FVector HitLocation;
+    if (Probe(Prev, Location, HitLocation))
+    {
+        Points[NumPoints++] = HitLocation;
+        bRunning = false;
+        return;
+    }
+
+    Points[NumPoints++] = Location;
+    if (--RemainingSegments <= 0)
+        bRunning = false;
+}
+
+
+void FWireTrajectoryPreview::Reset()
+{
+    bRunning = false;
+    NumPoints = 0;
+    NumResultPoints = 0;
+    TargetIndex = INDEX_NONE;
+}
@@ -0,0 +1,256 @@
+﻿#include "WireWarmupSubsystem.h"
+#include "WireBatchComponent.h"
+#include "WireRenderSubsystem.h"
+#include "WireStats.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Components/SplineMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/PackageName.h"
+#include "PipelineStateCache.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+    // ワイヤーの状態（Custom Primitive Data の 0 番）
+    constexpr float WireStates[] = { 0.0f, 1.0f, 2.0f };
+
+    // 視点の前に並べる位置と大きさ（数ピクセルだけ描画される）
+    constexpr float WarmupDistance = 50.0f;
+    constexpr float WarmupSpacing = 0.5f;
+    constexpr float WarmupScale = 0.002f;
+}
+
+
+bool UWireWarmupSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // 描画しない（専用サーバー・-nullrhi のベンチマークやソークテスト）なら不要
+    return Super::ShouldCreateSubsystem(Outer) && !IsRunningDedicatedServer() && FApp::CanEverRender();
+}
+
+
+void UWireWarmupSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UWireWarmupSubsystem::OnPostLoadMap);
+}
+
+
+void UWireWarmupSubsystem::Deinitialize()
+{
+    FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+    if (LoadHandle.IsValid())
+        LoadHandle->CancelHandle();
+    LoadHandle.Reset();
+
+    Super::Deinitialize();
+}
+
+
+TStatId UWireWarmupSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UWireWarmupSubsystem, STATGROUP_Tickables);
+}
+
+
+void UWireWarmupSubsystem::OnPostLoadMap(UWorld* World)
+{
+    // 起動後に最初に WarmupMap を開いた時だけ行う（PIE の複数クライアントでは自分のゲームインスタンスのワールドのみ）
+    if (State != EWarmupState::Idle || !World || World->GetGameInstance() != GetGameInstance())
+        return;
+
+    const FString MapName = UWorld::RemovePIEPrefix(FPackageName::GetShortName(World->GetOutermost()->GetName()));
+    if (MapName != WarmupMap)
+        return;
+
+    WarmupWorld = World;
+    StartTime = FPlatformTime::Seconds();
+    State = EWarmupState::Loading;
+
+    TArray<FSoftObjectPath> Assets = WireMaterials;
+    Assets.Append(CourseMaterials);
+    Assets.Add(WireMesh);
+    Assets.Add(CourseMesh);
+    Assets.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+
+    LoadHandle = StreamableManager.RequestAsyncLoad(Assets, FStreamableDelegate::CreateUObject(this, &UWireWarmupSubsystem::OnAssetsLoaded));
+    if (!LoadHandle.IsValid())
+        OnAssetsLoaded();
+}
+
+
+void UWireWarmupSubsystem::OnAssetsLoaded()
+{
+    LoadHandle.Reset();
+    LoadSeconds = FPlatformTime::Seconds() - StartTime;
+
+    UWorld* World = WarmupWorld.Get();
+    if (!World)
+    {
+        Finish();
+        return;
+    }
+
+    SpawnWarmupPrimitives(World);
+    FramesRendered = 0;
+    State = EWarmupState::Rendering;
+}
+
+
+void UWireWarmupSubsystem::SpawnWarmupPrimitives(UWorld* World)
+{
+    // 視点の前（プレイヤーがいなければ原点）
+    FTransform ViewTransform = FTransform::Identity;
+    if (APlayerController* PlayerController = World->GetFirstPlayerController())
+    {
+        if (PlayerController->PlayerCameraManager)
+            ViewTransform = FTransform(PlayerController->PlayerCameraManager->GetCameraRotation(), PlayerController->PlayerCameraManager->GetCameraLocation());
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.ObjectFlags |= RF_Transient;
+    AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), ViewTransform, SpawnParams);
+    if (!Actor)
+        return;
+    WarmupActor = Actor;
+
+    USceneComponent* Root = NewObject<USceneComponent>(Actor);
+    Actor->SetRootComponent(Root);
+    Root->RegisterComponent();
+    Root->SetWorldTransform(ViewTransform);
+
+    // 横に並べる位置
+    int32 Slot = 0;
+    auto NextLocation = [&Slot]()
+    {
+        const float Offset = (Slot++ - 4) * WarmupSpacing;
+        return FVector(WarmupDistance, Offset, 0.0f);
+    };
+
+    auto AddPrimitive = [Actor, Root](UPrimitiveComponent* Component, const FVector& Location)
+    {
+        Component->SetupAttachment(Root);
+        Component->SetRelativeLocation(Location);
+        Component->SetMobility(EComponentMobility::Movable);
+        Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        Component->CastShadow = false;
+        Component->RegisterComponent();
+        Actor->AddInstanceComponent(Component);
+    };
+
+    // ワイヤー: Spline Mesh で各状態を描画
+    UStaticMesh* Mesh = Cast<UStaticMesh>(WireMesh.ResolveObject());
+    UMaterialInterface* FirstWireMaterial = nullptr;
+    NumMaterials = 0;
+    for (const FSoftObjectPath& Path : WireMaterials)
+    {
+        UMaterialInterface* Material = Cast<UMaterialInterface>(Path.ResolveObject());
+        if (!Material)
+            continue;
+        ++NumMaterials;
+        if (!FirstWireMaterial)
+            FirstWireMaterial = Material;
+
+        for (float WireState : WireStates)
+        {
+            USplineMeshComponent* Spline = NewObject<USplineMeshComponent>(Actor);
+            Spline->SetStaticMesh(Mesh);
+            Spline->SetMaterial(0, Material);
+            Spline->SetStartScale(FVector2D::UnitVector * WarmupScale);
+            Spline->SetEndScale(FVector2D::UnitVector * WarmupScale);
+            Spline->SetStartAndEnd(FVector::ZeroVector, FVector::UpVector, FVector::UpVector * WarmupSpacing, FVector::UpVector);
+            Spline->SetCustomPrimitiveDataFloat(0, WireState);
+            AddPrimitive(Spline, NextLocation());
+        }
+    }
+
+    // ワイヤー: まとめ描画で各状態を描画（Tick の最後に UWireRenderSubsystem が送る）
+    if (UWireRenderSubsystem* WireRender = World->GetSubsystem<UWireRenderSubsystem>())
+    {
+        if (FirstWireMaterial)
+        {
+            UWireBatchComponent* Batch = WireRender->GetRenderer(FirstWireMaterial);
+            WireBatch = Batch;
+            for (float WireState : WireStates)
+            {
+                const FVector Start = Root->GetComponentTransform().TransformPosition(NextLocation());
+                const int32 Handle = Batch->AddWire();
+                Batch->SetWireCurve(Handle, Start, FVector::ZeroVector, Start + FVector::UpVector * WarmupSpacing, FVector::ZeroVector);
+                Batch->SetWireState(Handle, WireState);
+                Batch->SetWireOrigin(Handle, Start);
+                Batch->SetWireVisible(Handle, true);
+                WireBatchHandles.Add(Handle);
+            }
+        }
+    }
+
+    // コース: Static Mesh に貼って描画
+    UStaticMesh* Cube = Cast<UStaticMesh>(CourseMesh.ResolveObject());
+    for (const FSoftObjectPath& Path : CourseMaterials)
+    {
+        UMaterialInterface* Material = Cast<UMaterialInterface>(Path.ResolveObject());
+        if (!Material || !Cube)
+            continue;
+        ++NumMaterials;
+
+        UStaticMeshComponent* MeshComponent = NewObject<UStaticMeshComponent>(Actor);
+        MeshComponent->SetStaticMesh(Cube);
+        MeshComponent->SetMaterial(0, Material);
+        MeshComponent->SetRelativeScale3D(FVector(WarmupScale));
+        AddPrimitive(MeshComponent, NextLocation());
+    }
+}
+
+
+void UWireWarmupSubsystem::Tick(float DeltaTime)
+{
+    // マップを離れたら打ち切る
+    if (!WarmupWorld.IsValid())
+    {
+        Finish();
+        return;
+    }
+
+    // 描画して PSO が使われるまで数フレーム置く
+    if (State == EWarmupState::Rendering)
+    {
+        if (++FramesRendered >= WarmupFrames)
+        {
+            if (AActor* Actor = WarmupActor.Get())
+                Actor->Destroy();
+            if (UWireBatchComponent* Batch = WireBatch.Get())
+            {
+                for (int32 Handle : WireBatchHandles)
+                    Batch->RemoveWire(Handle);
+            }
+            WireBatchHandles.Reset();
+            State = EWarmupState::Compiling;
+        }
+        return;
+    }
+
+    // 登録時に発行されたプリキャッシュが終わるまで待つ
+    if (PipelineStateCache::NumActivePrecacheRequests() == 0 || FPlatformTime::Seconds() - StartTime > MaxWarmupTime)
+        Finish();
+}
+
+
+void UWireWarmupSubsystem::Finish()
+{
+    if (AActor* Actor = WarmupActor.Get())
+        Actor->Destroy();
+    WarmupActor.Reset();
+    WireBatchHandles.Reset();
+
+    WarmupSeconds = FPlatformTime::Seconds() - StartTime;
+    State = EWarmupState::Done;
+
+    UE_LOG(LogWire, Log, TEXT("Warm-up finished in %.2f s (load %.2f s, %d materials, %u PSO precache requests pending)"),
+        WarmupSeconds, LoadSeconds, NumMaterials, PipelineStateCache::NumActivePrecacheRequests());
+
+    OnWarmupComplete.Broadcast();
+}
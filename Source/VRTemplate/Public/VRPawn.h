@@ -9,9 +9,23 @@
 #include "Components/Image.h"
 #include "MotionControllerComponent.h"
 #include "Components/AudioComponent.h"
+#include "WorldCollision.h"
+#include "WireTetherComponent.h"
+#include "WireAimCache.h"
+#include "WireRope.h"
+#include "WireTrajectoryPreview.h"
+#include "VRPawnMove.h"
+#include "VRPawnTickFunction.h"
+#include "WireSignificanceSubsystem.h"
+#include "WireGhostRecorder.h"
+#include "WireInputRecording.h"
 #include "VRPawn.generated.h"
 
 class UCameraComponent;
+class ULineBatchComponent;
+class UWireAnchorSubsystem;
+class UWireBatchComponent;
+class FWireAsyncCallback;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
@@ -21,6 +35,13 @@ class VRTEMPLATE_API AVRPawn : public APawn
 {
     GENERATED_BODY()
 
+    // ベンチマークから入力と姿勢を直接与える
+    friend class UWireBenchmarkCommandlet;
+
+    // 見た目の更新は移動とは別の Tick で行う
+    friend struct FVRPawnCosmeticTickFunction;
+    friend struct FVRPawnRopeTickFunction;
+
     /** MappingContext */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
     UInputMappingContext* DefaultMappingContext;
@@ -47,24 +68,194 @@ class VRTEMPLATE_API AVRPawn : public APawn
 public:
     AVRPawn();
 
+    // 照準キャッシュを再利用できた回数とトレースした回数（左右の合計）
+    void GetAimCacheCounters(uint32& OutHits, uint32& OutMisses) const;
+
+    // サーバーで実行した入力の数と、そのうち補正を返した数
+    void GetServerMoveCounters(uint32& OutMoves, uint32& OutCorrections) const;
+
+    // ワイヤーが接続されているか
+    bool IsWireAttached(int index) const { return WireTether->GetSolver().GetTether(index).bAttached; }
+
+    // ワイヤーの状態と現在の速度（軌道の先読み用）
+    const FWireSolver& GetWireSolver() const { return WireTether->GetSolver(); }
+    const FVector& GetWireVelocity() const { return CurrentVelocity; }
+
+    // 固定ステップで進めた位置（描画用に補間する前の位置。自分で動かしている Pawn のみ）
+    const FVector& GetSimulatedLocation() const { return SimulatedLocation; }
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    // コースの走りを Saved/Ghosts/<Name>.wghost に記録する（自分の Pawn のみ）
+    UFUNCTION(BlueprintCallable, Category = "Ghost")
+    bool StartGhostRecording(const FString& Name);
+
+    // 記録を終えてファイルを閉じる
+    UFUNCTION(BlueprintCallable, Category = "Ghost")
+    void StopGhostRecording();
+
+    // 入力とコントローラー・HMD の姿勢を Saved/InputRecordings/<Name>.winput に記録する（自分の Pawn のみ）
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool StartInputRecording(const FString& Name);
+
+    // 記録を終えてファイルに保存
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    void StopInputRecording();
+
+    // 記録した1フレーム分の入力と姿勢を次の Tick に与える（ベンチマークの再生用）
+    void ApplyRecordedFrame(const FWireInputFrame& Frame);
+
+    // 記録開始時の状態に戻す（ベンチマークの再生用）
+    void ApplyRecordingStart(const FWireInputRecording& Recording);
+
+    // 見た目の更新頻度を変更 (Hz)。0 なら毎フレーム
+    UFUNCTION(BlueprintCallable, Category = "Performance")
+    void SetCosmeticTickRate(float Rate);
+
+    // 重要度に応じて見た目の更新を減らす（TickRate は上限の頻度、0 なら CosmeticTickRate のまま）
+    void SetCosmeticSignificance(EWireCosmeticSignificance InSignificance, float TickRate);
+    EWireCosmeticSignificance GetCosmeticSignificance() const { return CosmeticSignificance; }
+
 protected:
     void Move(const FInputActionValue& Value); /* 開発用 */
     void Jump(const FInputActionValue& Value);
 
+    // 入力の反映（PerformMove から呼ぶ）
+    void ApplyMoveInput(const FVector2D& MovementVector); /* 開発用 */
+    void ApplyJump();
+
+    // この端末で入力から移動を進めるか（スタンドアロン・ホスト・クライアントの自分の Pawn）
+    bool IsLocallySimulated() const;
+
+    // このフレームの入力とコントローラーの姿勢をまとめる
+    FVRPawnMove ConsumePendingMove(float deltaTime);
+
+    // このフレームで進める移動の固定ステップの回数と1ステップの時間
+    int32 ConsumeMovementSteps(float deltaTime, float& OutStepTime);
+
+    // 描画用の補間をやめて固定ステップの位置に戻し、端数時間を捨てる（記録の開始・再生用）
+    void ResetMovementInterpolation();
+
+    // 1フレーム分の入力を反映して移動する（bApplyPoses 時は記録されたコントローラーの姿勢を使う）
+    FWireSolverStepResult PerformMove(const FVRPawnMove& Move, bool bApplyPoses);
+
+    // クライアントの1フレーム分の入力をサーバーで実行し、結果がずれていれば補正を返す
+    UFUNCTION(Server, Unreliable)
+    void ServerMove(const TArray<FVRPawnMove>& Moves, const TArray<FVRPawnMove>& PreviousMoves);
+    bool ProcessServerMove(const FVRPawnMove& Move);
+
+    // サーバーでの結果が一致した入力を保存分から取り除く（サーバーは複製の度に最新の分だけ送る）
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+    UFUNCTION(Client, Unreliable)
+    void ClientAckGoodMove(float TimeStamp);
+
+    // サーバーの状態とワイヤー演算の端数時間に合わせ、未承認の入力を再生し直す
+    UFUNCTION(Client, Unreliable)
+    void ClientAdjustPosition(const FVRPawnNetState& State, float SolverTime);
+
+    // 現在の状態を複製用にまとめる・複製された状態を反映する
+    FVRPawnNetState MakeNetState(float TimeStamp) const;
+    void ApplyNetState(const FVRPawnNetState& State, bool bTeleport);
+
+    UFUNCTION()
+    void OnRep_NetState();
+
+    // 他プレイヤーの Pawn をサーバーの状態へ滑らかに近づける
+    void SmoothSimulatedProxy(float deltaTime);
+
+    // 補正で生じた視点のずれを徐々に戻す
+    void UpdateCorrectionSmoothing(float deltaTime);
+
+    // 補間と補正のずれをカメラ・手・体に見た目だけ与える
+    void ApplyVisualOffset();
+
+    // 接続状態が補正や複製で変わった時にワイヤーの見た目を合わせる
+    void SyncWireVisual(int index);
+
+    // 記録中ならゴーストのサンプルを積む
+    void RecordGhostSample(float deltaTime);
+
     virtual void NotifyControllerChanged() override;
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float deltaTime) override;
+    virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+    // 見た目の Tick の間隔を CosmeticTickRate と重要度から更新
+    void UpdateCosmeticTickInterval();
+
+    // 重要度で見えなくなった時にワイヤーと風切り音を止め、戻った時に今の状態で表示し直す
+    void SetCosmeticsCulled(bool bCulled);
+
+    // 見た目の更新（FVRPawnCosmeticTickFunction から呼ぶ）
+    void TickCosmetic(float deltaTime);
+
+    // ロープのシミュレーション（FVRPawnRopeTickFunction から呼ぶ。ワーカースレッドで実行される場合がある）
+    void TickRopeSimulation(float deltaTime);
     virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
 
-    // ワイヤー接続可否判定
+    // ワイヤー接続可否判定（bForceUpdate 時は同期トレースで即時判定）
     void CheckConnectable(int index, bool bForceUpdate);
 
-    // ワイヤー機動の更新
-    FVector UpdateWireMovement(float deltaTime);
+    // ワイヤー機動の更新（重力・空気抵抗・引き寄せを固定タイムステップで NumSteps 回演算）
+    FWireSolverStepResult UpdateWireMovement(int32 NumSteps);
+
+    // 1フレーム分の演算と衝突付き移動を、速さとワイヤーの伸びから決めた回数に分けて交互に行う
+    FWireSolverStepResult MoveSubstepped(float deltaTime, int32 NumSolverSteps, int32 MaxSweeps);
+
+    // 物理スレッドでのワイヤー演算の開始・終了
+    void StartAsyncPhysicsWire();
+    void StopAsyncPhysicsWire();
+
+    // 物理スレッドへワイヤーの状態と入力による速度の変化を送り、前回までの結果を受け取る
+    FWireSolverStepResult SendAsyncPhysicsInput(const FVector& VelocityChange);
+
+    // 衝突付き移動を何回に分けるか（固定タイムステップの回数・MaxCollisionSubsteps・MaxCollisionSweeps を超えない）
+    int32 CalculateCollisionSubsteps(float deltaTime, int32 NumSolverSteps, int32 MaxSweeps) const;
+
+    // 接続中のワイヤーのうち最も大きい伸び（支点までの距離 - 使える長さ）
+    float GetWireConstraintError() const;
+
+    // ワイヤーの角への巻き付き・解除の判定
+    void UpdateWireWrap(int index);
+
+    // 巻き付いて固定された区間の描画を更新
+    void UpdateWrapSegments();
+
+    // ロープを進める（粒子の計算のみで、コンポーネントやソルバーではなく RopeInput だけを読む）
+    void SimulateWireRope(int index, float deltaTime);
+
+    // ロープの Tick が読む根元・支点・使える長さを写す（Tick の最後にゲームスレッドで呼ぶ）
+    void CaptureRopeInput();
+
+    // ワイヤーの描画（ロープのたるみ・切断後の巻き戻しを含む）
+    void UpdateWireVisual(int index);
+
+    // ワイヤーの描画先（一括描画が有効ならバッチ、無効なら Spline Mesh）への受け渡し
+    void SetWireCurve(int index, const FVector& Start, const FVector& StartTangent, const FVector& End, const FVector& EndTangent);
+    void SetWireMaterialState(int index, float State);
+    void SetWireGunLocation(int index, const FVector& Location);
+    void SetWireVisibility(int index, bool bVisible);
+
+    // 照準先に接続した場合の軌道を予算内で予測し、完了したら描画する
+    void UpdateTrajectoryPreview();
+
+    // 衝突付き移動と衝突後の速度の更新（当たった面に沿って滑らせる、スイープは MaxSweeps 回まで）
+    // 戻り値は実行したスイープの回数
+    int32 MoveWithCollision(const FWireSolverStepResult& StepResult, float deltaTime, int32 MaxSweeps);
+
+    // 照準用レイでワイヤーの接続先を探す
+    bool TraceAim(const FVector& Start, const FVector& Forward, FHitResult& OutHit);
+
+    // 接続先の索引を取得（使用しない設定なら nullptr）
+    UWireAnchorSubsystem* GetAnchorIndex() const;
 
     // コントローラーのワールド座標を取得
     FVector GetControllerLocation(int index) const;
 
+    // 描画用のコントローラーのワールド座標を取得（補間・補正のずれを含む）
+    FVector GetControllerVisualLocation(int index) const;
+
     // コントローラーの正面方向を取得
     FVector GetControllerForward(int index) const;
 
@@ -73,12 +264,15 @@ protected:
     void ToggleWire_L();
     void ToggleWire_R();
 
+    // 次の入力で送る接続しておきたい状態を今の接続状態に合わせる
+    void SyncWantsWireFlags();
+
     // ワイヤー機動の開始・終了
     void AttachWire(int index);
     void DetachWire(int index);
 
     // ワイヤーを巻き取る
-    void RetractWire(int index);
+    void RetractWire(int index, float deltaTime);
     void RetractWire_L();
     void RetractWire_R();
 
@@ -116,27 +310,98 @@ private:
     UPROPERTY(EditAnywhere, Category = "Move Settings")
     float AirResistance = 0.1f;
 
-    /* 左右の区別がある場合は左が[0]で右が[1]とする */
+    UPROPERTY(EditAnywhere, Category = "Move Settings", meta = (ClampMin = "0"))
+    float MovementStepRate = 90.0f; // 移動を進める固定ステップの頻度 (Hz)。SimulationRate を割り切れない値は BeginPlay で近い値に合わせる（0 なら毎フレームの時間で進める）
 
-    // ワイヤーが接続されているか
-    TArray<bool> bWireAttached;
+    UPROPERTY(EditAnywhere, Category = "Move Settings", meta = (ClampMin = "1"))
+    int32 MaxMovementStepsPerFrame = 4; // 1フレームで進める固定ステップの上限（超過分の時間は捨てる）
+
+    // 固定ステップに満たない端数時間
+    float MovementAccumulator = 0.0f;
+
+    // 入力のタイムスタンプに使う移動の時刻（1フレームで複数ステップ進めても増え続ける）
+    double MovementTime = 0.0;
+
+    // 直前の2ステップ後の位置と、描画用にその間を補間した位置の SimulatedLocation からのずれ
+    FVector PrevSimulatedLocation = FVector::ZeroVector;
+    FVector SimulatedLocation = FVector::ZeroVector;
+    FVector InterpolationOffset = FVector::ZeroVector;
+
+    // 見た目に与えている補間と補正のずれ
+    FVector VisualOffset = FVector::ZeroVector;
+
+    // ずれを与える手・体のメッシュと元の相対位置
+    UPROPERTY(Transient)
+    TArray<USceneComponent*> VisualOffsetComponents;
+    TArray<FVector> VisualOffsetBaseLocations;
+
+    // 直前の移動で行ったスイープの回数
+    int32 LastMoveSweeps = 0;
+
+    UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "1"))
+    float MaxCollisionStepDistance = 15.0f; // 1回のスイープで進む距離の目安 (cm)。これを超える速さなら分けて移動する
+
+    UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "1", ClampMax = "32"))
+    int32 MaxCollisionSubsteps = 8; // 1フレームの衝突付き移動を分ける回数の上限
+
+    UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 MaxSlideIterations = 3; // 1回の移動で当たった面に沿って滑らせる回数の上限
+
+    UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "1"))
+    int32 MaxCollisionSweeps = 16; // 1フレームのスイープ回数の上限（そのフレームで進める全ステップの合計）
+
+    /* 左右の区別がある場合は左が[0]で右が[1]とする */
 
     // 前フレームでワイヤーが接続可能だったか
-    TArray<bool> bPrevConnectable;
+    bool bPrevConnectable[2] = { false, false };
+
+    // 照準用レイの結果のキャッシュ
+    FWireAimCache AimCache[2];
+
+    // 発行済みの照準用非同期トレース
+    FTraceHandle AimTraceHandle[2];
 
-    // 現在のワイヤーの長さ
-    TArray<float> CurrentWireLength;
+    // ワイヤーの状態と速度の演算（左右の2本。bAutoMove は false）
+    UPROPERTY(VisibleAnywhere, Category = "Wire")
+    UWireTetherComponent* WireTether;
+
+    // 物理スレッドでワイヤーを演算するコールバック（bUseAsyncPhysicsWire の時のみ）
+    FWireAsyncCallback* WireAsyncCallback = nullptr;
+
+    // 物理スレッドへ送った速度の変化の通し番号と、まだ加えたと返ってきていない変化
+    uint32 AsyncVelocityChangeSequence = 0;
+    TArray<FWireAsyncVelocityChange> AsyncPendingVelocityChanges;
 
-    // 接続時のワイヤーの長さ
-    TArray<float> AttachWireLength;
+    // 最後に受け取った引き寄せ加速度
+    FVector AsyncPullAcceleration = FVector::ZeroVector;
 
-    // Static なオブジェクトに接続した場合の固定座標
-    TArray < FVector > StaticAnchorLocation;
+    // 前回物理スレッドへ送ったワイヤーの接続状態（左右のビット）
+    uint32 AsyncAttachedMask = 0;
+
+    // ワイヤーの見た目用ロープ
+    FWireRope WireRope[2];
 
     // Spline に沿ってメッシュを描画する
     UPROPERTY(VisibleAnywhere, Category = "Wire")
     TArray< USplineMeshComponent*> SplineMeshComponent;
 
+    // 巻き付いて固定された区間の描画（必要になった分だけ作成して使い回す）
+    UPROPERTY(Transient)
+    TArray<USplineMeshComponent*> WrapSegmentMesh;
+
+    // 全プレイヤーのワイヤーを1つの動的メッシュで描画する（false なら Spline Mesh で描画）
+    // 状態と銃の位置を頂点の UV で渡すので、M_VRWire が Custom Primitive Data の代わりに UV1～UV3 を読むようになるまで false にしておく
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseBatchedWireRenderer = false;
+
+    // 一括描画のコンポーネント（ワールドで共有）
+    UPROPERTY(Transient)
+    UWireBatchComponent* WireBatch = nullptr;
+
+    // 一括描画でのワイヤー（左/右）と巻き付き区間のハンドル
+    int32 WireBatchHandle[2] = { INDEX_NONE, INDEX_NONE };
+    TArray<int32> WrapSegmentWires;
+
     // モーションコントローラー（左/右）
     UPROPERTY(VisibleAnywhere, Category = "Controller")
     TArray <UMotionControllerComponent*> MotionController;
@@ -156,6 +421,174 @@ private:
     UPROPERTY(EditAnywhere, Category = "Wire Settings")
     float DetachRate = 0.25f; // ワイヤー切断条件値
 
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    float WirePullStrength = 300.0f; // ワイヤーの引き寄せ係数（bUseXPBDTether が false の時のみ使用）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseXPBDTether = true; // ワイヤーを XPBD の距離拘束として解く（演算周波数を 30Hz まで下げても発散しない）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "0", EditCondition = "bUseXPBDTether"))
+    float WireCompliance = 1.0f / 300.0f; // ワイヤーの柔らかさ（0 で伸びない。1 / 引き寄せ係数 で従来と同じ強さ）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseAsyncAimTrace = true; // 照準判定を非同期トレースで行う（結果は1フレーム遅れて反映）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    FWireAimCacheSettings AimCacheSettings; // 照準結果を再利用する条件
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseAnchorIndex = false; // 物理シーンではなく接続先の索引で照準判定を行う（Static な面のみ対象）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "0", ClampMax = "30", EditCondition = "bUseAnchorIndex"))
+    float AimAssistAngle = 3.0f; // 照準アシストの角度（度）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "0", ClampMax = "32"))
+    int32 MaxWrapPoints = 8; // ワイヤーが角に巻き付ける点の上限（0 なら巻き付かない）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "30"))
+    float SimulationRate = 360.0f; // ワイヤー演算の固定周波数 (Hz)
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseAsyncPhysicsWire = false; // ワイヤーの引き寄せを Chaos の物理スレッドで演算し、移動と衝突を物理に任せる（スタンドアロンのみ。Tick Physics Async と併用する）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseRopeSimulation = true; // ワイヤーをたるむロープとして描画する（false なら直線）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (EditCondition = "bUseRopeSimulation"))
+    FWireRopeSettings RopeSettings; // ロープの粒子数・処理時間の予算など
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bShowTrajectoryPreview = true; // 照準先に接続した場合のスイングの軌道を表示する
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (EditCondition = "bShowTrajectoryPreview"))
+    FWireTrajectoryPreviewSettings TrajectoryPreviewSettings; // 予測時間・処理時間の予算など
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "0", EditCondition = "bShowTrajectoryPreview"))
+    float TrajectoryRestartDistance = 50.0f; // 予測中に照準先がこれ以上動いたら途中でもやり直す (cm)
+
+    // 軌道の予測
+    FWireTrajectoryPreview TrajectoryPreview;
+
+    /* 見た目の更新 */
+
+    UPROPERTY(EditAnywhere, Category = "Performance", meta = (ClampMin = "0"))
+    float CosmeticTickRate = 0.0f; // ワイヤーの描画・風切り音・腕の向きを更新する頻度 (Hz)。0 なら毎フレーム
+
+    UPROPERTY(EditAnywhere, Category = "Performance")
+    bool bSimulateRopeOnWorkerThread = false; // ロープのシミュレーションをワーカースレッドで行う
+
+    // ロープのシミュレーションが読む値（ゲームスレッドの Tick の最後に写す）
+    struct FRopeInput
+    {
+        bool bAttached = false;
+        FVector HandLocation = FVector::ZeroVector;
+        FVector Pivot = FVector::ZeroVector;
+        float FreeLength = 0.0f;
+    };
+    FRopeInput RopeInput[2];
+
+    FVRPawnCosmeticTickFunction CosmeticTickFunction;
+    FVRPawnRopeTickFunction RopeTickFunction;
+
+    // 重要度による見た目の更新の段階と頻度の上限 (Hz)
+    EWireCosmeticSignificance CosmeticSignificance = EWireCosmeticSignificance::Full;
+    float SignificanceTickRate = 0.0f;
+
+    // 見えなくなった時に止めた風切り音（戻った時に再生し直す）
+    bool bWindAudioCulled = false;
+
+    // 重要度を決めるサブシステム（専用サーバーでは null）
+    UPROPERTY(Transient)
+    UWireSignificanceSubsystem* SignificanceSubsystem;
+
+    // 切断後の巻き戻しを終えたロープ（次の見た目の更新で照準表示へ戻す）
+    bool bRopeRecoilFinished[2] = { false, false };
+
+    // 予測した軌道の描画（全区間を1つの線として描く）
+    UPROPERTY(VisibleAnywhere, Category = "Wire")
+    ULineBatchComponent* TrajectoryLine;
+
+    /* ネットワーク */
+
+    // 次の PerformMove で反映する入力（EVRPawnMoveFlags）
+    uint8 PendingMoveFlags = 0;
+    FVector2D PendingMoveInput = FVector2D::ZeroVector;
+
+    // サーバーに承認されていない入力（クライアント）
+    TArray<FVRPawnMove> SavedMoves;
+
+    // このフレームと前フレームに送る入力（クライアント）
+    TArray<FVRPawnMove> FrameMoves;
+    TArray<FVRPawnMove> PreviousFrameMoves;
+
+    // 送信しなくてもこのフレームの入力を FrameMoves に残す（ベンチマークで送信量を数える用）
+    bool bCaptureFrameMoves = false;
+
+    // 最後に実行した入力のタイムスタンプ（サーバー）
+    float LastServerMoveTimeStamp = 0.0f;
+
+    // 次の複製の時に承認を返す入力のタイムスタンプ（サーバー。0 なら送らない）
+    float PendingAckTimeStamp = 0.0f;
+
+    // クライアントのワイヤー演算の端数時間をサーバーで積算したもの（サーバー）
+    double ServerSolverTime = 0.0;
+
+    // クライアントの固定タイムステップの回数が端数時間から1回分以上ずれていた（サーバー。補正を送ったら戻す）
+    bool bServerSubstepsRejected = false;
+
+    // 実行した入力と補正を返した数（サーバー）
+    uint32 NumServerMoves = 0;
+    uint32 NumServerCorrections = 0;
+
+    // 最後に承認・補正を受けた入力のタイムスタンプ（クライアント）
+    float ClientAckedTimeStamp = 0.0f;
+
+    // 補正で生じた視点のずれ（クライアント）
+    FVector CorrectionOffset = FVector::ZeroVector;
+
+    // 補正後の入力を再生中か（効果音などを鳴らさない）
+    bool bReplayingMoves = false;
+
+    // サーバーで確定した状態（他プレイヤーの表示用）
+    UPROPERTY(ReplicatedUsing = OnRep_NetState)
+    FVRPawnNetState NetState;
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0.01"))
+    float MaxMoveDeltaTime = 0.125f; // サーバーで実行する1入力あたりの時間の上限
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0"))
+    float MaxLocationError = 3.0f; // これ以上位置がずれたら補正する (cm)
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "1"))
+    int32 MaxSavedMoves = 96; // 保存しておく未承認の入力の上限
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0"))
+    float CorrectionSmoothTime = 0.1f; // 補正による視点のずれを戻す時定数（秒）
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0"))
+    float MaxSmoothDistance = 200.0f; // これ以上の補正は視点も即座に合わせる (cm)
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0"))
+    float ProxySmoothTime = 0.1f; // 他プレイヤーの表示位置を近づける時定数（秒）
+
+    UPROPERTY(EditAnywhere, Category = "Network", meta = (ClampMin = "0"))
+    float ProxyMaxExtrapolation = 0.15f; // 他プレイヤーの位置を速度から先読みする時間の上限（秒）
+
+    // 他プレイヤーの状態を受け取った時刻
+    double NetStateReceiveTime = 0.0;
+
+    /* ゴースト */
+
+    // 記録中のゴースト（記録していなければ null）
+    TUniquePtr<FWireGhostRecorder> GhostRecorder;
+
+    UPROPERTY(EditAnywhere, Category = "Ghost", meta = (ClampMin = "1", ClampMax = "90"))
+    float GhostSampleRate = 30.0f; // ゴーストを記録する頻度 (Hz)
+
+    // 記録中の入力（記録していなければ null）と保存先
+    TUniquePtr<FWireInputRecording> InputRecording;
+    FString InputRecordingPath;
+
     UPROPERTY(EditAnywhere, Category = "Sound Effect")
     UAudioComponent* WireAttachAudio; // ワイヤー接続時のオーディオ
 
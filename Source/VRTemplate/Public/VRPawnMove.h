@@ -0,0 +1,145 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "VRPawnMove.generated.h"
+
+// 1フレーム分の入力の種類
+enum class EVRPawnMoveFlags : uint8
+{
+    None = 0,
+    // ワイヤーを接続しておきたいか（押した瞬間ではなく状態で送り、入力が欠落しても次の入力で揃う）
+    WantsWire_L = 1 << 0,
+    WantsWire_R = 1 << 1,
+    RetractWire_L = 1 << 2,
+    RetractWire_R = 1 << 3,
+    Jump = 1 << 4,
+    Move = 1 << 5,
+
+    // 移動後にワイヤーが接続されていたか（サーバーとの状態比較用）
+    Attached_L = 1 << 6,
+    Attached_R = 1 << 7,
+};
+ENUM_CLASS_FLAGS(EVRPawnMoveFlags);
+
+// 左右の手のフラグを取得
+inline EVRPawnMoveFlags VRPawnWantsWireFlag(int32 Index) { return Index == 0 ? EVRPawnMoveFlags::WantsWire_L : EVRPawnMoveFlags::WantsWire_R; }
+inline EVRPawnMoveFlags VRPawnRetractWireFlag(int32 Index) { return Index == 0 ? EVRPawnMoveFlags::RetractWire_L : EVRPawnMoveFlags::RetractWire_R; }
+inline EVRPawnMoveFlags VRPawnAttachedFlag(int32 Index) { return Index == 0 ? EVRPawnMoveFlags::Attached_L : EVRPawnMoveFlags::Attached_R; }
+
+/**
+ * VRPawn の1フレーム分の入力とコントローラーの姿勢
+ * クライアントは送信後も保存しておき、サーバーから補正が来たら未承認の分を再生する
+ */
+USTRUCT()
+struct FVRPawnMove
+{
+    GENERATED_BODY()
+
+    // クライアントのワールド時刻
+    UPROPERTY()
+    float TimeStamp = 0.0f;
+
+    UPROPERTY()
+    float DeltaTime = 0.0f;
+
+    // EVRPawnMoveFlags
+    UPROPERTY()
+    uint8 Flags = 0;
+
+    // この入力で進めたワイヤーの固定タイムステップの回数（サーバー・再生時も端数時間に関わらず同じ回数進める）
+    UPROPERTY()
+    uint8 NumSubsteps = 0;
+
+    // この入力の衝突付き移動で使えるスイープの回数（クライアントのフレーム全体の上限から割り当てた分）
+    UPROPERTY()
+    uint8 MaxSweeps = 1;
+
+    // 開発用の移動入力
+    UPROPERTY()
+    FVector2D MoveInput = FVector2D::ZeroVector;
+
+    // コントローラーの Pawn からの相対姿勢（左/右）
+    UPROPERTY()
+    FVector_NetQuantize100 HandLocation[2] = { FVector::ZeroVector, FVector::ZeroVector };
+    UPROPERTY()
+    FRotator HandRotation[2] = { FRotator::ZeroRotator, FRotator::ZeroRotator };
+
+    // クライアントで移動した結果の位置
+    UPROPERTY()
+    FVector_NetQuantize100 ResultLocation = FVector::ZeroVector;
+
+    bool HasFlag(EVRPawnMoveFlags Flag) const { return EnumHasAnyFlags((EVRPawnMoveFlags)Flags, Flag); }
+    void AddFlag(EVRPawnMoveFlags Flag) { Flags |= (uint8)Flag; }
+};
+
+// ワイヤー1本分の複製用の状態
+USTRUCT()
+struct FVRPawnTetherState
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    bool bAttached = false;
+
+    UPROPERTY()
+    FVector_NetQuantize10 Anchor = FVector::ZeroVector;
+
+    UPROPERTY()
+    float CurrentLength = 0.0f;
+
+    UPROPERTY()
+    float AttachLength = 0.0f;
+
+    // 巻き付き点（アンカー側から順）
+    UPROPERTY()
+    TArray<FVector_NetQuantize10> WrapLocations;
+    UPROPERTY()
+    TArray<FVector_NetQuantizeNormal> WrapBendAxes;
+};
+
+/**
+ * サーバーで確定した VRPawn の状態（補正と他プレイヤーの表示に使う）
+ * NetSerialize でアンカー・巻き付き点を Pawn の位置からの相対座標、長さを 16bit に量子化して詰める
+ */
+USTRUCT()
+struct VRTEMPLATE_API FVRPawnNetState
+{
+    GENERATED_BODY()
+
+    // この状態になった時点の入力のタイムスタンプ
+    UPROPERTY()
+    float TimeStamp = 0.0f;
+
+    UPROPERTY()
+    FVector_NetQuantize100 Location = FVector::ZeroVector;
+
+    UPROPERTY()
+    FVector_NetQuantize10 Velocity = FVector::ZeroVector;
+
+    UPROPERTY()
+    FVRPawnTetherState Tethers[2];
+
+    // コントローラーの Pawn からの相対姿勢（左/右）
+    UPROPERTY()
+    FVector_NetQuantize100 HandLocation[2] = { FVector::ZeroVector, FVector::ZeroVector };
+    UPROPERTY()
+    FRotator HandRotation[2] = { FRotator::ZeroRotator, FRotator::ZeroRotator };
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+    // 量子化後の値で比較する（TimeStamp は補正用なので比較しない。変化がなければ他プレイヤーへ再送しない）
+    bool operator==(const FVRPawnNetState& Other) const;
+    bool operator!=(const FVRPawnNetState& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRPawnNetState> : public TStructOpsTypeTraitsBase2<FVRPawnNetState>
+{
+    enum
+    {
+        WithNetSerializer = true,
+        WithNetSharedSerialization = true,
+        WithIdenticalViaEquality = true,
+    };
+};
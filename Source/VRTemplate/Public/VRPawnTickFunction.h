@@ -0,0 +1,51 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "VRPawnTickFunction.generated.h"
+
+class AVRPawn;
+
+/**
+ * VRPawn の見た目の更新（ワイヤーの描画・風切り音・腕の向き・軌道予測）
+ * 移動の Tick より後のグループで、設定した頻度で実行する（コンポーネントを操作するのでゲームスレッドのみ）
+ */
+USTRUCT()
+struct FVRPawnCosmeticTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    AVRPawn* Target = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+    virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRPawnCosmeticTickFunction> : public TStructOpsTypeTraitsBase2<FVRPawnCosmeticTickFunction>
+{
+    enum { WithCopy = false };
+};
+
+/**
+ * ワイヤーの見た目用ロープのシミュレーション
+ * 粒子の計算だけを行うのでワーカースレッドで実行できる（結果は FVRPawnCosmeticTickFunction で描画に反映）
+ */
+USTRUCT()
+struct FVRPawnRopeTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    AVRPawn* Target = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+    virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVRPawnRopeTickFunction> : public TStructOpsTypeTraitsBase2<FVRPawnRopeTickFunction>
+{
+    enum { WithCopy = false };
+};
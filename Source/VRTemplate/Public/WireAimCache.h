@@ -0,0 +1,73 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "WireAimCache.generated.h"
+
+class UPrimitiveComponent;
+
+// 照準キャッシュの再利用条件
+USTRUCT(BlueprintType)
+struct FWireAimCacheSettings
+{
+    GENERATED_BODY()
+
+    // キャッシュを使用するか
+    UPROPERTY(EditAnywhere, Category = "Aim Cache")
+    bool bEnabled = true;
+
+    // 再利用を許すレイの始点の移動量 (cm)
+    UPROPERTY(EditAnywhere, Category = "Aim Cache", meta = (ClampMin = "0"))
+    float PositionTolerance = 1.0f;
+
+    // 再利用を許すレイの向きの変化 (度)
+    UPROPERTY(EditAnywhere, Category = "Aim Cache", meta = (ClampMin = "0"))
+    float AngleTolerance = 0.5f;
+
+    // 結果を再利用できる最大時間 (秒)
+    UPROPERTY(EditAnywhere, Category = "Aim Cache", meta = (ClampMin = "0"))
+    float MaxAge = 0.25f;
+};
+
+/**
+ * 照準用レイの結果を姿勢とともに記憶し、姿勢の変化が小さい間は再利用する
+ */
+class VRTEMPLATE_API FWireAimCache
+{
+public:
+    // 現在の姿勢で記憶した結果を再利用できるか。できる場合は OutHit を設定して true を返す
+    bool TryGet(const FWireAimCacheSettings& Settings, const FVector& Origin, const FVector& Direction, double Time, bool& bOutHit);
+
+    // トレース結果を記憶する（Hit が nullptr ならレイは何にも当たらなかった）
+    void Store(const FVector& Origin, const FVector& Direction, double Time, const FHitResult* Hit);
+
+    // 記憶した結果を破棄
+    void Invalidate() { bValid = false; }
+
+    // 最後に記憶したトレース結果
+    bool HasHit() const { return bValid && bHit; }
+    const FHitResult& GetHit() const { return Hit; }
+
+    // 再利用できた回数とトレースが必要だった回数
+    uint32 GetHitCount() const { return HitCount; }
+    uint32 GetMissCount() const { return MissCount; }
+    void ResetCounters() { HitCount = 0; MissCount = 0; }
+
+private:
+    // 当たった対象が消えたり動いたりしていないか
+    bool IsHitStillValid() const;
+
+    bool bValid = false;
+    bool bHit = false;
+    FVector Origin = FVector::ZeroVector;
+    FVector Direction = FVector::ForwardVector;
+    double Time = 0.0;
+    FHitResult Hit;
+
+    // 当たった対象と記憶時の位置
+    TWeakObjectPtr<UPrimitiveComponent> HitComponent;
+    FVector HitComponentLocation = FVector::ZeroVector;
+
+    uint32 HitCount = 0;
+    uint32 MissCount = 0;
+};
@@ -0,0 +1,133 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "WireAnchorSubsystem.generated.h"
+
+class UPrimitiveComponent;
+class ULevel;
+
+/**
+ * ワイヤーを接続できる面（Static なコリジョン）だけを一様グリッドに登録し、
+ * 物理シーン全体を検索せずに照準レイやコーン内の最適なアンカーを求める
+ */
+UCLASS(Config = Game)
+class VRTEMPLATE_API UWireAnchorSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    // 索引を作り直す
+    void Rebuild();
+
+    // 索引が使える状態か
+    bool IsBuilt() const { return bBuilt; }
+
+    // レイに沿って最も手前のアンカーを求める
+    bool FindAnchorAlongRay(const FVector& Start, const FVector& Direction, float MaxDistance, FHitResult& OutHit);
+
+    // レイから HalfAngle 度以内のコーン内で、手から遮られずに見える中で最もレイに近い向きのアンカーを求める
+    bool FindAnchorInCone(const FVector& Start, const FVector& Direction, float MaxDistance, float HalfAngle, FHitResult& OutHit, const AActor* IgnoreActor = nullptr);
+
+    // レイ上を優先し、外れた場合は AimAssistAngle 度のコーンで補正する（IgnoreActor は遮蔽の判定で無視する）
+    bool FindAnchor(const FVector& Start, const FVector& Direction, float MaxDistance, float AimAssistAngle, FHitResult& OutHit, const AActor* IgnoreActor = nullptr);
+
+    int32 GetNumEntries() const { return Entries.Num(); }
+
+private:
+    struct FAnchorEntry
+    {
+        FBox Bounds;
+        TWeakObjectPtr<UPrimitiveComponent> Component;
+
+        // 登録元のレベル（ストリーミングで外れた時にそのレベルの分だけ取り除く）
+        TObjectKey<ULevel> Level;
+    };
+
+    // コーン内の候補（レイに近い向きの順に遮蔽を確かめる）
+    struct FConeCandidate
+    {
+        int32 EntryIndex;
+        float Cos;
+        FVector Target;
+    };
+
+    // セルに含まれる登録物の CellEntries 上の範囲
+    struct FCellRange
+    {
+        int32 Start = 0;
+        int32 Num = 0;
+    };
+
+    // 索引に登録するコンポーネントか
+    bool IsGrappable(const UPrimitiveComponent* Component) const;
+
+    // アクターの登録するコンポーネントを Entries に加える
+    void AddActorEntries(AActor* Actor);
+
+    // Entries からセルの一覧を作り直す
+    void BuildCells();
+
+    FIntVector ToCell(const FVector& Location) const;
+
+    // 未検査の登録物なら検査済みにして true を返す
+    bool MarkVisited(int32 EntryIndex);
+
+    // 登録物のコンポーネントに対して正確なトレースを行う
+    bool TraceEntry(int32 EntryIndex, const FVector& Start, const FVector& End, FHitResult& OutHit) const;
+
+    void OnLevelAdded(ULevel* Level, UWorld* InWorld);
+    void OnLevelRemoved(ULevel* Level, UWorld* InWorld);
+
+    // 1セルの一辺 (cm)
+    UPROPERTY(Config)
+    float CellSize = 1000.0f;
+
+    // これより小さい（バウンディングボックスの半径が小さい）ものは小物として登録しない
+    UPROPERTY(Config)
+    float MinSurfaceExtent = 50.0f;
+
+    // これより多くのセルにまたがるものは常に検査する一覧に入れる
+    UPROPERTY(Config)
+    int32 MaxCellsPerEntry = 512;
+
+    // true ならタグ付きのものだけを登録する
+    UPROPERTY(Config)
+    bool bRequireGrappableTag = false;
+
+    // アクターかコンポーネントにこのタグがあれば登録する（インスタンスメッシュはタグ必須）
+    UPROPERTY(Config)
+    FName GrappableTag = TEXT("Grappable");
+
+    // アクターかコンポーネントにこのタグがあれば登録しない
+    UPROPERTY(Config)
+    FName NoGrappleTag = TEXT("NoGrapple");
+
+    // コーン内で遮蔽を確かめる候補の数の上限
+    UPROPERTY(Config)
+    int32 MaxConeCandidates = 4;
+
+    bool bBuilt = false;
+
+    // レベルの増減で Entries が変わり、次の検索の前にセルの一覧を作り直す
+    bool bCellsDirty = false;
+
+    TArray<FAnchorEntry> Entries;
+    TMap<FIntVector, FCellRange> Cells;
+    TArray<int32> CellEntries;
+    TArray<int32> LargeEntries;
+    TArray<FConeCandidate> ConeCandidates;
+
+    // 1回の検索内で同じ登録物を重複して検査しないための印
+    TArray<uint32> VisitStamps;
+    uint32 CurrentStamp = 0;
+
+    FDelegateHandle LevelAddedHandle;
+    FDelegateHandle LevelRemovedHandle;
+};
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/SimCallbackInput.h"
+#include "WireSolver.h"
+
+namespace Chaos
+{
+    class FSingleParticlePhysicsProxy;
+}
+
+// 入力による速度の変化と通し番号
+struct FWireAsyncVelocityChange
+{
+    uint32 Sequence = 0;
+    FVector Change = FVector::ZeroVector;
+};
+
+// ゲームスレッドから物理スレッドへ送るワイヤーの状態と入力
+struct FWireAsyncInput : public Chaos::FSimCallbackInput
+{
+    // 引き寄せる物理ボディ
+    Chaos::FSingleParticlePhysicsProxy* Proxy = nullptr;
+
+    FWireSolverSettings Settings;
+
+    // ワイヤーの状態（巻き取り・接続・切断・巻き付きはゲームスレッドで反映済み）
+    FWireTether Tethers[FWireSolver::MaxTethers];
+
+    // ボディの位置から各ワイヤーの根元（コントローラー）までのずれ
+    FVector OriginOffsets[FWireSolver::MaxTethers];
+
+    // ジャンプなどの入力による速度の変化（物理スレッドが加えたと返すまで毎回送り、同じ番号は1回だけ加える）
+    TArray<FWireAsyncVelocityChange, TInlineAllocator<4>> VelocityChanges;
+
+    void Reset()
+    {
+        Proxy = nullptr;
+        VelocityChanges.Reset();
+    }
+};
+
+// 物理スレッドからゲームスレッドへ返す結果
+struct FWireAsyncOutput : public Chaos::FSimCallbackOutput
+{
+    // 最後のサブステップでの引き寄せ加速度
+    FVector PullAcceleration = FVector::ZeroVector;
+
+    // 実行したサブステップ数
+    int32 NumSubsteps = 0;
+
+    // 加え終えた速度の変化の最後の通し番号
+    uint32 AppliedVelocityChangeSequence = 0;
+
+    void Reset()
+    {
+        PullAcceleration = FVector::ZeroVector;
+        NumSubsteps = 0;
+        AppliedVelocityChangeSequence = 0;
+    }
+};
+
+/**
+ * ワイヤーの引き寄せと速度の制限を Chaos の物理スレッドで物理ステップごとに演算する
+ * 非同期物理 (Tick Physics Async) なら物理の固定周期で進むので、ゲームスレッドのヒッチがスイングに影響しない
+ */
+class FWireAsyncCallback : public Chaos::TSimCallbackObject<FWireAsyncInput, FWireAsyncOutput, Chaos::ESimCallbackOptions::Presimulate>
+{
+private:
+    virtual void OnPreSimulate_Internal() override;
+
+    // 物理スレッドだけが触るソルバー
+    FWireSolver Solver;
+
+    // 最後に加えた速度の変化
+    uint32 LastVelocityChangeSequence = 0;
+};
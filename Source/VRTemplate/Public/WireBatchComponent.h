@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "DynamicMeshBuilder.h"
+#include "WireBatchComponent.generated.h"
+
+/**
+ * ワールド内のワイヤー（接続中・照準用）を1組の頂点・インデックスバッファに持ち、1回の描画でまとめて描く
+ * 各ワイヤーの形と状態はフレーム中に Set～ で受け取り、FlushWires で変化したワイヤーの分だけバッファを書き換える
+ *
+ * マテリアルには USplineMeshComponent の Custom Primitive Data の代わりに頂点の UV で値を渡す
+ *   UV0 : ワイヤーに沿った位置 (0～1) と周方向 (0～1)
+ *   UV1 : X に状態（0 接続中 / 1 接続可能 / 2 接続不可）
+ *   UV2, UV3 : 銃の位置 (X, Y), (Z, 0)
+ */
+UCLASS(ClassGroup = Rendering)
+class VRTEMPLATE_API UWireBatchComponent : public UMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    UWireBatchComponent();
+
+    // 描画するワイヤーを確保・解放（確保した時点では非表示）
+    int32 AddWire();
+    void RemoveWire(int32 Handle);
+
+    // ワイヤーの形（エルミート曲線、接線が 0 なら直線）
+    void SetWireCurve(int32 Handle, const FVector& Start, const FVector& StartTangent, const FVector& End, const FVector& EndTangent);
+
+    // マテリアルに渡す状態と銃の位置
+    void SetWireState(int32 Handle, float State);
+    void SetWireOrigin(int32 Handle, const FVector& Origin);
+
+    void SetWireVisible(int32 Handle, bool bVisible);
+
+    // 変化があれば頂点を作り直して描画スレッドへ1回で送る（1フレームの最後に呼ぶ）
+    void FlushWires();
+
+    // 表示中のワイヤーの数
+    int32 GetNumVisibleWires() const;
+
+    //~ UPrimitiveComponent
+    virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+    virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+    virtual int32 GetNumMaterials() const override { return 1; }
+
+    // ワイヤーの半径 (cm)
+    UPROPERTY(EditAnywhere, Category = "Wire Batch", meta = (ClampMin = "0.01"))
+    float WireRadius = 0.25f;
+
+    // 断面の頂点数
+    UPROPERTY(EditAnywhere, Category = "Wire Batch", meta = (ClampMin = "3", ClampMax = "16"))
+    int32 NumSides = 4;
+
+    // 曲がったワイヤーの分割数（直線は1区間）
+    UPROPERTY(EditAnywhere, Category = "Wire Batch", meta = (ClampMin = "1", ClampMax = "32"))
+    int32 NumCurveSegments = 8;
+
+    // これより小さい位置の変化では描画スレッドへ送り直さない (cm)
+    UPROPERTY(EditAnywhere, Category = "Wire Batch", meta = (ClampMin = "0"))
+    float UpdateTolerance = 0.05f;
+
+private:
+    struct FWireInstance
+    {
+        FVector Start = FVector::ZeroVector;
+        FVector StartTangent = FVector::ZeroVector;
+        FVector End = FVector::ZeroVector;
+        FVector EndTangent = FVector::ZeroVector;
+        FVector Origin = FVector::ZeroVector;
+        float State = 0.0f;
+        bool bVisible = false;
+        bool bInUse = false;
+
+        // 前回送ってから形・状態・表示が変わったか
+        bool bDirty = false;
+    };
+
+    // 1本分の頂点とインデックス（インデックスはこのワイヤーの先頭を 0 とする）を作る
+    void BuildWire(const FWireInstance& Wire, TArray<FDynamicMeshVertex>& OutVertices, TArray<uint32>& OutIndices) const;
+
+    // ワイヤーに変化があったことを記録
+    void MarkDirty(FWireInstance& Wire);
+
+    TArray<FWireInstance> Wires;
+    TArray<int32> FreeWires;
+
+    // 前回送ってから変化したワイヤーがあるか
+    bool bRenderDataDirty = false;
+};
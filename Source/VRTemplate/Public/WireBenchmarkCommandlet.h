@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WireBenchmarkCommandlet.generated.h"
+
+class AVRPawn;
+
+/**
+ * VRPawn の Tick 負荷を HMD・GPU なしで計測するベンチマーク
+ * 例: UnrealEditor-Cmd VRTemplate.uproject -run=WireBenchmark -nullrhi -unattended
+ *         -Map=/Game/S_Level/Course_City -Ticks=5000 -FrameRate=90 -MaxTickP99=300
+ *
+ * -Map        : 計測に使うマップ（省略時は床と天井だけの空のワールド）
+ * -PawnClass  : 生成するポーンのクラス（省略時は AVRPawn）
+ * -Ticks      : 計測する Tick 数
+ * -Warmup     : 計測前に捨てる Tick 数
+ * -FrameRate  : 1 Tick あたりの時間 (Hz)
+ * -MaxTickP99 : Tick の p99 (us) がこの値を超えたら失敗を返す（0 で判定なし）
+ * -SolverOnly : FWireSolver 単体のみを計測する
+ *   -SimulationRate    : ワイヤー演算の周波数 (Hz)。下げても速度が発散しないかを確かめる
+ *   -PenaltyTether     : XPBD ではなく従来の引き寄せ係数の方式で演算する
+ * -Bandwidth  : 他プレイヤーへ複製する FVRPawnNetState と ServerMove・ClientAckGoodMove の帯域を計測する
+ *                （中身と RPC の見出しの目安まで。パケット・UDP/IP のヘッダーは含まない）
+ *   -NetRate           : 複製の頻度 (Hz)
+ *   -Players           : ロビーの人数（1クライアントが受け取る量を Players - 1 人分として見積もる）
+ *   -MaxBytesPerClient : 1クライアントの受信量（NetState と承認, bytes/s）がこの値を超えたら失敗を返す（0 で判定なし）
+ * -Replay     : Wire.RecordInput で記録した入力を記録時と同じフレーム時間で再生して計測する（名前またはパス）
+ *   -MaxDivergence     : 記録時の位置との差 (cm) がこの値を超えたら失敗を返す（0 で判定なし）
+ */
+UCLASS()
+class VRTEMPLATE_API UWireBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UWireBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    // ポーンを生成して Tick ごとの処理時間を計測
+    int32 RunPawnBenchmark(const FString& Params);
+
+    // FWireSolver 単体の Step の処理時間を計測
+    int32 RunSolverBenchmark(const FString& Params);
+
+    // ポーンを動かしながら複製される状態と入力の RPC のビット数を計測
+    int32 RunBandwidthBenchmark(const FString& Params);
+
+    // 記録した入力を再生して Tick ごとの処理時間と記録時との位置の差を計測
+    int32 RunReplayBenchmark(const FString& Params, const FString& ReplayName);
+
+    // ポーンを生成（失敗したら nullptr）
+    AVRPawn* SpawnBenchmarkPawn(UWorld* World, const FString& PawnClassPath);
+
+    // ベンチマーク用のワールドを作成（マップ指定がなければ床と天井だけ配置する）
+    UWorld* CreateBenchmarkWorld(const FString& MapName);
+    void DestroyBenchmarkWorld(UWorld* World);
+
+    // Tick 番号に応じたコントローラーの姿勢とワイヤー操作を与える
+    void ApplyScriptedInput(AVRPawn* Pawn, int32 TickIndex, float DeltaTime);
+};
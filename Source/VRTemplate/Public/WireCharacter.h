@@ -7,10 +7,16 @@
 #include "Components/SplineMeshComponent.h"
 #include "Components/Image.h"
 #include "Components/AudioComponent.h"
+#include "WorldCollision.h"
+#include "WireAimCache.h"
+#include "WireNetSerialization.h"
 #include "WireCharacter.generated.h"
 
 class USpringArmComponent;
 class UCameraComponent;
+class UWireAnchorSubsystem;
+class UWireCharacterMovementComponent;
+class UWireTetherComponent;
 class UInputMappingContext;
 class UInputAction;
 struct FInputActionValue;
@@ -56,12 +62,14 @@ class VRTEMPLATE_API AWireCharacter : public ACharacter
 
 
 public:
-    AWireCharacter();
+    AWireCharacter(const FObjectInitializer& ObjectInitializer);
 
     // ウィジェットのインスタンスを格納
     UFUNCTION(BlueprintCallable)
     void SetCrosshairWidget(UImage* CrosshairImage);
 
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 protected:
     /** Called for movement input */
     void Move(const FInputActionValue& Value);
@@ -74,11 +82,27 @@ protected:
     virtual void Tick(float deltaTime) override;
     virtual void SetupPlayerInputComponent(UInputComponent* PlayerInputComponent) override;
 
-    // ワイヤー接続の可否をチェック
-    bool CheckConnectable();
+    // ワイヤー接続の可否をチェック（bAllowAsync 時は前フレームに発行した非同期トレースの結果を返す）
+    bool CheckConnectable(bool bAllowAsync = false);
+
+    // ワイヤーの描画を更新（移動は UWireCharacterMovementComponent で行う）
+    void UpdateWireVisual();
+
+    // ワイヤー機動用の CharacterMovement を取得
+    UWireCharacterMovementComponent* GetWireMovement() const;
+
+    // ワイヤーが接続されているか（他プレイヤーのキャラクターは複製された状態で判定）
+    bool IsWireAttached() const;
+
+    // 他プレイヤーのワイヤーの表示を切り替える
+    UFUNCTION()
+    void OnRep_WireState(const FWireNetState& OldState);
+
+    // 照準用レイでワイヤーの接続先を探す
+    bool TraceAim(const FVector& Start, const FVector& Forward, FHitResult& OutHit);
 
-    // ワイヤー機動の更新
-    void UpdateWireMovement(float deltaTime);
+    // 接続先の索引を取得（使用しない設定なら nullptr）
+    UWireAnchorSubsystem* GetAnchorIndex() const;
 
     // アンカーのワールド座標を取得
     FVector GetAnchorLocation() const;
@@ -96,19 +120,28 @@ protected:
 
     // ワイヤーを巻き取る
     void RetractWire();
+    void StopRetractWire();
 
     // ワイヤーを伸ばす
     void ExtendWire();
+    void StopExtendWire();
 
 
 private:
-    bool bIsWireAttached = false; // ワイヤーが接続されているか
-    float CurrentWireLength = 0; // 現在のワイヤーの長さ
     AActor* AttachedActor; // 接続先のアクター（Movable の場合のみセット）
     UPrimitiveComponent* AttachedComponent; // 接続先のコンポーネント（Movable の場合のみセット）
     FVector StaticAnchorLocation; // Static なオブジェクトに接続した場合の固定座標
     UImage* CrosshairImage; // 生成したウィジェットのインスタンス
     bool bIsPrevConnectable; // 前フレームでワイヤーが接続可能だったか
+    bool bAsyncConnectable = false; // 最後に得られたトレース結果
+    FTraceHandle AimTraceHandle; // 発行済みの照準用非同期トレース
+    FWireAimCache AimCache; // 照準用レイの結果のキャッシュ
+
+    UPROPERTY(ReplicatedUsing = OnRep_WireState)
+    FWireNetState WireState; // 他プレイヤーに送るワイヤーの状態（[0] のみ使用）
+
+    UPROPERTY(VisibleAnywhere, Category = "Wire")
+    UWireTetherComponent* WireTether; // ワイヤーの状態と演算（移動は UWireCharacterMovementComponent で行う）
 
     UPROPERTY(VisibleAnywhere, Category = "Wire")
     USceneComponent* AnchorComponent; // アンカーとして機能する SceneComponent（Movable 用）
@@ -128,6 +161,30 @@ private:
     UPROPERTY(EditAnywhere, Category = "Wire Settings")
     float ExtendSpeed = 3000.0f; // ワイヤー伸ばし速度
 
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    float WirePullStrength = 1000.0f; // ワイヤーの引き寄せ係数（bUseXPBDTether が false の時のみ使用）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseXPBDTether = true; // ワイヤーを XPBD の距離拘束として解く（演算周波数を 30Hz まで下げても発散しない）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "0", EditCondition = "bUseXPBDTether"))
+    float WireCompliance = 1.0f / 1000.0f; // ワイヤーの柔らかさ（0 で伸びない。1 / 引き寄せ係数 で従来と同じ強さ）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseAsyncAimTrace = true; // 照準判定を非同期トレースで行う（結果は1フレーム遅れて反映）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    FWireAimCacheSettings AimCacheSettings; // 照準結果を再利用する条件
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings")
+    bool bUseAnchorIndex = false; // 物理シーンではなく接続先の索引で照準判定を行う（Static な面のみ対象）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "0", ClampMax = "30", EditCondition = "bUseAnchorIndex"))
+    float AimAssistAngle = 3.0f; // 照準アシストの角度（度）
+
+    UPROPERTY(EditAnywhere, Category = "Wire Settings", meta = (ClampMin = "30"))
+    float SimulationRate = 360.0f; // ワイヤー演算の固定周波数 (Hz)
+
     UPROPERTY(EditAnywhere, Category = "Sound Effect")
     UAudioComponent* WireAttachAudio; // ワイヤー接続時のオーディオ
 
@@ -0,0 +1,209 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "WireTetherComponent.h"
+#include "WireCharacterMovementComponent.generated.h"
+
+// MOVE_Custom のサブモード
+enum EWireCustomMovementMode : uint8
+{
+    // ワイヤーにぶら下がって移動
+    CMOVE_Swinging = 0,
+};
+
+/**
+ * ワイヤーの入力を保存する移動
+ * 巻き取り・伸ばし・接続したいかは圧縮フラグ、接続を始める時のアンカーは FWireCharacterNetworkMoveData で送る
+ * ワイヤーの長さはサーバーが巻き取り・伸ばしの入力から自分で決めるので送らない
+ */
+class VRTEMPLATE_API FWireSavedMove : public FSavedMove_Character
+{
+public:
+    typedef FSavedMove_Character Super;
+
+    // 圧縮フラグの割り当て
+    static constexpr uint8 FLAG_WantsToRetract = FLAG_Custom_0;
+    static constexpr uint8 FLAG_WantsToExtend = FLAG_Custom_1;
+    static constexpr uint8 FLAG_WireAttached = FLAG_Custom_2;
+
+    virtual void Clear() override;
+    virtual uint8 GetCompressedFlags() const override;
+    virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+    virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+    virtual void PrepMoveFor(ACharacter* C) override;
+
+    uint8 bSavedWantsToRetract : 1;
+    uint8 bSavedWantsToExtend : 1;
+    uint8 bSavedWireAttached : 1;
+
+    // 移動開始時のアンカー
+    FVector SavedWireAnchor = FVector::ZeroVector;
+};
+
+class VRTEMPLATE_API FWireNetworkPredictionData_Client : public FNetworkPredictionData_Client_Character
+{
+public:
+    typedef FNetworkPredictionData_Client_Character Super;
+
+    explicit FWireNetworkPredictionData_Client(const UCharacterMovementComponent& ClientMovement);
+
+    virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+// ServerMove で送るアンカー（接続中のみ書き込む。サーバーは接続を始める時に自分のトレースで確かめてから使う）
+struct VRTEMPLATE_API FWireCharacterNetworkMoveData : public FCharacterNetworkMoveData
+{
+    typedef FCharacterNetworkMoveData Super;
+
+    virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+    virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+
+    FVector_NetQuantize10 WireAnchor = FVector::ZeroVector;
+};
+
+struct VRTEMPLATE_API FWireCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+    FWireCharacterNetworkMoveDataContainer();
+
+    FWireCharacterNetworkMoveData WireMoveData[3];
+};
+
+// 補正に載せるサーバーのワイヤーの状態（クライアントはこの状態から未承認の移動を再生し直す）
+struct VRTEMPLATE_API FWireCharacterMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+    typedef FCharacterMoveResponseDataContainer Super;
+
+    virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+    virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+    bool bWireAttached = false;
+    float WireLength = 0.0f;
+    FVector_NetQuantize10 WireAnchor = FVector::ZeroVector;
+};
+
+/**
+ * ワイヤー機動を CharacterMovement のサブステップ・保存された移動・ネットワーク補正の中で行う
+ * 接続中で空中にいる間は MOVE_Custom (CMOVE_Swinging) になり、PhysCustom で移動する
+ * ワイヤーの状態はオーナーの UWireTetherComponent（bAutoMove を false にしたもの）のソルバーに持つ
+ * サーバーはクライアントから接続の有無と巻き取り・伸ばしの意図だけを受け取り、アンカーの確認と長さの計算は自分で行う
+ */
+UCLASS()
+class VRTEMPLATE_API UWireCharacterMovementComponent : public UCharacterMovementComponent
+{
+    GENERATED_BODY()
+
+public:
+    UWireCharacterMovementComponent();
+
+    virtual void OnRegister() override;
+    virtual void BeginPlay() override;
+    virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+    virtual FString GetMovementName() const override;
+
+    // ワイヤーを接続（InAnchorComponent があればその位置をアンカーとして追従する）
+    void AttachWire(const FVector& Anchor, USceneComponent* InAnchorComponent);
+
+    // ワイヤーを切断
+    void DetachWire();
+
+    bool IsWireAttached() const { return GetWireSolver().GetTether(0).bAttached; }
+    float GetWireLength() const { return GetWireSolver().GetTether(0).CurrentLength; }
+    const FVector& GetWireAnchor() const { return GetWireSolver().GetTether(0).Anchor; }
+    // ワイヤーのソルバー（UWireTetherComponent が無ければ接続していない空のソルバー）
+    const FWireSolver& GetWireSolver() const;
+
+    // 巻き取り・伸ばしの入力（押している間 true）
+    void SetWantsToRetract(bool bWants) { bWantsToRetract = bWants; }
+    void SetWantsToExtend(bool bWants) { bWantsToExtend = bWants; }
+
+    // スイング中か
+    bool IsSwinging() const { return MovementMode == MOVE_Custom && CustomMovementMode == CMOVE_Swinging; }
+
+    // 引き寄せ係数・演算周波数をソルバーに反映
+    void ApplySolverSettings();
+
+    // サーバーから補正されたワイヤーの状態を反映
+    void SetWireState(bool bAttached, const FVector& Anchor, float Length);
+
+    // 接続したいかを反映（未接続から接続する時だけ Anchor を使う。bValidateAnchor ならサーバーのトレースで確かめた点に接続する）
+    void ApplyWireIntent(bool bWantsAttached, const FVector& Anchor, bool bValidateAnchor);
+
+    // 引き寄せ係数（ワイヤーの伸び 1cm あたりの加速度）
+    UPROPERTY(EditAnywhere, Category = "Wire Movement")
+    float WirePullStrength = 1000.0f;
+
+    // ワイヤーを XPBD の距離拘束として解く（false なら引き寄せ係数で引く）
+    UPROPERTY(EditAnywhere, Category = "Wire Movement")
+    bool bUseXPBDTether = true;
+
+    // XPBD のコンプライアンス（0 で伸びない）
+    UPROPERTY(EditAnywhere, Category = "Wire Movement", meta = (ClampMin = "0", EditCondition = "bUseXPBDTether"))
+    float WireCompliance = 1.0f / 1000.0f;
+
+    // ワイヤーの長さの範囲
+    UPROPERTY(EditAnywhere, Category = "Wire Movement")
+    float MinWireLength = 100.0f;
+    UPROPERTY(EditAnywhere, Category = "Wire Movement")
+    float MaxWireLength = 10000.0f;
+
+    // ワイヤー巻き取り・伸ばし速度
+    UPROPERTY(EditAnywhere, Category = "Wire Movement")
+    float RetractSpeed = 1500.0f;
+    UPROPERTY(EditAnywhere, Category = "Wire Movement")
+    float ExtendSpeed = 3000.0f;
+
+    // ワイヤー演算の周波数 (Hz)。CharacterMovement の1サブステップをこの周期以下に等分して演算する
+    UPROPERTY(EditAnywhere, Category = "Wire Movement", meta = (ClampMin = "30"))
+    float SimulationRate = 360.0f;
+
+    // 地上で引き寄せられた時にスイングを始める上向きの度合い（引く向きの Z 成分）
+    UPROPERTY(EditAnywhere, Category = "Wire Movement", meta = (ClampMin = "0", ClampMax = "1"))
+    float LiftOffDirectionZ = 0.707f;
+
+    // サーバーが受け付けるアンカーまでの距離の余裕 (cm)
+    UPROPERTY(EditAnywhere, Category = "Wire Movement", meta = (ClampMin = "0"))
+    float MaxAnchorDistanceError = 500.0f;
+
+    // クライアントのアンカーとサーバーのトレースが当たった点のずれの許容 (cm)
+    UPROPERTY(EditAnywhere, Category = "Wire Movement", meta = (ClampMin = "0"))
+    float MaxAnchorSurfaceError = 50.0f;
+
+protected:
+    virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+    virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+    virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+    virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+    virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+
+    // スイング中の移動
+    void PhysSwinging(float deltaTime, int32 Iterations);
+
+    // ワイヤーが張っていて、引く向きが十分に上向きか
+    bool IsPulledUpward() const;
+
+    // クライアントが送ったアンカーの先に実際に面があるか、自分の位置からトレースして確かめる
+    bool ValidateAnchor(const FVector& Anchor, FHitResult& OutHit) const;
+
+private:
+    friend class FWireSavedMove;
+
+    FWireSolver* GetMutableWireSolver() { return WireTether ? &WireTether->GetSolver() : nullptr; }
+
+    // ワイヤーの状態と速度の演算を持つコンポーネント（オーナーのものを使う。[0] のみ使用）
+    UPROPERTY(Transient)
+    UWireTetherComponent* WireTether = nullptr;
+
+    // Movable な接続先に追従するアンカー（AnchorOffset はそのローカル座標）
+    TWeakObjectPtr<USceneComponent> AnchorComponent;
+    FVector AnchorOffset = FVector::ZeroVector;
+
+    // ServerMove で送る移動データ
+    FWireCharacterNetworkMoveDataContainer WireMoveDataContainer;
+
+    // 補正で返すワイヤーの状態
+    FWireCharacterMoveResponseDataContainer WireMoveResponseDataContainer;
+
+    bool bWantsToRetract = false;
+    bool bWantsToExtend = false;
+};
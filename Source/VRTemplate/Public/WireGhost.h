@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WireGhostRecorder.h"
+#include "WireGhost.generated.h"
+
+class UStaticMeshComponent;
+class USplineMeshComponent;
+
+/**
+ * 記録したコースの走りを再生するゴースト
+ * 物理・衝突・トレースを使わず、読み込んだ軌跡を補間して頭・手・ワイヤーを動かすだけ
+ */
+UCLASS()
+class VRTEMPLATE_API AWireGhost : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AWireGhost();
+
+    // Saved/Ghosts/<Name>.wghost を読み込んだゴーストを生成（ファイルがなければ nullptr）
+    UFUNCTION(BlueprintCallable, Category = "Ghost", meta = (WorldContext = "WorldContextObject", DeterminesOutputType = "GhostClass"))
+    static AWireGhost* SpawnGhost(UObject* WorldContextObject, const FString& Name, TSubclassOf<AWireGhost> GhostClass);
+
+    // 軌跡を読み込んで先頭から再生
+    bool LoadGhost(const FString& FilePath);
+
+    // 先頭から再生し直す
+    UFUNCTION(BlueprintCallable, Category = "Ghost")
+    void Restart();
+
+    UFUNCTION(BlueprintPure, Category = "Ghost")
+    float GetDuration() const { return Track.GetDuration(); }
+
+    virtual void Tick(float DeltaSeconds) override;
+
+protected:
+    // 再生が終わったら先頭に戻る
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghost")
+    bool bLoop = false;
+
+    UPROPERTY(VisibleAnywhere, Category = "Ghost")
+    UStaticMeshComponent* Head;
+
+    // 手（左/右）
+    UPROPERTY(VisibleAnywhere, Category = "Ghost")
+    UStaticMeshComponent* Hand_L;
+    UPROPERTY(VisibleAnywhere, Category = "Ghost")
+    UStaticMeshComponent* Hand_R;
+
+    // ワイヤー（左/右）
+    UPROPERTY(VisibleAnywhere, Category = "Ghost")
+    USplineMeshComponent* Wire_L;
+    UPROPERTY(VisibleAnywhere, Category = "Ghost")
+    USplineMeshComponent* Wire_R;
+
+private:
+    // 当たり判定・影を持たない見た目だけの設定
+    static void SetupVisualOnly(UPrimitiveComponent* Component);
+
+    FWireGhostTrack Track;
+    float PlaybackTime = 0.0f;
+};
@@ -0,0 +1,146 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+
+// ゴーストの1サンプル（ワールド座標）
+struct FWireGhostSample
+{
+    // 記録開始からの時間 (秒)
+    float Time = 0.0f;
+
+    FVector PawnLocation = FVector::ZeroVector;
+
+    // 頭（カメラ）と手（左/右）
+    FVector HeadLocation = FVector::ZeroVector;
+    FRotator HeadRotation = FRotator::ZeroRotator;
+    FVector HandLocation[2] = { FVector::ZeroVector, FVector::ZeroVector };
+    FRotator HandRotation[2] = { FRotator::ZeroRotator, FRotator::ZeroRotator };
+
+    // 接続中のワイヤー（bit0 = 左, bit1 = 右）とアンカー
+    uint8 AttachedMask = 0;
+    FVector Anchor[2] = { FVector::ZeroVector, FVector::ZeroVector };
+
+    bool IsAttached(int32 Index) const { return (AttachedMask & (1 << Index)) != 0; }
+};
+
+/**
+ * ゴーストのサンプルを差分・量子化して詰める
+ * 位置は 1mm、角度は 16bit に量子化し、Pawn の位置は直前2サンプルからの予測との差、
+ * 頭と手は Pawn からの相対位置の前回との差を可変長整数で書く
+ */
+class VRTEMPLATE_API FWireGhostCodec
+{
+public:
+    static constexpr uint32 Magic = 0x31485747; // "GWH1"
+    static constexpr uint32 Version = 1;
+
+    // ファイルの先頭
+    static void SerializeHeader(FArchive& Ar, float& SampleRate);
+
+    // 1サンプル分を書く・読む（前回までの状態はこのインスタンスに保持する）
+    void Encode(FArchive& Ar, const FWireGhostSample& Sample);
+    bool Decode(FArchive& Ar, FWireGhostSample& OutSample);
+
+private:
+    // 量子化した状態
+    struct FState
+    {
+        int32 TimeMs = 0;
+        FIntVector Pawn = FIntVector::ZeroValue;
+        FIntVector Head = FIntVector::ZeroValue;
+        FIntVector HeadRotation = FIntVector::ZeroValue;
+        FIntVector Hand[2] = { FIntVector::ZeroValue, FIntVector::ZeroValue };
+        FIntVector HandRotation[2] = { FIntVector::ZeroValue, FIntVector::ZeroValue };
+        uint8 AttachedMask = 0;
+        FIntVector Anchor[2] = { FIntVector::ZeroValue, FIntVector::ZeroValue };
+    };
+
+    static FState Quantize(const FWireGhostSample& Sample);
+    static FWireGhostSample Dequantize(const FState& State);
+
+    // 前回・前々回の状態
+    FState Prev;
+    FState PrevPrev;
+    int32 NumCoded = 0;
+};
+
+/**
+ * ゴーストの記録
+ * ゲームスレッドは確保済みのリングバッファにサンプルを積むだけで、圧縮とファイル書き込みは専用スレッドで行う
+ */
+class VRTEMPLATE_API FWireGhostRecorder : public FRunnable
+{
+public:
+    // Capacity はリングバッファのサンプル数（書き込みが追いつかない間に溜められる量）
+    FWireGhostRecorder(const FString& InFilePath, float InSampleRate, uint32 Capacity = 1024);
+    virtual ~FWireGhostRecorder();
+
+    // ファイルを開いて書き込みスレッドを開始
+    bool Start();
+
+    // 残りを書き切ってファイルを閉じる
+    void Finish();
+
+    // 記録の間隔に達していればサンプルを積む（ゲームスレッド）
+    bool ShouldRecord(float DeltaTime);
+    void Record(const FWireGhostSample& Sample);
+
+    float GetElapsedTime() const { return ElapsedTime; }
+    uint32 GetNumDropped() const { return NumDropped; }
+
+    // 保存先 (Saved/Ghosts/<Name>.wghost)
+    static FString GetGhostFilePath(const FString& Name);
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    // リングバッファのサンプルを圧縮して書き込む（書き込みスレッド）
+    void Flush();
+
+    FString FilePath;
+    float SampleRate;
+
+    TCircularQueue<FWireGhostSample> Queue;
+    TUniquePtr<IFileHandle> FileHandle;
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStopping{ false };
+
+    FWireGhostCodec Codec;
+    TArray<uint8> EncodeBuffer;
+
+    // ゲームスレッド側の時間
+    float ElapsedTime = 0.0f;
+    float SampleTimer = 0.0f;
+    uint32 NumDropped = 0;
+};
+
+/**
+ * 読み込んだゴーストの軌跡
+ */
+class VRTEMPLATE_API FWireGhostTrack
+{
+public:
+    bool LoadFromFile(const FString& FilePath);
+
+    bool IsEmpty() const { return Samples.Num() == 0; }
+    float GetDuration() const { return Samples.Num() > 0 ? Samples.Last().Time : 0.0f; }
+
+    // Time の状態を前後のサンプルから補間（ワイヤーは直前のサンプルの状態）
+    void Evaluate(float Time, FWireGhostSample& OutSample) const;
+
+private:
+    TArray<FWireGhostSample> Samples;
+
+    // 前回の検索位置（再生は時間順なのでここから探す）
+    mutable int32 LastIndex = 0;
+};
@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "VRPawnMove.h"
+
+// 1フレーム分の入力とコントローラー・HMD の姿勢
+struct FWireInputFrame
+{
+    // 入力・コントローラーの相対姿勢・このフレームの DeltaTime と移動後の位置
+    FVRPawnMove Move;
+
+    // HMD（カメラ）の Pawn からの相対姿勢
+    FVector HeadLocation = FVector::ZeroVector;
+    FRotator HeadRotation = FRotator::ZeroRotator;
+};
+
+/**
+ * VRPawn の入力の記録（再生で同じ結果になるよう量子化せずに保存する）
+ * UWireBenchmarkCommandlet の -Replay で HMD なしに同じフレーム時間で再生できる
+ */
+class VRTEMPLATE_API FWireInputRecording
+{
+public:
+    static constexpr uint32 Magic = 0x31495257; // "WRI1"
+    static constexpr uint32 Version = 2;
+
+    // 記録したマップ
+    FString MapName;
+
+    // 記録開始時の Pawn の状態
+    FRotator StartRotation = FRotator::ZeroRotator;
+    FVRPawnNetState StartState;
+
+    TArray<FWireInputFrame> Frames;
+
+    bool SaveToFile(const FString& FilePath) const;
+    bool LoadFromFile(const FString& FilePath);
+
+    // Name がパスでなければ Saved/InputRecordings/<Name>.winput
+    static FString GetFilePath(const FString& Name);
+
+private:
+    void Serialize(FArchive& Ar);
+};
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "WireNetSerialization.generated.h"
+
+// ワイヤーの状態を複製する時の量子化
+namespace WireNetSerialization
+{
+    // ワイヤーの長さは 1cm 単位の 16bit（最大 655m）
+    constexpr uint32 MaxQuantizedLength = 0xFFFF;
+
+    // 位置は 0.1cm 単位、速度は 0.1cm/s 単位で可変ビット長に詰める（相対座標なら値が小さいほど短くなる）
+    constexpr uint32 LocationScale = 10;
+    constexpr float LocationTolerance = 1.0f / LocationScale;
+
+    VRTEMPLATE_API void SerializeLength(FArchive& Ar, float& Length);
+
+    // Origin からの相対位置として送る（受信側では Origin を先に復元しておく）
+    VRTEMPLATE_API bool SerializeRelativeLocation(FArchive& Ar, FVector& Location, const FVector& Origin);
+
+    // 1bit のフラグ
+    VRTEMPLATE_API void SerializeBit(FArchive& Ar, bool& bValue);
+
+    // 量子化した値が一致するか（変化がなければ再送しない判定に使う）
+    inline bool IsSameLength(float A, float B) { return FMath::RoundToInt32(A) == FMath::RoundToInt32(B); }
+}
+
+/**
+ * ワイヤー2本分（左/右）の接続の有無・アンカー・長さ
+ * 接続していないワイヤーは 1bit だけで、量子化後に変化がなければ複製されない
+ */
+USTRUCT()
+struct VRTEMPLATE_API FWireNetState
+{
+    GENERATED_BODY()
+
+    // 接続されているワイヤー（bit0 = 左, bit1 = 右）
+    UPROPERTY()
+    uint8 AttachedMask = 0;
+
+    // アンカーのワールド座標（接続中は動かないので相対座標にせず、再送を接続・切断時に抑える）
+    UPROPERTY()
+    FVector Anchor[2] = { FVector::ZeroVector, FVector::ZeroVector };
+
+    // 現在のワイヤーの長さ
+    UPROPERTY()
+    float Length[2] = { 0.0f, 0.0f };
+
+    bool IsAttached(int32 Index) const { return (AttachedMask & (1 << Index)) != 0; }
+
+    void SetTether(int32 Index, bool bAttached, const FVector& InAnchor, float InLength);
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+    bool operator==(const FWireNetState& Other) const;
+    bool operator!=(const FWireNetState& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FWireNetState> : public TStructOpsTypeTraitsBase2<FWireNetState>
+{
+    enum
+    {
+        WithNetSerializer = true,
+        WithNetSharedSerialization = true,
+        WithIdenticalViaEquality = true,
+    };
+};
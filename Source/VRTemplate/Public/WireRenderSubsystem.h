@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WireRenderSubsystem.generated.h"
+
+class UWireBatchComponent;
+class UMaterialInterface;
+
+/**
+ * ワールドに1つの UWireBatchComponent を持ち、全 Pawn のワイヤーを1回の描画でまとめて描く
+ * 各 Pawn がフレーム中に更新した形と状態は、ワールドの Tick の最後にまとめて描画スレッドへ送る
+ */
+UCLASS(Config = Game)
+class VRTEMPLATE_API UWireRenderSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // 描画コンポーネントを取得（初回に作成し、マテリアルが未設定なら DefaultMaterial を使う）
+    UWireBatchComponent* GetRenderer(UMaterialInterface* DefaultMaterial);
+
+private:
+    UPROPERTY(Transient)
+    UWireBatchComponent* Renderer;
+
+    // ワイヤーのマテリアル（未設定なら最初に登録した Pawn のワイヤーのマテリアル）
+    UPROPERTY(Config)
+    FSoftObjectPath WireMaterial;
+
+    // UWireBatchComponent の設定
+    UPROPERTY(Config)
+    float WireRadius = 0.25f;
+    UPROPERTY(Config)
+    int32 NumSides = 4;
+    UPROPERTY(Config)
+    int32 NumCurveSegments = 8;
+    UPROPERTY(Config)
+    float UpdateTolerance = 0.05f;
+};
@@ -0,0 +1,116 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "WireRope.generated.h"
+
+// ワイヤーの見た目用ロープの設定
+USTRUCT(BlueprintType)
+struct FWireRopeSettings
+{
+    GENERATED_BODY()
+
+    // 粒子数の下限
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "3", ClampMax = "32"))
+    int32 MinParticles = 4;
+
+    // 粒子数の上限（処理時間が予算を超えると自動で減らす）
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "3", ClampMax = "32"))
+    int32 MaxParticles = 24;
+
+    // 粒子間の目標距離 (cm)
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "10"))
+    float SegmentLength = 150.0f;
+
+    // 距離拘束の反復回数
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "1", ClampMax = "16"))
+    int32 Iterations = 4;
+
+    // ロープにかかる重力加速度
+    UPROPERTY(EditAnywhere, Category = "Rope")
+    float Gravity = 980.0f;
+
+    // 速度の減衰率（1ステップあたり）
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "0", ClampMax = "1"))
+    float Damping = 0.02f;
+
+    // 切断後にロープを巻き戻す速さ (cm/s)
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "0"))
+    float RecoilSpeed = 6000.0f;
+
+    // 1本あたり1フレームの処理時間の予算 (us)
+    UPROPERTY(EditAnywhere, Category = "Rope", meta = (ClampMin = "1"))
+    float BudgetMicroseconds = 50.0f;
+};
+
+/**
+ * ワイヤーを粒子列として扱うロープ（Verlet 積分 + 距離拘束）
+ * 座標は成分ごとの配列（SoA）で持ち、積分は 4 粒子ずつ SIMD で行う
+ */
+class VRTEMPLATE_API FWireRope
+{
+public:
+    // 粒子数の最大値（4 の倍数）
+    static constexpr int32 Capacity = 32;
+
+    void SetSettings(const FWireRopeSettings& InSettings);
+
+    // Start から End まで Length の長さのロープを張る
+    void Attach(const FVector& Start, const FVector& End, float Length);
+
+    // アンカー側を解放し、根元へ巻き戻す
+    void Release();
+
+    // 描画が必要か
+    bool IsActive() const { return NumParticles > 0; }
+
+    // アンカーに接続された状態か
+    bool IsAttached() const { return IsActive() && bAttached; }
+
+    // 切断後の巻き戻し中か
+    bool IsRecoiling() const { return IsActive() && !bAttached; }
+
+    // 根元を Start、接続中ならアンカーを End に固定してシミュレーションを進める
+    void Simulate(float DeltaTime, const FVector& Start, const FVector& End, float Length);
+
+    // ロープの形に近い1区間のエルミート曲線（SplineMesh の始点・終点と接線）を求める
+    void GetHermite(FVector& OutStart, FVector& OutStartTangent, FVector& OutEnd, FVector& OutEndTangent) const;
+
+    int32 GetNumParticles() const { return NumParticles; }
+
+    // 直近の Simulate の処理時間 (us)
+    double GetLastSimulateMicroseconds() const { return LastSimulateMicroseconds; }
+
+private:
+    // 粒子数を変更（形を保ったまま再配置）
+    void Resample(int32 NewNumParticles);
+
+    // Verlet 積分（SIMD）
+    void Integrate(float DeltaTime);
+
+    // 隣り合う粒子の距離拘束
+    void SolveConstraints(float RestLength);
+
+    void SetParticle(int32 Index, const FVector& Position);
+    FVector GetParticle(int32 Index) const { return FVector(X[Index], Y[Index], Z[Index]); }
+
+    // ロープ上の割合 Alpha (0～1) の位置
+    FVector GetPointAt(float Alpha) const;
+
+    FWireRopeSettings Settings;
+
+    alignas(16) float X[Capacity] = {};
+    alignas(16) float Y[Capacity] = {};
+    alignas(16) float Z[Capacity] = {};
+    alignas(16) float PrevX[Capacity] = {};
+    alignas(16) float PrevY[Capacity] = {};
+    alignas(16) float PrevZ[Capacity] = {};
+
+    int32 NumParticles = 0;
+
+    // 予算に応じて調整される粒子数の上限
+    int32 AdaptiveMaxParticles = Capacity;
+
+    bool bAttached = false;
+    float RopeLength = 0.0f;
+    double LastSimulateMicroseconds = 0.0;
+};
@@ -0,0 +1,96 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WireSignificanceSubsystem.generated.h"
+
+class AVRPawn;
+
+// 見た目の更新をどこまで行うか
+UENUM(BlueprintType)
+enum class EWireCosmeticSignificance : uint8
+{
+    // 毎フレームすべて更新
+    Full,
+    // 更新頻度を下げる
+    Reduced,
+    // ワイヤーだけを低い頻度で更新（腕の向き・風切り音は更新しない）
+    Minimal,
+    // 何も更新しない
+    Culled,
+};
+
+/**
+ * 各 VRPawn の重要度を視点からの距離・視野内か・自分の Pawn かで求め、
+ * 重要でない Pawn の見た目の更新（ワイヤーの Spline・腕の向き・風切り音）の頻度を下げる、または省略させる
+ */
+UCLASS(Config = Game)
+class VRTEMPLATE_API UWireSignificanceSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // 1体の Pawn が毎フレーム行う見た目の処理の数（ワイヤー・腕の向き・風切り音）
+    static constexpr int32 CosmeticUpdatesPerPawn = 3;
+
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    void RegisterPawn(AVRPawn* Pawn);
+    void UnregisterPawn(AVRPawn* Pawn);
+
+    // Pawn の見た目の更新で実際に行った処理の数を記録
+    void AddCosmeticUpdates(int32 NumUpdates) { NumCosmeticUpdates += NumUpdates; }
+
+    // 直前のフレームで省略できた見た目の処理の数
+    int32 GetLastSavedUpdates() const { return LastSavedUpdates; }
+
+    // 視点から見た Pawn の重要度（0～1）
+    float CalculateSignificance(const AVRPawn* Pawn, const FVector& ViewLocation, const FVector& ViewDirection) const;
+
+private:
+    // 自分の視点（ローカルプレイヤーがいなければ false）
+    bool GetViewPoint(FVector& OutLocation, FVector& OutDirection) const;
+
+    EWireCosmeticSignificance GetLevel(float Significance) const;
+
+    // 段階ごとの見た目の更新頻度 (Hz)。0 なら Pawn の設定のまま
+    float GetTickRate(EWireCosmeticSignificance Level) const;
+
+    TArray<TWeakObjectPtr<AVRPawn>> Pawns;
+
+    // このフレームに実際に行った見た目の処理の数
+    int32 NumCosmeticUpdates = 0;
+    int32 LastSavedUpdates = 0;
+
+    // この距離までは距離による重要度を下げない (cm)
+    UPROPERTY(Config)
+    float NearDistance = 1000.0f;
+
+    // この距離で距離による重要度が 0 になる (cm)
+    UPROPERTY(Config)
+    float FarDistance = 8000.0f;
+
+    // 視野とみなす視線からの角度（度）
+    UPROPERTY(Config)
+    float ViewHalfAngle = 60.0f;
+
+    // 視野外の Pawn の重要度に掛ける値
+    UPROPERTY(Config)
+    float OutOfViewScale = 0.3f;
+
+    // 重要度がこの値以上なら各段階にする（Full > Reduced > Minimal、それ未満は Culled）
+    UPROPERTY(Config)
+    float FullThreshold = 0.7f;
+    UPROPERTY(Config)
+    float ReducedThreshold = 0.35f;
+    UPROPERTY(Config)
+    float MinimalThreshold = 0.1f;
+
+    // Reduced・Minimal の見た目の更新頻度 (Hz)
+    UPROPERTY(Config)
+    float ReducedTickRate = 30.0f;
+    UPROPERTY(Config)
+    float MinimalTickRate = 10.0f;
+};
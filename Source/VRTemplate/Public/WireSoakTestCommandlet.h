@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "WireSoakTestCommandlet.generated.h"
+
+/**
+ * 専用サーバーとヘッドレスのクライアント N 台を同じマシンで起動し、長時間動かした結果をまとめる負荷試験
+ * 各プロセスは -WireSoak で起動し、UWireSoakTestSubsystem がボット入力と計測を行う
+ * 例: UnrealEditor-Cmd VRTemplate.uproject -run=WireSoakTest -unattended
+ *         -Map=/Game/S_Level/Course_City -Clients=16 -Duration=3600 -MaxTickP99=11 -MaxBytesPerClient=20000
+ *
+ * -Map                : サーバーで開くマップ（省略時は既定のサーバーマップ）
+ * -Clients            : 起動するクライアントの数
+ * -Duration           : 計測する時間（秒）
+ * -Port               : サーバーの待ち受けポート
+ * -ServerExe          : サーバーの実行ファイル（省略時はこのエディタを -server で起動する）
+ * -ClientExe          : クライアントの実行ファイル（省略時はこのエディタを -game -nullrhi で起動する）
+ * -Replay             : ボットの代わりに各クライアントで繰り返し再生する入力の記録（名前またはパス）
+ * -Report             : サーバーが書き出す Saved/Soak/<Report>.csv の名前
+ * -MaxTickP99         : サーバーの Tick の p99 (ms) がこの値を超えた間隔があれば失敗を返す（0 で判定なし）
+ * -MaxBytesPerClient  : 1クライアントへの送信量 (bytes/s) がこの値を超えた間隔があれば失敗を返す（0 で判定なし）
+ * -MaxMemoryGrowth    : 最初と最後の間隔の使用メモリの差 (MB) がこの値を超えたら失敗を返す（0 で判定なし）
+ */
+UCLASS()
+class VRTEMPLATE_API UWireSoakTestCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UWireSoakTestCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+
+private:
+    // 実行ファイルと引数を決めてプロセスを起動
+    FProcHandle LaunchProcess(const FString& ExePath, const FString& Args) const;
+
+    // サーバーが書き出した CSV のうち WarmupTime 以降を集計して閾値を判定
+    bool SummarizeReport(const FString& ReportPath, double WarmupTime, int32 NumClients, double MaxTickP99, double MaxBytesPerClient, double MaxMemoryGrowth) const;
+};
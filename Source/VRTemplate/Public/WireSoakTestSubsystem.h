@@ -0,0 +1,111 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WireInputRecording.h"
+#include "WireSoakTestSubsystem.generated.h"
+
+class AVRPawn;
+
+/**
+ * 負荷試験（-WireSoak で起動した時のみ作成）
+ * クライアントでは自分の Pawn をボット入力（または -SoakReplay の記録の繰り返し）で動かし、
+ * 専用サーバーではサーバーの Tick 時間・クライアントごとの帯域・補正の数・メモリを
+ * ReportInterval ごとに Saved/Soak/<Report>.csv へ書き出す
+ *
+ * -SoakDuration=秒      : この時間で終了する（0 なら終了しない）
+ * -SoakReport=名前      : 書き出す CSV の名前（サーバー）
+ * -SoakReplay=名前      : ボットの代わりに Wire.RecordInput で記録した入力を繰り返し再生する（クライアント）
+ * -SoakClientIndex=番号 : ボットの動きをずらすためのクライアントの番号
+ */
+UCLASS(Config = Game)
+class VRTEMPLATE_API UWireSoakTestSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // CSV の列（UWireSoakTestCommandlet が読み込む）
+    static const TCHAR* CsvHeader;
+
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    // Saved/Soak/<Name>.csv
+    static FString GetReportPath(const FString& Name);
+
+private:
+    // サーバー: 1フレーム分の計測と ReportInterval ごとの書き出し
+    void TickServer(float DeltaTime);
+    void WriteReport();
+
+    // クライアント: 自分の Pawn に入力を与える
+    void TickClient(float DeltaTime);
+    void ApplyBotInput(AVRPawn* Pawn, float DeltaTime);
+
+    // コースの次の目標地点（なければ Pawn の前方を回る）
+    FVector GetBotTarget(const AVRPawn* Pawn);
+
+    // このワールド（マップ）を読み込んでからの実時間（秒）。CSV の Time 列
+    double ElapsedTime = 0.0;
+    double Duration = 0.0;
+
+    /* サーバー */
+
+    // 書き出し先（最初の書き出しで作成する）
+    FString ReportName;
+    FString ReportPath;
+    double NextReportTime = 0.0;
+
+    // 書き出し間隔内のフレームごとのゲームスレッドの時間 (ms)
+    TArray<float> TickSamples;
+
+    // 前回書き出した時点の入力と補正の累計
+    uint64 LastMoves = 0;
+    uint64 LastCorrections = 0;
+
+    // 最初の書き出し時と最大の使用メモリ (MB)
+    double StartMemoryMB = 0.0;
+    double PeakMemoryMB = 0.0;
+
+    // 全体の Tick 時間の最大 (ms) と補正の累計
+    float PeakTickMs = 0.0f;
+    uint64 TotalMoves = 0;
+    uint64 TotalCorrections = 0;
+
+    /* クライアント */
+
+    int32 ClientIndex = 0;
+    float BotTime = 0.0f;
+
+    // 目標にしているコースの地点
+    TArray<FVector> Waypoints;
+    int32 WaypointIndex = 0;
+
+    // 繰り返し再生する入力（-SoakReplay 指定時のみ）
+    TUniquePtr<FWireInputRecording> Replay;
+    int32 ReplayFrame = 0;
+
+    // 計測を書き出す間隔（秒）
+    UPROPERTY(Config)
+    float ReportInterval = 10.0f;
+
+    // コースの地点に付けるタグ（名前順にたどる）
+    UPROPERTY(Config)
+    FName WaypointTag = TEXT("SoakWaypoint");
+
+    // この距離まで近づいたら次の地点へ (cm)
+    UPROPERTY(Config)
+    float WaypointRadius = 500.0f;
+
+    // 接続→巻き取り→切断を繰り返す周期（秒）
+    UPROPERTY(Config)
+    float BotCycleTime = 1.5f;
+
+    // 目標へ向ける時の照準の仰角（度）
+    UPROPERTY(Config)
+    float BotAimPitch = 35.0f;
+};
@@ -0,0 +1,209 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Templates/Function.h"
+
+// ワイヤーが角に巻き付いた点
+struct FWireWrapPoint
+{
+    // 巻き付き点のワールド座標（面から少し離した位置）
+    FVector Location = FVector::ZeroVector;
+
+    // 巻き付いた時の曲がる向き（これが反転したら巻き付きを解く）
+    FVector BendAxis = FVector::ZeroVector;
+};
+
+// 巻き付き判定用のトレース（Start から End の間に遮るものがあれば位置と法線を返す）
+using FWireWrapTraceFunction = TFunctionRef<bool(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal)>;
+
+// ワイヤー1本分の状態
+struct FWireTether
+{
+    // ワイヤーが接続されているか
+    bool bAttached = false;
+
+    // アンカーのワールド座標
+    FVector Anchor = FVector::ZeroVector;
+
+    // 現在のワイヤーの長さ
+    float CurrentLength = 0.0f;
+
+    // 接続時のワイヤーの長さ
+    float AttachLength = 0.0f;
+
+    // アンカー側から順に並べた巻き付き点
+    TArray<FWireWrapPoint, TInlineAllocator<4>> WrapPoints;
+
+    // アンカーから最後の巻き付き点までの長さ
+    float WrappedLength = 0.0f;
+
+    // 前回の巻き付き判定時の根元の位置
+    FVector LastOrigin = FVector::ZeroVector;
+
+    // 根元側の支点（最後の巻き付き点、なければアンカー）
+    const FVector& GetPivot() const { return WrapPoints.Num() > 0 ? WrapPoints.Last().Location : Anchor; }
+
+    // 支点から根元までに使えるワイヤーの長さ
+    float GetFreeLength() const { return FMath::Max(CurrentLength - WrappedLength, 0.0f); }
+};
+
+// ソルバーのパラメータ
+struct FWireSolverSettings
+{
+    // 使うワイヤーの本数（左右の手なら 2。FWireSolver::MaxTethers まで）
+    int32 NumTethers = 2;
+
+    // ワイヤーを XPBD の距離拘束として解く（false なら伸びに比例して引き寄せる従来の方式）
+    bool bUseXPBD = true;
+
+    // XPBD のコンプライアンス（剛性の逆数。0 で伸びない。1/PullStrength で従来と同じ強さになる）
+    float Compliance = 1.0f / 300.0f;
+
+    // 両手のワイヤーの拘束を交互に解く反復回数
+    int32 NumIterations = 2;
+
+    // 引き寄せ係数（ワイヤーの伸び 1cm あたりの加速度。bUseXPBD が false の時のみ使用）
+    float PullStrength = 300.0f;
+
+    // 重力加速度（下向き）
+    float Gravity = 0.0f;
+
+    // 空気抵抗係数
+    float AirResistance = 0.0f;
+
+    // 固定タイムステップ（72/90/120Hz のフレームをすべて割り切れる 1/360 秒を既定値とする）
+    float FixedTimeStep = 1.0f / 360.0f;
+
+    // 1回の Step で実行するサブステップ数の上限（超過分の時間は切り捨てる）
+    int32 MaxSubsteps = 32;
+
+    // 1本のワイヤーが巻き付ける点の上限（0 なら巻き付かない）
+    int32 MaxWrapPoints = 8;
+
+    // 巻き付き点を面から離す距離
+    float WrapOffset = 2.0f;
+
+    // 巻き付き位置を角に近づける二分探索の回数（1フレームのトレース数は最大 1 + この値。既定で 5 回）
+    int32 WrapRefineSteps = 4;
+};
+
+// Step の結果
+struct FWireSolverStepResult
+{
+    // このフレームで進んだ移動量
+    FVector Displacement = FVector::ZeroVector;
+
+    // 最後のサブステップでの引き寄せ加速度（サブステップが無ければ前回の Step の値）
+    FVector PullAcceleration = FVector::ZeroVector;
+
+    // 実行したサブステップ数
+    int32 NumSubsteps = 0;
+};
+
+/**
+ * ワイヤー機動の物理演算（UObject に依存しない）
+ * 速度とワイヤーの状態を保持し、固定タイムステップで決定的に更新する
+ */
+class VRTEMPLATE_API FWireSolver
+{
+public:
+    // 同時に扱えるワイヤーの本数の上限（状態はすべて固定長の配列に持ち、ヒープを使わない）
+    static constexpr int32 MaxTethers = 8;
+
+    FWireSolver() = default;
+    explicit FWireSolver(const FWireSolverSettings& InSettings);
+
+    void SetSettings(const FWireSolverSettings& InSettings);
+    const FWireSolverSettings& GetSettings() const { return Settings; }
+
+    int32 GetNumTethers() const { return Settings.NumTethers; }
+
+    FWireTether& GetTether(int32 Index) { return Tethers[Index]; }
+    const FWireTether& GetTether(int32 Index) const { return Tethers[Index]; }
+
+    // いずれかのワイヤーが接続されているか
+    bool IsAnyAttached() const;
+
+    const FVector& GetVelocity() const { return Velocity; }
+    void SetVelocity(const FVector& InVelocity) { Velocity = InVelocity; }
+
+    // ワイヤーを接続し、根元からアンカーまでの距離をワイヤー長とする
+    void Attach(int32 Index, const FVector& Anchor, const FVector& Origin);
+
+    // ワイヤーを切断
+    void Detach(int32 Index);
+
+    // ワイヤーの状態を直接設定（ネットワークの補正用。巻き付き長さは巻き付き点から計算し直す）
+    void SetTether(int32 Index, const FWireTether& InTether);
+
+    // 巻き付き点の追加・解除を判定（接続中のワイヤーの最後の区間だけをトレースする）
+    // 巻き付き点が変化したら true を返す
+    bool UpdateWrap(int32 Index, const FVector& Origin, FWireWrapTraceFunction Trace);
+
+    // 根元から巻き付き点を経由したアンカーまでの長さに DeltaLength を加えた長さにワイヤーを巻き取る・伸ばす
+    // 戻り値は接続時の長さに対する現在の長さの比
+    float ReelWire(int32 Index, const FVector& Origin, float DeltaLength, float MinLength, float MaxLength);
+
+    // DeltaTime 分だけ固定タイムステップでシミュレーションを進める
+    // Origins には各ワイヤーの根元（コントローラーなど）のワールド座標を渡す
+    FWireSolverStepResult Step(float DeltaTime, TArrayView<const FVector> Origins);
+
+    // DeltaTime を端数時間に加え、今回実行する固定タイムステップの回数を返す（上限を超えた分の時間は捨てる）
+    int32 ConsumeSubsteps(float DeltaTime);
+
+    // 固定タイムステップを NumSteps 回進める（Step を衝突判定の区切りごとに分けて実行する時に使う）
+    FWireSolverStepResult StepFixed(int32 NumSteps, TArrayView<const FVector> Origins);
+
+    // DeltaTime を固定タイムステップ以下に等分して進める
+    // 端数時間を持ち越さないので、同じ入力を再生すれば同じ結果になる（CharacterMovement のサブステップ内で使う）
+    FWireSolverStepResult StepSubdivided(float DeltaTime, TArrayView<const FVector> Origins);
+
+    // 端数時間の蓄積をリセット
+    void ResetAccumulator() { Accumulator = 0.0; }
+
+    // 端数時間（サーバーから補正された値に合わせる時に使う）
+    double GetAccumulator() const { return Accumulator; }
+    void SetAccumulator(double InAccumulator) { Accumulator = FMath::Max(InAccumulator, 0.0); }
+
+private:
+    // Step の間は変わらない接続中のワイヤーの状態を、サブステップでまとめて処理できるよう成分ごとの配列に詰めたもの
+    struct FTetherBatch
+    {
+        int32 Num = 0;
+
+        // 根元から支点までのベクトル（Step 開始時点）
+        FVector::FReal ToPivotX[MaxTethers];
+        FVector::FReal ToPivotY[MaxTethers];
+        FVector::FReal ToPivotZ[MaxTethers];
+
+        // 支点から根元までに使えるワイヤーの長さ
+        FVector::FReal FreeLength[MaxTethers];
+    };
+
+    // 接続中のワイヤーを Batch に詰める
+    void GatherBatch(TArrayView<const FVector> Origins);
+
+    // 1サブステップ分の更新。Offset は Step 開始時からの移動量。戻り値はワイヤーによる加速度
+    FVector Substep(float Dt, const FVector& Offset);
+
+    // 伸びに比例した引き寄せ（従来の方式）
+    FVector SubstepPenalty(float Dt, const FVector& Offset);
+
+    // 予測位置をワイヤーの距離拘束に投影し、位置の変化から速度を求める
+    FVector SubstepXPBD(float Dt, const FVector& Offset);
+
+    FWireSolverSettings Settings;
+
+    FTetherBatch Batch;
+
+    TStaticArray<FWireTether, MaxTethers> Tethers;
+
+    FVector Velocity = FVector::ZeroVector;
+
+    // 最後に実行したサブステップでの引き寄せ加速度
+    FVector LastPullAcceleration = FVector::ZeroVector;
+
+    // 次の Step に持ち越す端数時間
+    double Accumulator = 0.0;
+};
@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+class UWorld;
+
+// ワイヤー関連のログ
+VRTEMPLATE_API DECLARE_LOG_CATEGORY_EXTERN(LogWire, Log, All);
+
+// "stat Wire" で表示する統計
+DECLARE_STATS_GROUP(TEXT("Wire"), STATGROUP_Wire, STATCAT_Advanced);
+
+// VRPawn::Tick の各処理
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn Tick"), STAT_WireVRPawnTick, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn CheckConnectable"), STAT_WireVRPawnCheckConnectable, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn UpdateWireMovement"), STAT_WireVRPawnUpdateWireMovement, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn WireWrap"), STAT_WireVRPawnWireWrap, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn WireRender"), STAT_WireVRPawnWireRender, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn CollisionMove"), STAT_WireVRPawnCollisionMove, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn Cosmetic"), STAT_WireVRPawnCosmetic, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("VRPawn TrajectoryPreview"), STAT_WireVRPawnTrajectoryPreview, STATGROUP_Wire, VRTEMPLATE_API);
+
+// WireCharacter::Tick の各処理
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WireCharacter Tick"), STAT_WireCharacterTick, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WireCharacter CheckConnectable"), STAT_WireCharacterCheckConnectable, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WireCharacter UpdateWireMovement"), STAT_WireCharacterUpdateWireMovement, STATGROUP_Wire, VRTEMPLATE_API);
+
+// 接続先の索引
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AnchorIndex Query"), STAT_WireAnchorIndexQuery, STATGROUP_Wire, VRTEMPLATE_API);
+
+// ワイヤーのまとめ描画
+DECLARE_CYCLE_STAT_EXTERN(TEXT("WireBatch Flush"), STAT_WireBatchFlush, STATGROUP_Wire, VRTEMPLATE_API);
+
+// 見た目の更新の重要度
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance Update"), STAT_WireSignificanceUpdate, STATGROUP_Wire, VRTEMPLATE_API);
+
+// 軌道の先読みによるストリーミング
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Streaming Prediction"), STAT_WireStreamingPrediction, STATGROUP_Wire, VRTEMPLATE_API);
+
+// ワイヤーの見た目用ロープ
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Rope Simulate"), STAT_WireRopeSimulate, STATGROUP_Wire, VRTEMPLATE_API);
+
+// 1フレームあたりの回数・量
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces Issued"), STAT_WireTracesIssued, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Aim Cache Hits"), STAT_WireAimCacheHits, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Attaches"), STAT_WireAttaches, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Rope Particles"), STAT_WireRopeParticles, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Wrap Points"), STAT_WireWrapPoints, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Collision Substeps"), STAT_WireCollisionSubsteps, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Collision Sweeps"), STAT_WireCollisionSweeps, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("VRPawn Corrections"), STAT_WireVRPawnCorrections, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("VRPawn Saved Moves"), STAT_WireVRPawnSavedMoves, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significant Pawns"), STAT_WireSignificantPawns, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Cosmetic Updates Saved"), STAT_WireCosmeticUpdatesSaved, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("WireBatch Pushes"), STAT_WireBatchPushes, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("WireBatch Wires"), STAT_WireBatchedWires, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Streaming Shapes"), STAT_WireStreamingShapes, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Attaches Per Second"), STAT_WireAttachesPerSecond, STATGROUP_Wire, VRTEMPLATE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Pull Magnitude"), STAT_WirePullMagnitude, STATGROUP_Wire, VRTEMPLATE_API);
+
+// "-csvprofile" で記録するカテゴリ
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(VRTEMPLATE_API, Wire);
+
+// Unreal Insights のトレースチャンネル（"-trace=cpu,Wire" で有効化）
+UE_TRACE_CHANNEL_EXTERN(WireChannel, VRTEMPLATE_API);
+
+// stat・CSV・Insights をまとめて計測する
+#define WIRE_SCOPE_CYCLE_COUNTER(Stat, Name) \
+    SCOPE_CYCLE_COUNTER(Stat); \
+    CSV_SCOPED_TIMING_STAT(Wire, Name); \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Wire_##Name, WireChannel)
+
+// トレースを1回発行したことを記録
+#define WIRE_COUNT_TRACE() \
+    INC_DWORD_STAT(STAT_WireTracesIssued); \
+    CSV_CUSTOM_STAT(Wire, TracesIssued, 1, ECsvCustomStatOp::Accumulate)
+
+namespace WireStats
+{
+    // ワイヤーの接続を記録（毎秒の接続回数はワールドの UWireStatsSubsystem で集計する）
+    VRTEMPLATE_API void RecordAttach(const UWorld* World);
+
+    // World の直近1秒間の接続回数を統計に反映
+    VRTEMPLATE_API void UpdateAttachRate(const UWorld* World);
+
+    // 引き寄せ加速度の大きさを統計に反映
+    VRTEMPLATE_API void RecordPullMagnitude(float Magnitude);
+}
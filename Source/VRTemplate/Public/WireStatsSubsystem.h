@@ -0,0 +1,28 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WireStatsSubsystem.generated.h"
+
+/**
+ * ワールドごとに直近のワイヤーの接続時刻を持ち、毎秒の接続回数を統計に反映する
+ * ワールドと一緒に作り直されるので、マップの切り替えや PIE の再起動で前の記録が残らない
+ */
+UCLASS()
+class VRTEMPLATE_API UWireStatsSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+    // ワイヤーの接続を記録
+    void RecordAttach(double Time);
+
+    // 直近1秒間の接続回数を統計に反映
+    void UpdateAttachRate(double Time);
+
+private:
+    // 直近の接続時刻（ゲームスレッドからのみ使用）
+    TArray<double> RecentAttachTimes;
+};
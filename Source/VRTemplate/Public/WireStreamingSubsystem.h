@@ -0,0 +1,98 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldPartition/WorldPartitionStreamingSource.h"
+#include "WireSolver.h"
+#include "WireStreamingSubsystem.generated.h"
+
+class APawn;
+
+/**
+ * ワイヤーで高速に移動しているローカルプレイヤーの軌道を数秒先まで先読みし、
+ * World Partition のストリーミングソースとして進路上とアンカー周辺のセルを先に読み込ませる
+ *
+ * 全体の読み込み範囲は広げず、進路に沿った小さな球だけを追加する
+ *   近い先（NearTime 秒以内）の進路 : 優先度 Highest で読み込みと有効化
+ *   遠い先の進路                    : 優先度 High で読み込みのみ
+ *   接続中のアンカー                : 優先度 High で読み込みと有効化
+ * 背後のセルは PlayerController の通常のソース（優先度 Normal）だけが残るので後回しになる
+ */
+UCLASS(Config = Game)
+class VRTEMPLATE_API UWireStreamingSubsystem : public UTickableWorldSubsystem, public IWorldPartitionStreamingSourceProvider
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    //~ IWorldPartitionStreamingSourceProvider
+    virtual bool GetStreamingSources(TArray<FWorldPartitionStreamingSource>& OutStreamingSources) const override;
+    virtual UObject* GetStreamingSourceOwner() override { return this; }
+
+private:
+    // 先読みする点の上限
+    static constexpr int32 MaxSamples = 16;
+
+    // 1人分の先読みの結果
+    struct FPrediction
+    {
+        FVector Location = FVector::ZeroVector;
+        float Speed = 0.0f;
+
+        // SampleInterval ごとの予測位置
+        FVector Points[MaxSamples];
+        int32 NumPoints = 0;
+
+        // 接続中のアンカー
+        FVector Anchors[FWireSolver::MaxTethers];
+        int32 NumAnchors = 0;
+    };
+
+    // Pawn のワイヤーの状態から軌道を先読みする（ワイヤー機動の Pawn でなければ false）
+    bool Predict(const APawn* Pawn, FPrediction& OutPrediction) const;
+
+    // 先読みの結果（ローカルプレイヤーごと）
+    TArray<FPrediction> Predictions;
+
+    // 次の先読みまでの時間
+    float TimeUntilPrediction = 0.0f;
+
+    bool bRegistered = false;
+
+    // 先読みし直す間隔（秒）
+    UPROPERTY(Config)
+    float PredictionInterval = 0.25f;
+
+    // 先読みする時間（秒）
+    UPROPERTY(Config)
+    float LookaheadTime = 3.0f;
+
+    // 予測位置を置く間隔（秒）
+    UPROPERTY(Config)
+    float SampleInterval = 0.2f;
+
+    // 先読み用のワイヤー演算の周波数 (Hz)。XPBD なので低くても発散しない
+    UPROPERTY(Config)
+    float PredictionRate = 30.0f;
+
+    // この時間以内の進路は優先度を最も高くして有効化まで行う（秒）
+    UPROPERTY(Config)
+    float NearTime = 1.0f;
+
+    // この速さ未満なら先読みしない (cm/s)。歩く速さでは通常のソースで足りる
+    UPROPERTY(Config)
+    float MinSpeed = 1500.0f;
+
+    // 進路上の点の周りに読み込む半径 (cm)
+    UPROPERTY(Config)
+    float PathRadius = 3000.0f;
+
+    // アンカーの周りに読み込む半径 (cm)
+    UPROPERTY(Config)
+    float AnchorRadius = 2000.0f;
+};
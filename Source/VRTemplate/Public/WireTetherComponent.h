@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WireSolver.h"
+#include "WireTetherComponent.generated.h"
+
+/**
+ * 任意の本数のワイヤーでアクタを吊る・引き寄せる汎用コンポーネント（複数のフックを持つギミックなど）
+ * ワイヤーの状態は FWireSolver の固定長の配列に持ち、接続中のワイヤーをまとめて演算するので Tick でヒープを使わない
+ * AVRPawn・AWireCharacter のように移動を別で行う場合は bAutoMove を false にして GetSolver() で演算だけを使う
+ */
+UCLASS(ClassGroup = Wire, meta = (BlueprintSpawnableComponent))
+class VRTEMPLATE_API UWireTetherComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UWireTetherComponent();
+
+    virtual void BeginPlay() override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    // ワイヤーを接続（根元からアンカーまでの距離をワイヤー長とする）
+    UFUNCTION(BlueprintCallable, Category = "Wire Tether")
+    void AttachTether(int32 Index, const FVector& Anchor);
+
+    UFUNCTION(BlueprintCallable, Category = "Wire Tether")
+    void DetachTether(int32 Index);
+
+    // ワイヤーを巻き取る（負）・伸ばす（正）
+    UFUNCTION(BlueprintCallable, Category = "Wire Tether")
+    void ReelTether(int32 Index, float DeltaLength);
+
+    UFUNCTION(BlueprintPure, Category = "Wire Tether")
+    bool IsTetherAttached(int32 Index) const;
+
+    // ワイヤーの根元のワールド座標
+    UFUNCTION(BlueprintPure, Category = "Wire Tether")
+    FVector GetTetherOrigin(int32 Index) const;
+
+    UFUNCTION(BlueprintPure, Category = "Wire Tether")
+    FVector GetVelocity() const { return Solver.GetVelocity(); }
+
+    UFUNCTION(BlueprintCallable, Category = "Wire Tether")
+    void SetVelocity(const FVector& InVelocity) { Solver.SetVelocity(InVelocity); }
+
+    // 自動で動かすかを切り替える（Tick の有効・無効も合わせる）
+    UFUNCTION(BlueprintCallable, Category = "Wire Tether")
+    void SetAutoMove(bool bInAutoMove);
+
+    // 設定をソルバーに反映
+    void ApplySolverSettings();
+
+    FWireSolver& GetSolver() { return Solver; }
+    const FWireSolver& GetSolver() const { return Solver; }
+
+    // ワイヤーの本数（FWireSolver::MaxTethers まで）
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "1", ClampMax = "8"))
+    int32 NumTethers = 2;
+
+    // 各ワイヤーの根元（アクタのローカル座標。足りない分は原点）
+    UPROPERTY(EditAnywhere, Category = "Wire Tether")
+    TArray<FVector> OriginOffsets;
+
+    // ワイヤーを XPBD の距離拘束として解く（false なら伸びに比例して引き寄せる）
+    UPROPERTY(EditAnywhere, Category = "Wire Tether")
+    bool bUseXPBD = true;
+
+    // ワイヤーの柔らかさ（0 で伸びない）
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "0", EditCondition = "bUseXPBD"))
+    float Compliance = 1.0f / 300.0f;
+
+    // 引き寄せ係数（ワイヤーの伸び 1cm あたりの加速度）
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "0", EditCondition = "!bUseXPBD"))
+    float PullStrength = 300.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Wire Tether")
+    float Gravity = 980.0f;
+
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "0"))
+    float AirResistance = 0.1f;
+
+    // ワイヤー演算の周波数 (Hz)
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "30"))
+    float SimulationRate = 120.0f;
+
+    // 1本のワイヤーが角に巻き付ける点の上限（0 なら巻き付かない）
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "0"))
+    int32 MaxWrapPoints = 8;
+
+    // ワイヤーの長さの範囲
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "0"))
+    float MinLength = 50.0f;
+    UPROPERTY(EditAnywhere, Category = "Wire Tether", meta = (ClampMin = "0"))
+    float MaxLength = 5000.0f;
+
+    // 演算結果でルートコンポーネントを衝突付きで動かす（false なら演算も行わない。実行中は SetAutoMove で切り替える）
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wire Tether")
+    bool bAutoMove = true;
+
+private:
+    FWireSolver Solver;
+};
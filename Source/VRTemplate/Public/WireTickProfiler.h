@@ -0,0 +1,83 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+// シッピングビルドでは計測処理ごと取り除く
+#ifndef WITH_WIRE_TICK_PROFILER
+#define WITH_WIRE_TICK_PROFILER !UE_BUILD_SHIPPING
+#endif
+
+// 計測対象の処理
+enum class EWireTickPhase : uint8
+{
+    Tick,
+    CheckConnectable,
+    UpdateWireMovement,
+    CollisionMove,
+    TrajectoryPreview,
+    Cosmetic,
+    Num
+};
+
+/**
+ * VRPawn の Tick 内の処理時間を記録する（ベンチマーク実行中のみ有効）
+ */
+class VRTEMPLATE_API FWireTickProfiler
+{
+public:
+    // 現在有効なプロファイラ（無効時は nullptr）
+    static FWireTickProfiler* Get() { return Active; }
+    static void SetActive(FWireTickProfiler* Profiler) { Active = Profiler; }
+
+    static const TCHAR* GetPhaseName(EWireTickPhase Phase);
+
+    // 計測結果の保存領域を確保
+    void Reserve(int32 NumSamplesPerPhase);
+
+    void AddSample(EWireTickPhase Phase, uint64 Cycles) { Samples[(int32)Phase].Add(Cycles); }
+
+    void Reset();
+
+    int32 GetNumSamples(EWireTickPhase Phase) const { return Samples[(int32)Phase].Num(); }
+
+    // 指定パーセンタイル（0～1）の処理時間 (us)
+    double GetPercentileMicroseconds(EWireTickPhase Phase, double Percentile) const;
+
+    // 平均処理時間 (us)
+    double GetMeanMicroseconds(EWireTickPhase Phase) const;
+
+private:
+    TArray<uint64> Samples[(int32)EWireTickPhase::Num];
+
+    static FWireTickProfiler* Active;
+};
+
+// スコープ内の処理時間を有効なプロファイラに記録する
+class FWireTickProfilerScope
+{
+public:
+    explicit FWireTickProfilerScope(EWireTickPhase InPhase)
+        : Profiler(FWireTickProfiler::Get())
+        , Phase(InPhase)
+        , StartCycles(Profiler ? FPlatformTime::Cycles64() : 0)
+    {
+    }
+
+    ~FWireTickProfilerScope()
+    {
+        if (Profiler)
+            Profiler->AddSample(Phase, FPlatformTime::Cycles64() - StartCycles);
+    }
+
+private:
+    FWireTickProfiler* Profiler;
+    EWireTickPhase Phase;
+    uint64 StartCycles;
+};
+
+#if WITH_WIRE_TICK_PROFILER
+#define WIRE_TICK_PROFILER_SCOPE(Phase) FWireTickProfilerScope PREPROCESSOR_JOIN(WireTickProfilerScope, __LINE__)(EWireTickPhase::Phase)
+#else
+#define WIRE_TICK_PROFILER_SCOPE(Phase)
+#endif
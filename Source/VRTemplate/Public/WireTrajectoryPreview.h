@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "WireSolver.h"
+#include "WireTrajectoryPreview.generated.h"
+
+// スイングの軌道予測の設定
+USTRUCT(BlueprintType)
+struct FWireTrajectoryPreviewSettings
+{
+    GENERATED_BODY()
+
+    // 予測する時間（秒）
+    UPROPERTY(EditAnywhere, Category = "Trajectory Preview", meta = (ClampMin = "0.1", ClampMax = "10"))
+    float PreviewTime = 2.5f;
+
+    // 1秒あたりの積分回数（1回の中はソルバーの固定タイムステップで等分して演算する）
+    UPROPERTY(EditAnywhere, Category = "Trajectory Preview", meta = (ClampMin = "10", ClampMax = "360"))
+    float StepsPerSecond = 90.0f;
+
+    // 衝突判定のレイを飛ばす間隔（積分回数）。この間隔で線の頂点を置く
+    UPROPERTY(EditAnywhere, Category = "Trajectory Preview", meta = (ClampMin = "1", ClampMax = "32"))
+    int32 ProbeInterval = 6;
+
+    // 1フレームの処理時間の予算 (us)。超えた分は次のフレームへ持ち越す
+    UPROPERTY(EditAnywhere, Category = "Trajectory Preview", meta = (ClampMin = "1"))
+    float BudgetMicroseconds = 150.0f;
+
+    // 線の太さと色
+    UPROPERTY(EditAnywhere, Category = "Trajectory Preview", meta = (ClampMin = "0"))
+    float LineThickness = 1.0f;
+    UPROPERTY(EditAnywhere, Category = "Trajectory Preview")
+    FLinearColor LineColor = FLinearColor(0.2f, 0.8f, 1.0f);
+};
+
+// 予測中の衝突判定（Start から End の間に遮るものがあれば位置を返す）
+using FWireTrajectoryProbeFunction = TFunctionRef<bool(const FVector& Start, const FVector& End, FVector& OutLocation)>;
+
+/**
+ * 照準先にワイヤーを接続した場合の軌道を、Pawn と同じソルバーで数秒先まで予測する
+ * 予測は数フレームに分けて予算内で進め、完了した結果だけを表示用に残す（実行中にメモリを確保しない）
+ */
+class VRTEMPLATE_API FWireTrajectoryPreview
+{
+public:
+    // 予測結果の頂点数の上限
+    static constexpr int32 MaxPoints = 64;
+
+    void SetSettings(const FWireTrajectoryPreviewSettings& InSettings);
+    const FWireTrajectoryPreviewSettings& GetSettings() const { return Settings; }
+
+    // 現在の状態から Index のワイヤーを Anchor に接続したとして予測をやり直す
+    // Origins は各ワイヤーの根元のワールド座標（予測中は Location との差を保って動かす）
+    void Begin(const FWireSolver& InSolver, int32 Index, const FVector& Anchor,
+        const FVector& InLocation, const FVector& InVelocity, TArrayView<const FVector> Origins);
+
+    // 予算内で予測を進める。予測が完了して結果が更新されたら true を返す
+    bool Advance(FWireTrajectoryProbeFunction Probe);
+
+    // 予測を中断して結果を破棄
+    void Reset();
+
+    bool IsRunning() const { return bRunning; }
+
+    // 予測を始めた時の照準先
+    int32 GetTargetIndex() const { return TargetIndex; }
+    const FVector& GetTargetAnchor() const { return TargetAnchor; }
+
+    // 直近に完了した予測の軌道（頂点が2つ未満なら結果なし）
+    TArrayView<const FVector> GetResult() const { return MakeArrayView(ResultPoints, NumResultPoints); }
+
+    // 直近の Advance の処理時間 (us)
+    double GetLastAdvanceMicroseconds() const { return LastAdvanceMicroseconds; }
+
+private:
+    // ProbeInterval 回まとめて積分し、進んだ区間に衝突判定を1回行う
+    void AdvanceSegment(FWireTrajectoryProbeFunction Probe);
+
+    FWireTrajectoryPreviewSettings Settings;
+
+    // 予測用に複製したソルバー
+    FWireSolver Solver;
+
+    FVector Location = FVector::ZeroVector;
+    FVector OriginOffset[FWireSolver::MaxTethers];
+
+    // 残りの区間数
+    int32 RemainingSegments = 0;
+
+    // 予測中の軌道
+    FVector Points[MaxPoints];
+    int32 NumPoints = 0;
+
+    // 表示用の完了した軌道
+    FVector ResultPoints[MaxPoints];
+    int32 NumResultPoints = 0;
+
+    int32 TargetIndex = INDEX_NONE;
+    FVector TargetAnchor = FVector::ZeroVector;
+
+    bool bRunning = false;
+    double LastAdvanceMicroseconds = 0.0;
+};
@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Tickable.h"
+#include "Engine/StreamableManager.h"
+#include "WireWarmupSubsystem.generated.h"
+
+class UMaterialInterface;
+class UWireBatchComponent;
+
+/**
+ * 起動後に LoginMap を開いた時に、ワイヤーとコースのマテリアルの PSO を先に作っておく
+ *
+ * ワイヤーの状態（Custom Primitive Data の 0 接続中 / 1 接続可能 / 2 接続不可）はシェーダーの組み合わせを増やさないが、
+ * マテリアルと頂点ファクトリ（Spline Mesh・まとめ描画の動的メッシュ・Static Mesh）の組み合わせごとの PSO は初めて描画した時に作られる
+ * そこで各マテリアルを読み込んでコンポーネントを登録し（PSO のプリキャッシュ）、視点の前に小さく数フレーム描画してから、
+ * プリキャッシュが終わるまで待つ。かかった時間はログに出す
+ */
+UCLASS(Config = Game)
+class VRTEMPLATE_API UWireWarmupSubsystem : public UGameInstanceSubsystem, public FTickableGameObject
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    //~ FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+    virtual bool IsTickable() const override { return State == EWarmupState::Rendering || State == EWarmupState::Compiling; }
+    virtual TStatId GetStatId() const override;
+
+    // ウォームアップが終わったか（LoginMap の UI で開始を待つ時に使う）
+    UFUNCTION(BlueprintPure, Category = "Warmup")
+    bool IsWarmupComplete() const { return State == EWarmupState::Done; }
+
+    // ウォームアップにかかった時間（秒）
+    UFUNCTION(BlueprintPure, Category = "Warmup")
+    float GetWarmupSeconds() const { return (float)WarmupSeconds; }
+
+    // ウォームアップが終わった時に呼ばれる
+    FSimpleMulticastDelegate OnWarmupComplete;
+
+private:
+    enum class EWarmupState : uint8
+    {
+        Idle,
+        // マテリアルを読み込み中
+        Loading,
+        // 視点の前に描画中
+        Rendering,
+        // PSO のプリキャッシュの完了待ち
+        Compiling,
+        Done,
+    };
+
+    void OnPostLoadMap(UWorld* World);
+    void OnAssetsLoaded();
+
+    // ワイヤーの各状態とコースのマテリアルを描画するコンポーネントを視点の前に並べる
+    void SpawnWarmupPrimitives(UWorld* World);
+
+    void Finish();
+
+    EWarmupState State = EWarmupState::Idle;
+
+    TWeakObjectPtr<UWorld> WarmupWorld;
+
+    FStreamableManager StreamableManager;
+    TSharedPtr<FStreamableHandle> LoadHandle;
+
+    // 描画用に置いたアクタ
+    TWeakObjectPtr<AActor> WarmupActor;
+
+    // まとめ描画に追加したワイヤー
+    TWeakObjectPtr<UWireBatchComponent> WireBatch;
+    TArray<int32> WireBatchHandles;
+
+    int32 NumMaterials = 0;
+    int32 FramesRendered = 0;
+    double StartTime = 0.0;
+    double LoadSeconds = 0.0;
+    double WarmupSeconds = 0.0;
+
+    FDelegateHandle PostLoadMapHandle;
+
+    // ウォームアップを行うマップ
+    UPROPERTY(Config)
+    FString WarmupMap = TEXT("LoginMap");
+
+    // ワイヤーのマテリアル（各状態で描画する）
+    UPROPERTY(Config)
+    TArray<FSoftObjectPath> WireMaterials;
+
+    // コースのマテリアル
+    UPROPERTY(Config)
+    TArray<FSoftObjectPath> CourseMaterials;
+
+    // ワイヤーの Spline Mesh に使うメッシュ
+    UPROPERTY(Config)
+    FSoftObjectPath WireMesh;
+
+    // コースのマテリアルを貼るメッシュ
+    UPROPERTY(Config)
+    FSoftObjectPath CourseMesh;
+
+    // 描画し続けるフレーム数
+    UPROPERTY(Config)
+    int32 WarmupFrames = 3;
+
+    // プリキャッシュの完了を待つ時間の上限（秒）
+    UPROPERTY(Config)
+    float MaxWarmupTime = 10.0f;
+};
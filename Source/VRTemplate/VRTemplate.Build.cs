@@ -19,7 +19,12 @@ public class VRTemplate : ModuleRules
             "HeadMountedDisplay"
         });
 
-        PrivateDependencyModuleNames.AddRange(new string[] {  });
+        PrivateDependencyModuleNames.AddRange(new string[] {
+            "RenderCore",
+            "RHI",
+            "Chaos",
+            "PhysicsCore"
+        });
 
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });